@@ -1263,32 +1263,41 @@ bool CApplication::LoadSkin(const std::string& skinID)
   CServiceBroker::GetWinSystem()->GetGfxContext().SetMediaDir(skin->Path());
   g_directoryCache.ClearSubPaths(skin->Path());
 
+  // independent of what follows, have the texture bundles opened and the first windows
+  // parsed in the background meanwhile
+  CServiceBroker::GetGUI()->GetTextureManager().PreloadBundles();
+  CServiceBroker::GetGUI()->GetWindowManager().PreloadWindows({WINDOW_HOME, skin->GetFirstWindow()});
+
+  int64_t start = CurrentHostCounter();
+  const int64_t freq = CurrentHostFrequency();
+  auto logPhase = [&start, freq](const char* phase)
+  {
+    const int64_t end = CurrentHostCounter();
+    CLog::Log(LOGDEBUG, "Load skin, %s: %.2fms", phase, 1000.f * (end - start) / freq);
+    start = end;
+  };
+
   const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
   CServiceBroker::GetGUI()->GetColorManager().Load(settings->GetString(CSettings::SETTING_LOOKANDFEEL_SKINCOLORS));
 
   g_SkinInfo->LoadIncludes();
+  logPhase("includes");
 
   g_fontManager.LoadFonts(settings->GetString(CSettings::SETTING_LOOKANDFEEL_FONT));
+  logPhase("fonts");
 
   // load in the skin strings
   std::string langPath = URIUtils::AddFileToFolder(skin->Path(), "language");
   URIUtils::AddSlashAtEnd(langPath);
 
   g_localizeStrings.LoadSkinStrings(langPath, settings->GetString(CSettings::SETTING_LOCALE_LANGUAGE));
-
-
-  int64_t start;
-  start = CurrentHostCounter();
+  logPhase("strings");
 
   CLog::Log(LOGINFO, "  load new skin...");
 
   // Load custom windows
   LoadCustomWindows();
-
-  int64_t end, freq;
-  end = CurrentHostCounter();
-  freq = CurrentHostFrequency();
-  CLog::Log(LOGDEBUG,"Load Skin XML: %.2fms", 1000.f * (end - start) / freq);
+  logPhase("custom windows");
 
   CLog::Log(LOGINFO, "  initialize new skin...");
   CServiceBroker::GetGUI()->GetWindowManager().AddMsgTarget(this);
@@ -1304,6 +1313,7 @@ bool CApplication::LoadSkin(const std::string& skinID)
 
   if (g_SkinInfo->HasSkinFile("DialogFullScreenInfo.xml"))
     CServiceBroker::GetGUI()->GetWindowManager().Add(new CGUIDialogFullScreenInfo);
+  logPhase("window init");
 
   CLog::Log(LOGINFO, "  skin loaded...");
 
@@ -1543,7 +1553,7 @@ void CApplication::Render()
   // fresh for the next process(), or after a windowclose animation (where process()
   // isn't called)
   CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
-  infoMgr.ResetCache();
+  infoMgr.ResetCache(INFO::INFO_SOURCE_FRAME);
   infoMgr.GetInfoProviders().GetGUIControlsInfoProvider().ResetContainerMovingCache();
 
   if (hasRendered)
@@ -0,0 +1,143 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FingerprintDatabase.h"
+
+#include "FileItem.h"
+#include "dbwrappers/dataset.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <cinttypes>
+
+CFingerprintDatabase::CFingerprintDatabase() = default;
+
+CFingerprintDatabase::~CFingerprintDatabase() = default;
+
+bool CFingerprintDatabase::Open()
+{
+  return CDatabase::Open();
+}
+
+void CFingerprintDatabase::CreateTables()
+{
+  CLog::Log(LOGINFO, "create fingerprint table");
+  m_pDS->exec("CREATE TABLE fingerprint (idFingerprint integer primary key, strContent text, strPath text, strFile text, strFingerprint text)");
+}
+
+void CFingerprintDatabase::CreateAnalytics()
+{
+  CLog::Log(LOGINFO, "%s - creating indices", __FUNCTION__);
+  m_pDS->exec("CREATE INDEX idxFingerprint ON fingerprint(strContent, strPath)");
+}
+
+void CFingerprintDatabase::UpdateTables(int version)
+{
+  if (version < 2)
+  {
+    // the fingerprints didn't tell which scanner took them, those of a folder scanned
+    // for music and for videos replaced each other. They are taken anew on the next scan.
+    m_pDS->exec("DROP TABLE fingerprint");
+    CreateTables();
+  }
+}
+
+std::string CFingerprintDatabase::GetFingerprint(const CFileItem& item)
+{
+  if (item.m_bIsFolder || item.m_dwSize <= 0 || !item.m_dateTime.IsValid())
+    return "";
+
+  return StringUtils::Format("%" PRId64 "-%s", item.m_dwSize, item.m_dateTime.GetAsDBDateTime().c_str());
+}
+
+bool CFingerprintDatabase::GetFingerprints(const std::string& strContent, const std::string& strPath, Fingerprints& fingerprints)
+{
+  fingerprints.clear();
+  std::string path(strPath);
+  URIUtils::AddSlashAtEnd(path);
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    std::string sql = PrepareSQL("SELECT strFile, strFingerprint FROM fingerprint WHERE strContent='%s' AND strPath='%s'",
+                                 strContent.c_str(), path.c_str());
+    if (!m_pDS->query(sql))
+      return false;
+    while (!m_pDS->eof())
+    {
+      fingerprints.insert(std::make_pair(m_pDS->fv(0).get_asString(), m_pDS->fv(1).get_asString()));
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, path.c_str());
+  }
+  return false;
+}
+
+bool CFingerprintDatabase::SetFingerprints(const std::string& strContent, const std::string& strPath, const Fingerprints& fingerprints)
+{
+  std::string path(strPath);
+  URIUtils::AddSlashAtEnd(path);
+  try
+  {
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    BeginTransaction();
+    m_pDS->exec(PrepareSQL("DELETE FROM fingerprint WHERE strContent='%s' AND strPath='%s'", strContent.c_str(), path.c_str()));
+    for (const auto& fingerprint : fingerprints)
+    {
+      m_pDS->exec(PrepareSQL("INSERT INTO fingerprint (idFingerprint, strContent, strPath, strFile, strFingerprint) VALUES (NULL, '%s', '%s', '%s', '%s')",
+                             strContent.c_str(), path.c_str(), fingerprint.first.c_str(), fingerprint.second.c_str()));
+    }
+    return CommitTransaction();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, path.c_str());
+    RollbackTransaction();
+  }
+  return false;
+}
+
+bool CFingerprintDatabase::RemoveFingerprints(const std::string& strContent, const std::string& strPath)
+{
+  std::string path(strPath);
+  URIUtils::AddSlashAtEnd(path);
+  return ExecuteQuery(PrepareSQL("DELETE FROM fingerprint WHERE strContent='%s' AND SUBSTR(strPath,1,%i)='%s'",
+                                 strContent.c_str(), StringUtils::utf8_strlen(path.c_str()), path.c_str()));
+}
+
+void CFingerprintDatabase::GetChangedFiles(const CFileItemList& items, const Fingerprints& fingerprints,
+                                           CFileItemList& changed, CFileItemList& unchanged)
+{
+  changed.SetPath(items.GetPath());
+  unchanged.SetPath(items.GetPath());
+  for (const auto& item : items)
+  {
+    if (item->m_bIsFolder)
+      continue;
+
+    const std::string fingerprint = GetFingerprint(*item);
+    const auto it = fingerprints.find(item->GetPath());
+    if (!fingerprint.empty() && it != fingerprints.end() && it->second == fingerprint)
+      unchanged.Add(item);
+    else
+      changed.Add(item);
+  }
+}
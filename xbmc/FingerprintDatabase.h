@@ -0,0 +1,70 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "dbwrappers/Database.h"
+
+#include <map>
+#include <string>
+
+class CFileItem;
+class CFileItemList;
+
+/*!
+ \brief Fingerprints of the files the music scanner has added
+
+ A fingerprint is taken from the directory listing, so checking whether a
+ file changed since it was scanned costs no access to the file itself. The
+ scanner only reads the tags of files whose fingerprint changed when the
+ hash of a directory tells it something in it changed.
+ */
+class CFingerprintDatabase : public CDatabase
+{
+public:
+  //! fingerprints of the files of a directory, by path of the file
+  typedef std::map<std::string, std::string> Fingerprints;
+
+  CFingerprintDatabase();
+  ~CFingerprintDatabase() override;
+  bool Open() override;
+
+  /*!
+   \brief Fingerprint of a file from its listing, its size and modification time
+   \return empty if the listing doesn't tell both, the file counts as changed
+   */
+  static std::string GetFingerprint(const CFileItem& item);
+
+  /*!
+   \brief Get the fingerprints of the files of a directory
+   \param strContent content the files were scanned for, like "music". Each
+          scanner keeps its own fingerprints of a directory.
+   \param strPath the directory
+   */
+  bool GetFingerprints(const std::string& strContent, const std::string& strPath, Fingerprints& fingerprints);
+  //! replaces the fingerprints of the directory
+  bool SetFingerprints(const std::string& strContent, const std::string& strPath, const Fingerprints& fingerprints);
+  //! removes the fingerprints of the directory and its subdirectories
+  bool RemoveFingerprints(const std::string& strContent, const std::string& strPath);
+
+  /*!
+   \brief Split the files of a listing by whether their fingerprint changed
+   \param items listing of the directory, its folders are left out
+   \param changed files without a fingerprint or with a changed one
+   \param unchanged files with the same fingerprint as stored
+   */
+  static void GetChangedFiles(const CFileItemList& items, const Fingerprints& fingerprints,
+                              CFileItemList& changed, CFileItemList& unchanged);
+
+protected:
+  void CreateTables() override;
+  void CreateAnalytics() override;
+  void UpdateTables(int version) override;
+  int GetSchemaVersion() const override { return 2; }
+  const char *GetBaseDBName() const override { return "Fingerprints"; }
+};
@@ -934,6 +934,70 @@ const infomap player_times[] =   {{ "seektime",         PLAYER_SEEKTIME },
 ///     @skinning_v17 **[New Infolabel]** \link Player_Process_audiobitspersample `Player.Process(audiobitspersample)`\endlink
 ///     <p>
 ///   }
+///   \table_row3{   <b>`Player.Process(audioresampletime)`</b>,
+///                  \anchor Player_Process_audioresampletime
+///                  _string_,
+///     @return Median / 99th percentile / maximum time in ms the audio engine spent resampling and converting a period of the playing streams.
+///     <p><hr>
+///     @skinning_v19 **[New Infolabel]** \link Player_Process_audioresampletime `Player.Process(audioresampletime)`\endlink
+///     <p>
+///   }
+///   \table_row3{   <b>`Player.Process(audiomixtime)`</b>,
+///                  \anchor Player_Process_audiomixtime
+///                  _string_,
+///     @return Median / 99th percentile / maximum time in ms the audio engine spent mixing a period.
+///     <p><hr>
+///     @skinning_v19 **[New Infolabel]** \link Player_Process_audiomixtime `Player.Process(audiomixtime)`\endlink
+///     <p>
+///   }
+///   \table_row3{   <b>`Player.Process(audioencodetime)`</b>,
+///                  \anchor Player_Process_audioencodetime
+///                  _string_,
+///     @return Median / 99th percentile / maximum time in ms the audio engine spent encoding a period when transcoding.
+///     <p><hr>
+///     @skinning_v19 **[New Infolabel]** \link Player_Process_audioencodetime `Player.Process(audioencodetime)`\endlink
+///     <p>
+///   }
+///   \table_row3{   <b>`Player.Process(audiosinktime)`</b>,
+///                  \anchor Player_Process_audiosinktime
+///                  _string_,
+///     @return Median / 99th percentile / maximum time in ms the audio engine spent writing a period to the audio device.
+///     <p><hr>
+///     @skinning_v19 **[New Infolabel]** \link Player_Process_audiosinktime `Player.Process(audiosinktime)`\endlink
+///     <p>
+///   }
+///   \table_row3{   <b>`Player.Process(audiosinkdrift)`</b>,
+///                  \anchor Player_Process_audiosinkdrift
+///                  _string_,
+///     @return Median / 99th percentile / maximum deviation in ms of the delay reported by the audio device from the expected delay.
+///     <p><hr>
+///     @skinning_v19 **[New Infolabel]** \link Player_Process_audiosinkdrift `Player.Process(audiosinkdrift)`\endlink
+///     <p>
+///   }
+///   \table_row3{   <b>`Player.Process(demuxpackets)`</b>,
+///                  \anchor Player_Process_demuxpackets
+///                  _string_,
+///     @return Demux packet buffers allocated / reused from the pool / referenced without a copy per second.
+///     <p><hr>
+///     @skinning_v19 **[New Infolabel]** \link Player_Process_demuxpackets `Player.Process(demuxpackets)`\endlink
+///     <p>
+///   }
+///   \table_row3{   <b>`Player.Process(demuxcopyrate)`</b>,
+///                  \anchor Player_Process_demuxcopyrate
+///                  _string_,
+///     @return Amount of demuxed data copied into packet buffers in MB per second.
+///     <p><hr>
+///     @skinning_v19 **[New Infolabel]** \link Player_Process_demuxcopyrate `Player.Process(demuxcopyrate)`\endlink
+///     <p>
+///   }
+///   \table_row3{   <b>`Player.Process(videobuffers)`</b>,
+///                  \anchor Player_Process_videobuffers
+///                  _string_,
+///     @return Frame buffers of software decoding in use / allocated and the memory they hold.
+///     <p><hr>
+///     @skinning_v19 **[New Infolabel]** \link Player_Process_videobuffers `Player.Process(videobuffers)`\endlink
+///     <p>
+///   }
 /// \table_end
 ///
 /// -----------------------------------------------------------------------------
@@ -951,7 +1015,15 @@ const infomap player_process[] =
   { "audiodecoder", PLAYER_PROCESS_AUDIODECODER },
   { "audiochannels", PLAYER_PROCESS_AUDIOCHANNELS },
   { "audiosamplerate", PLAYER_PROCESS_AUDIOSAMPLERATE },
-  { "audiobitspersample", PLAYER_PROCESS_AUDIOBITSPERSAMPLE }
+  { "audiobitspersample", PLAYER_PROCESS_AUDIOBITSPERSAMPLE },
+  { "audioresampletime", PLAYER_PROCESS_AUDIORESAMPLETIME },
+  { "audiomixtime", PLAYER_PROCESS_AUDIOMIXTIME },
+  { "audioencodetime", PLAYER_PROCESS_AUDIOENCODETIME },
+  { "audiosinktime", PLAYER_PROCESS_AUDIOSINKTIME },
+  { "audiosinkdrift", PLAYER_PROCESS_AUDIOSINKDRIFT },
+  { "demuxpackets", PLAYER_PROCESS_DEMUXPACKETS },
+  { "demuxcopyrate", PLAYER_PROCESS_DEMUXCOPYRATE },
+  { "videobuffers", PLAYER_PROCESS_VIDEOBUFFERS }
 };
 
 /// \page modules__infolabels_boolean_conditions
@@ -9359,9 +9431,9 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   std::pair<INFOBOOLTYPE::iterator, bool> res;
 
   if (condition.find_first_of("|+[]!") != condition.npos)
-    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refresh));
   else
-    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refresh));
 
   if (res.second)
     res.first->get()->Initialize();
@@ -9406,6 +9478,35 @@ bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListI
   return (condition1 < 0) ? !bReturn : bReturn;
 }
 
+unsigned int CGUIInfoManager::GetInfoSources(int condition) const
+{
+  int info = std::abs(condition);
+  if (info >= MULTI_INFO_START && info <= MULTI_INFO_END)
+    info = std::abs(m_multiInfo[info - MULTI_INFO_START].m_info);
+
+  switch (info)
+  {
+    case SYSTEM_ALWAYS_TRUE:
+    case SYSTEM_ALWAYS_FALSE:
+    case SYSTEM_PLATFORM_LINUX:
+    case SYSTEM_PLATFORM_WINDOWS:
+    case SYSTEM_PLATFORM_UWP:
+    case SYSTEM_PLATFORM_DARWIN:
+    case SYSTEM_PLATFORM_DARWIN_OSX:
+    case SYSTEM_PLATFORM_DARWIN_IOS:
+    case SYSTEM_PLATFORM_ANDROID:
+    case SYSTEM_PLATFORM_LINUX_RASPBERRY_PI:
+      return 0;
+    // only changed by CSkinSettings, which resets them
+    case SKIN_BOOL:
+    case SKIN_STRING:
+    case SKIN_STRING_IS_EQUAL:
+      return INFO::INFO_SOURCE_SKIN_SETTINGS;
+    default:
+      return INFO::INFO_SOURCE_FRAME;
+  }
+}
+
 bool CGUIInfoManager::GetMultiInfoBool(const CGUIInfo &info, int contextWindow, const CGUIListItem *item)
 {
   bool bReturn = false;
@@ -9938,11 +10039,16 @@ bool CGUIInfoManager::GetItemBool(const CGUIListItem *item, int contextWindow, i
   return value;
 }
 
-void CGUIInfoManager::ResetCache()
+void CGUIInfoManager::ResetCache(unsigned int sources /* = INFO::INFO_SOURCE_ALL */)
 {
   // mark our infobools as dirty
   CSingleLock lock(m_critInfo);
-  ++m_refreshCounter;
+  m_refresh.SetDirty(sources);
+  if (sources & INFO::INFO_SOURCE_FRAME)
+  {
+    m_evaluations = m_refresh.m_evaluations;
+    m_refresh.m_evaluations = 0;
+  }
 }
 
 void CGUIInfoManager::SetCurrentVideoTag(const CVideoInfoTag &tag)
@@ -59,7 +59,15 @@ public:
   void Initialize();
 
   void Clear();
-  void ResetCache();
+
+  /*! \brief Mark the conditions depending on the given sources for evaluation
+   \param sources the INFO::InfoSource flags of the sources that changed
+   */
+  void ResetCache(unsigned int sources = INFO::INFO_SOURCE_ALL);
+
+  /*! \brief Number of condition evaluations between the last two refreshes of the frame source
+   */
+  unsigned int GetEvaluations() const { return m_evaluations; }
 
   // KODI::MESSAGING::IMessageTarget implementation
   int GetMessageMask() override;
@@ -91,6 +99,11 @@ public:
   int TranslateString(const std::string &strCondition);
   int TranslateSingleString(const std::string &strCondition, bool &listItemDependent);
 
+  /*! \brief Get the sources the value of a translated condition is evaluated from
+   \return the INFO::InfoSource flags, 0 if the value never changes
+   */
+  unsigned int GetInfoSources(int condition) const;
+
   std::string GetLabel(int info, int contextWindow = 0, std::string *fallback = nullptr) const;
   std::string GetImage(int info, int contextWindow, std::string *fallback = nullptr);
   bool GetInt(int &value, int info, int contextWindow = 0, const CGUIListItem *item = nullptr) const;
@@ -200,7 +213,8 @@ private:
 
   typedef std::set<INFO::InfoPtr, bool(*)(const INFO::InfoPtr&, const INFO::InfoPtr&)> INFOBOOLTYPE;
   INFOBOOLTYPE m_bools;
-  unsigned int m_refreshCounter = 0;
+  INFO::InfoRefresh m_refresh;
+  unsigned int m_evaluations = 0;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   CCriticalSection m_critInfo;
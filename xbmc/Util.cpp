@@ -570,14 +570,34 @@ std::string CUtil::GetFileDigest(const std::string& strPath, KODI::UTILITY::CDig
   std::string result;
   if (file.Open(strPath))
   {
+    // hash a chunk while the next one is read, add-on install jobs may wait
+    // for the reads as they don't run on the job workers
+    const size_t chunkSize = 256 * 1024;
+    std::vector<char> chunks[2] = {std::vector<char>(chunkSize), std::vector<char>(chunkSize)};
     CDigest digest{type};
-    char temp[1024];
-    while (true)
+    int64_t position = 0;
+    auto request = file.ReadAsync(position, chunks[0].data(), chunkSize);
+    for (int current = 0;; current = 1 - current)
     {
-      ssize_t read = file.Read(temp,1024);
+      request->Wait();
+      const ssize_t read = request->GetResult();
+      if (read < 0 && position == 0)
+      {
+        // can't read at a position, read it in order instead
+        ssize_t size;
+        while ((size = file.Read(chunks[0].data(), chunkSize)) > 0)
+          digest.Update(chunks[0].data(), size);
+        break;
+      }
       if (read <= 0)
         break;
-      digest.Update(temp,read);
+
+      position += read;
+      if (read == static_cast<ssize_t>(chunkSize))
+        request = file.ReadAsync(position, chunks[1 - current].data(), chunkSize);
+      digest.Update(chunks[current].data(), read);
+      if (read < static_cast<ssize_t>(chunkSize))
+        break;
     }
     result = digest.Finalize();
     file.Close();
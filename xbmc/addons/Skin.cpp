@@ -8,6 +8,7 @@
 
 #include "Skin.h"
 #include "AddonManager.h"
+#include "FileItem.h"
 #include "ServiceBroker.h"
 #include "Util.h"
 #include "dialogs/GUIDialogKaiToast.h"
@@ -26,12 +27,15 @@
 #include "settings/lib/Setting.h"
 #include "settings/lib/SettingDefinitions.h"
 #include "threads/Timer.h"
+#include "utils/Crc32.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/XMLUtils.h"
 #include "utils/Variant.h"
 
+#include <cinttypes>
+
 #define XML_SETTINGS      "settings"
 #define XML_SETTING       "setting"
 #define XML_ATTR_TYPE     "type"
@@ -274,6 +278,23 @@ void CSkinInfo::LoadIncludes()
   CLog::Log(LOGINFO, "Loading skin includes from %s", includesPath.c_str());
   m_includes.Clear();
   m_includes.Load(includesPath);
+
+  // cached windows are only used with the same skin files and include files loaded
+  std::string stamp = StringUtils::Format("%s-%s", ID().c_str(), Version().asString().c_str());
+  std::vector<std::string> paths;
+  GetSkinPaths(paths);
+  for (const auto& path : paths)
+  {
+    CFileItemList items;
+    CDirectory::GetDirectory(path, items, ".xml", DIR_FLAG_NO_FILE_DIRS);
+    items.Sort(SortByFile, SortOrderAscending);
+    for (const auto& item : items)
+      stamp += StringUtils::Format("|%s-%" PRId64 "-%s", item->GetPath().c_str(), item->m_dwSize,
+                                   item->m_dateTime.GetAsDBDateTime().c_str());
+  }
+  for (const auto& condition : m_includes.GetFileConditions())
+    stamp += StringUtils::Format("|%s-%d", condition.first.c_str(), condition.second);
+  m_windowCache.SetStamp(StringUtils::Format("%08x", Crc32::Compute(stamp)));
 }
 
 void CSkinInfo::ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions /* = NULL */)
@@ -284,6 +305,20 @@ void CSkinInfo::ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool
   m_includes.Resolve(node, xmlIncludeConditions);
 }
 
+std::unique_ptr<TiXmlElement> CSkinInfo::GetResolvedWindow(const std::string& path, std::map<INFO::InfoPtr, bool>& xmlIncludeConditions) const
+{
+  if (!URIUtils::PathHasParent(path, Path()))
+    return nullptr;
+
+  return m_windowCache.Get(path, xmlIncludeConditions);
+}
+
+void CSkinInfo::SetResolvedWindow(const std::string& path, const TiXmlElement& root, const std::map<INFO::InfoPtr, bool>& xmlIncludeConditions) const
+{
+  if (URIUtils::PathHasParent(path, Path()))
+    m_windowCache.Set(path, root, xmlIncludeConditions);
+}
+
 int CSkinInfo::GetStartWindow() const
 {
   int windowID = CServiceBroker::GetSettingsComponent()->GetSettings()->GetInt(CSettings::SETTING_LOOKANDFEEL_STARTUPWINDOW);
@@ -10,6 +10,7 @@
 
 #include "addons/Addon.h"
 #include "guilib/GUIIncludes.h" // needed for the GUIInclude member
+#include "guilib/GUIWindowXMLCache.h"
 #include "windowing/GraphicContext.h" // needed for the RESOLUTION members
 
 #include <map>
@@ -152,6 +153,17 @@ public:
 
   void ResolveIncludes(TiXmlElement *node, std::map<INFO::InfoPtr, bool>* xmlIncludeConditions = NULL);
 
+  /*! \brief Get a window of the skin with its includes resolved from the cache
+   \param path path of the window XML file
+   \param xmlIncludeConditions [out] the conditions of the includes it was resolved with
+   \return the root element, nullptr if the window has to be resolved
+   */
+  std::unique_ptr<TiXmlElement> GetResolvedWindow(const std::string& path, std::map<INFO::InfoPtr, bool>& xmlIncludeConditions) const;
+
+  /*! \brief Cache a window of the skin resolved by ResolveIncludes()
+   */
+  void SetResolvedWindow(const std::string& path, const TiXmlElement& root, const std::map<INFO::InfoPtr, bool>& xmlIncludeConditions) const;
+
   float GetEffectsSlowdown() const { return m_effectsSlowDown; };
 
   const std::vector<CStartupWindow> &GetStartupWindows() const { return m_startupWindows; };
@@ -209,6 +221,7 @@ protected:
 
   float m_effectsSlowDown;
   CGUIIncludes m_includes;
+  CGUIWindowXMLCache m_windowCache;
   std::string m_currentAspect;
 
   std::vector<CStartupWindow> m_startupWindows;
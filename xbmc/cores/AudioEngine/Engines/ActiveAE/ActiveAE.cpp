@@ -15,6 +15,7 @@ using namespace ActiveAE;
 #include "ActiveAEStream.h"
 #include "ServiceBroker.h"
 #include "cores/AudioEngine/Interfaces/IAudioCallback.h"
+#include "cores/AudioEngine/Utils/AEMixKernels.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Utils/AEStreamData.h"
 #include "cores/AudioEngine/Utils/AEStreamInfo.h"
@@ -23,8 +24,10 @@ using namespace ActiveAE;
 
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
+#include "utils/CPUInfo.h"
 #include "windowing/WinSystem.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 
 #define MAX_CACHE_LEVEL 0.4   // total cache time of stream in seconds
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
@@ -38,6 +41,9 @@ void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
   m_bufferedSamples = 0;
   m_suspended = false;
   m_pcmOutput = pcm;
+
+  for (auto& timing : m_stageTiming)
+    timing.Reset();
 }
 
 void CEngineStats::UpdateSinkDelay(const AEDelayStatus& status, int samples)
@@ -52,6 +58,20 @@ void CEngineStats::UpdateSinkDelay(const AEDelayStatus& status, int samples)
     m_bufferedSamples -= samples;
 }
 
+void CEngineStats::PublishStageTiming()
+{
+  CDataCacheCore& dataCache = CServiceBroker::GetDataCacheCore();
+  for (int i = 0; i < CDataCacheCore::AE_STAGE_MAX; i++)
+  {
+    CDataCacheCore::SAudioEngineTiming timing;
+    timing.count = m_stageTiming[i].GetCount();
+    timing.median = m_stageTiming[i].GetPercentile(50.0);
+    timing.p99 = m_stageTiming[i].GetPercentile(99.0);
+    timing.max = m_stageTiming[i].GetMax();
+    dataCache.SetAudioEngineTiming(static_cast<CDataCacheCore::AudioEngineStage>(i), timing);
+  }
+}
+
 void CEngineStats::AddSamples(int samples, std::list<CActiveAEStream*> &streams)
 {
   CSingleLock lock(m_lock);
@@ -751,21 +771,6 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
           else
             msg->Reply(CActiveAEDataProtocol::ERR);
           return;
-        case CActiveAEDataProtocol::STREAMSAMPLE:
-          MsgStreamSample *msgData;
-          CSampleBuffer *samples;
-          msgData = reinterpret_cast<MsgStreamSample*>(msg->data);
-          samples = msgData->stream->m_processingSamples.front();
-          msgData->stream->m_processingSamples.pop_front();
-          if (samples != msgData->buffer)
-            CLog::Log(LOGERROR, "CActiveAE - inconsistency in stream sample message");
-          if (msgData->buffer->pkt->nb_samples == 0)
-            msgData->buffer->Return();
-          else
-            msgData->stream->m_processingBuffers->m_inputSamples.push_back(msgData->buffer);
-          m_extTimeout = 0;
-          m_state = AE_TOP_CONFIGURED_PLAY;
-          return;
         case CActiveAEDataProtocol::FREESTREAM:
           MsgStreamFree *msgStreamFree;
           msgStreamFree = reinterpret_cast<MsgStreamFree*>(msg->data);
@@ -1068,6 +1073,12 @@ void CActiveAE::Process()
       continue;
     }
 
+    // samples handed over by the streams
+    else if (!m_extDeferData && ReceiveStreamSamples())
+    {
+      continue;
+    }
+
     // wait for message
     else if (m_outMsgEvent.WaitMSec(m_extTimeout))
     {
@@ -1498,6 +1509,7 @@ void CActiveAE::SFlushStream(CActiveAEStream *stream)
   }
   stream->m_processingBuffers->Flush();
   stream->m_streamPort->Purge();
+  stream->ResetRings();
   stream->m_bufferedTime = 0.0;
   stream->m_paused = false;
   stream->m_syncState = CAESyncInfo::AESyncState::SYNC_START;
@@ -1513,6 +1525,38 @@ void CActiveAE::SFlushStream(CActiveAEStream *stream)
   m_stats.UpdateStream(stream);
 }
 
+bool CActiveAE::ReceiveStreamSamples()
+{
+  // streams only deliver to a configured engine, otherwise samples stay in the ring
+  if (m_state != AE_TOP_CONFIGURED && AE_parentStates[m_state] != AE_TOP_CONFIGURED)
+    return false;
+
+  bool received = false;
+  CSampleBuffer *samples;
+  for (auto stream : m_streams)
+  {
+    while (stream->PopSample(samples))
+    {
+      if (stream->m_processingSamples.empty() || stream->m_processingSamples.front() != samples)
+        CLog::Log(LOGERROR, "CActiveAE - inconsistency in stream sample");
+      if (!stream->m_processingSamples.empty())
+        stream->m_processingSamples.pop_front();
+      if (samples->pkt->nb_samples == 0)
+        samples->Return();
+      else
+        stream->m_processingBuffers->m_inputSamples.push_back(samples);
+      received = true;
+    }
+  }
+
+  if (received)
+  {
+    m_extTimeout = 0;
+    m_state = AE_TOP_CONFIGURED_PLAY;
+  }
+  return received;
+}
+
 void CActiveAE::FlushEngine()
 {
   if (m_sinkBuffers)
@@ -1853,7 +1897,12 @@ bool CActiveAE::RunStages()
   for (it = m_streams.begin(); it != m_streams.end(); ++it)
   {
     if ((*it)->m_processingBuffers && !(*it)->m_paused)
+    {
+      int64_t start = CurrentHostCounter();
       busy = (*it)->m_processingBuffers->ProcessBuffers();
+      if (busy)
+        m_stats.GetStageTiming(CDataCacheCore::AE_STAGE_RESAMPLE).AddElapsed(start);
+    }
 
     if ((*it)->m_streamIsBuffering &&
         (*it)->m_processingBuffers &&
@@ -1871,11 +1920,13 @@ bool CActiveAE::RunStages()
       float buftime = (float)(*it)->m_inputBuffers->m_format.m_frames / (*it)->m_inputBuffers->m_format.m_sampleRate;
       if ((*it)->m_inputBuffers->m_format.m_dataFormat == AE_FMT_RAW)
         buftime = (*it)->m_inputBuffers->m_format.m_streamInfo.GetDuration() / 1000;
-      while ((time < MAX_CACHE_LEVEL || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
+      while ((time < MAX_CACHE_LEVEL || (*it)->m_streamIsBuffering) &&
+             !(*it)->m_inputBuffers->m_freeSamples.empty() &&
+             (*it)->m_processingSamples.size() < CActiveAEStream::MAX_RING_BUFFERS)
       {
         buffer = (*it)->m_inputBuffers->GetFreeBuffer();
         (*it)->m_processingSamples.push_back(buffer);
-        (*it)->m_streamPort->SendInMessage(CActiveAEDataProtocol::STREAMBUFFER, &buffer, sizeof(CSampleBuffer*));
+        (*it)->PushFreeBuffer(buffer);
         (*it)->IncFreeBuffers();
         time += buftime;
       }
@@ -1949,6 +2000,8 @@ bool CActiveAE::RunStages()
     // mix streams and sounds sounds
     if (m_mode != MODE_RAW)
     {
+      const AEMixKernels& kernels = CAEMixKernels::Get();
+      int64_t mixStart = CurrentHostCounter();
       CSampleBuffer *out = NULL;
       if (!m_sounds_playing.empty() && m_streams.empty())
       {
@@ -1978,7 +2031,8 @@ bool CActiveAE::RunStages()
           allStreamsReady = false;
       }
 
-      bool needClamp = false;
+      m_mixInputs.clear();
+      m_mixStreams.clear();
       for (it = m_streams.begin(); it != m_streams.end() && allStreamsReady; ++it)
       {
         if ((*it)->m_paused || !(*it)->m_processingBuffers)
@@ -1997,174 +2051,86 @@ bool CActiveAE::RunStages()
 
           (*it)->m_started = true;
 
-          if (!out)
-          {
-            out = (*it)->m_processingBuffers->m_outputSamples.front();
-            (*it)->m_processingBuffers->m_outputSamples.pop_front();
+          CSampleBuffer *mix = (*it)->m_processingBuffers->m_outputSamples.front();
+          (*it)->m_processingBuffers->m_outputSamples.pop_front();
 
-            int nb_floats = out->pkt->nb_samples * out->pkt->config.channels / out->pkt->planes;
-            int nb_loops = 1;
-            float fadingStep = 0.0f;
+          // samples inserted by sync are the output, they are mixed as they are
+          if (out && m_mixInputs.empty())
+          {
+            CActiveAEMixer::Input input;
+            input.data = (float**)out->pkt->data;
+            input.planes = out->pkt->planes;
+            input.channels = out->pkt->config.channels;
+            m_mixInputs.push_back(input);
+          }
 
-            // fading
-            if ((*it)->m_fadingSamples == -1)
-            {
-              (*it)->m_fadingSamples = m_internalFormat.m_sampleRate * (float)(*it)->m_fadingTime / 1000.0f;
-              if ((*it)->m_fadingSamples > 0)
-                (*it)->m_volume = (*it)->m_fadingBase;
-              else
-              {
-                (*it)->m_volume = (*it)->m_fadingTarget;
-                CSingleLock lock((*it)->m_streamLock);
-                (*it)->m_streamFading = false;
-              }
-            }
+          // fading
+          if ((*it)->m_fadingSamples == -1)
+          {
+            (*it)->m_fadingSamples = m_internalFormat.m_sampleRate * (float)(*it)->m_fadingTime / 1000.0f;
             if ((*it)->m_fadingSamples > 0)
+              (*it)->m_volume = (*it)->m_fadingBase;
+            else
             {
-              nb_floats = out->pkt->config.channels / out->pkt->planes;
-              nb_loops = out->pkt->nb_samples;
-              float delta = (*it)->m_fadingTarget - (*it)->m_fadingBase;
-              int samples = m_internalFormat.m_sampleRate * (float)(*it)->m_fadingTime / 1000.0f;
-              fadingStep = delta / samples;
-            }
-
-            // for stream amplification,
-            // turned off downmix normalization,
-            // or if sink format is float (in order to prevent from clipping)
-            // we need to run on a per sample basis
-            if ((*it)->m_amplify != 1.0 || !(*it)->m_processingBuffers->DoesNormalize() || (m_sinkFormat.m_dataFormat == AE_FMT_FLOAT))
-            {
-              nb_floats = out->pkt->config.channels / out->pkt->planes;
-              nb_loops = out->pkt->nb_samples;
-            }
-
-            for(int i=0; i<nb_loops; i++)
-            {
-              if ((*it)->m_fadingSamples > 0)
-              {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
-                {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
-                }
-              }
-
-              // volume for stream
-              float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)out->pkt->data, out->pkt->config.channels, i*nb_floats, out->pkt->planes > 1);
-
-              for(int j=0; j<out->pkt->planes; j++)
-              {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
-              }
+              (*it)->m_volume = (*it)->m_fadingTarget;
+              CSingleLock lock((*it)->m_streamLock);
+              (*it)->m_streamFading = false;
             }
           }
-          else
-          {
-            CSampleBuffer *mix = NULL;
-            mix = (*it)->m_processingBuffers->m_outputSamples.front();
-            (*it)->m_processingBuffers->m_outputSamples.pop_front();
-
-            int nb_floats = mix->pkt->nb_samples * mix->pkt->config.channels / mix->pkt->planes;
-            int nb_loops = 1;
-            float fadingStep = 0.0f;
 
-            // fading
-            if ((*it)->m_fadingSamples == -1)
-            {
-              (*it)->m_fadingSamples = m_internalFormat.m_sampleRate * (float)(*it)->m_fadingTime / 1000.0f;
-              (*it)->m_volume = (*it)->m_fadingBase;
-            }
-            if ((*it)->m_fadingSamples > 0)
-            {
-              nb_floats = mix->pkt->config.channels / mix->pkt->planes;
-              nb_loops = mix->pkt->nb_samples;
-              float delta = (*it)->m_fadingTarget - (*it)->m_fadingBase;
-              int samples = m_internalFormat.m_sampleRate * (float)(*it)->m_fadingTime / 1000.0f;
-              fadingStep = delta / samples;
-            }
+          CActiveAEMixer::Input input;
+          input.data = (float**)mix->pkt->data;
+          input.planes = mix->pkt->planes;
+          input.channels = mix->pkt->config.channels;
+          input.volume = &(*it)->m_volume;
+          input.fadingSamples = &(*it)->m_fadingSamples;
+          input.rgain = (*it)->m_rgain;
+          input.limiter = &(*it)->m_limiter;
+          if ((*it)->m_fadingSamples > 0)
+          {
+            float delta = (*it)->m_fadingTarget - (*it)->m_fadingBase;
+            int samples = m_internalFormat.m_sampleRate * (float)(*it)->m_fadingTime / 1000.0f;
+            input.fadingStep = delta / samples;
+          }
 
-            // for streams amplification of turned off downmix normalization
-            // we need to run on a per sample basis
-            if ((*it)->m_amplify != 1.0 || !(*it)->m_processingBuffers->DoesNormalize())
-            {
-              nb_floats = out->pkt->config.channels / out->pkt->planes;
-              nb_loops = out->pkt->nb_samples;
-            }
+          // for stream amplification,
+          // turned off downmix normalization,
+          // or if sink format is float (in order to prevent from clipping)
+          // we need to run on a per sample basis
+          input.limit = (*it)->m_amplify != 1.0 || !(*it)->m_processingBuffers->DoesNormalize() ||
+                        (!out && m_sinkFormat.m_dataFormat == AE_FMT_FLOAT);
 
-            for(int i=0; i<nb_loops; i++)
-            {
-              if ((*it)->m_fadingSamples > 0)
-              {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
-                {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
-                }
-              }
+          m_mixInputs.push_back(input);
+          m_mixStreams.push_back({*it, mix, (*it)->m_fadingSamples > 0});
 
-              // volume for stream
-              float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)mix->pkt->data, mix->pkt->config.channels, i*nb_floats, mix->pkt->planes > 1);
+          if (!out)
+            out = mix;
 
-              for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
-              {
-                float *dst = (float*)out->pkt->data[j]+i*nb_floats;
-                float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
-              }
-            }
-            mix->Return();
-          }
           busy = true;
         }
       }// for
 
-      // finally clamp samples
-      if (out && needClamp)
+      // gain, limiter, mix and clamp of all streams in one pass
+      if (!m_mixInputs.empty())
       {
-        int nb_floats = out->pkt->nb_samples * out->pkt->config.channels / out->pkt->planes;
-        for (int i=0; i<out->pkt->planes; i++)
+        CActiveAEMixer::Mix(kernels, m_mixInputs, out->pkt->nb_samples);
+
+        for (auto& mixed : m_mixStreams)
         {
-          CAEUtil::ClampArray((float*)out->pkt->data[i], nb_floats);
+          if (mixed.fading && mixed.stream->m_fadingSamples == 0)
+          {
+            // set variables being polled via stream interface
+            CSingleLock lock(mixed.stream->m_streamLock);
+            mixed.stream->m_streamFading = false;
+          }
+          if (mixed.buffer != out)
+            mixed.buffer->Return();
         }
       }
 
+      if (out)
+        m_stats.GetStageTiming(CDataCacheCore::AE_STAGE_MIX).AddElapsed(mixStart);
+
       // process output buffer, gui sounds, encode, viz
       if (out)
       {
@@ -2231,8 +2197,10 @@ bool CActiveAE::RunStages()
           if (out->pkt->nb_samples)
           {
             buf = m_encoderBuffers->GetFreeBuffer();
+            int64_t encodeStart = CurrentHostCounter();
             buf->pkt->nb_samples = m_encoder->Encode(out->pkt->data[0], out->pkt->planes*out->pkt->linesize,
                                                      buf->pkt->data[0], buf->pkt->planes*buf->pkt->linesize);
+            m_stats.GetStageTiming(CDataCacheCore::AE_STAGE_ENCODE).AddElapsed(encodeStart);
 
             // set pts of last sample
             buf->pkt_start_offset = buf->pkt->nb_samples;
@@ -2289,6 +2257,12 @@ bool CActiveAE::RunStages()
     busy = true;
   }
 
+  if (m_stageTimingPublishTimer.IsTimePast())
+  {
+    m_stats.PublishStageTiming();
+    m_stageTimingPublishTimer.Set(1000);
+  }
+
   return busy;
 }
 
@@ -2510,6 +2484,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
   float *out;
   float *sample_buffer;
   int max_samples = dstSample.nb_samples;
+  const AEMixKernels& kernels = CAEMixKernels::Get();
 
   std::list<SoundState>::iterator it;
   for (it = m_sounds_playing.begin(); it != m_sounds_playing.end(); )
@@ -2529,12 +2504,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      kernels.MulAddArray(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2555,17 +2525,12 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
   {
     int nb_floats = dstSample.nb_samples * dstSample.config.channels / dstSample.planes;
     float volume = m_muted ? 0.0f : m_volumeScaled;
+    const AEMixKernels& kernels = CAEMixKernels::Get();
 
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      kernels.MulArray(buffer, volume, nb_floats);
     }
   }
 }
@@ -2607,6 +2572,8 @@ void CActiveAE::LoadSettings()
 
 void CActiveAE::Start()
 {
+  CAEMixKernels::Select(CServiceBroker::GetCPUInfo()->GetCPUFeatures());
+
   Create();
   Message *reply;
   if (m_controlPort.SendOutMessageSync(CActiveAEControlProtocol::INIT,
@@ -18,6 +18,9 @@
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 #include "cores/AudioEngine/Interfaces/AESound.h"
 #include "cores/AudioEngine/Engines/ActiveAE/ActiveAEBuffer.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEMixer.h"
+#include "cores/AudioEngine/Utils/AELatencyHistogram.h"
+#include "cores/DataCacheCore.h"
 
 #include "guilib/DispResource.h"
 #include <queue>
@@ -112,14 +115,12 @@ public:
     FREESOUND,
     NEWSTREAM,
     FREESTREAM,
-    STREAMSAMPLE,
     DRAINSTREAM,
   };
   enum InSignal
   {
     ACC,
     ERR,
-    STREAMBUFFER,
     STREAMDRAINED,
   };
 };
@@ -137,12 +138,6 @@ struct MsgStreamFree
   bool finish; // if true switch back to gui sound mode
 };
 
-struct MsgStreamSample
-{
-  CSampleBuffer *buffer;
-  CActiveAEStream *stream;
-};
-
 struct MsgStreamParameter
 {
   CActiveAEStream *stream;
@@ -192,6 +187,16 @@ public:
   void SetSinkLatency(float time) { m_sinkLatency = time; }
   bool IsSuspended();
   AEAudioFormat GetCurrentSinkFormat();
+
+  /*! \brief per period timing of the engine stages
+   Each stage must only be recorded from one thread, the engine thread for
+   resample/mix/encode and the sink thread for sink write/drift.
+   */
+  CAELatencyHistogram& GetStageTiming(CDataCacheCore::AudioEngineStage stage)
+  {
+    return m_stageTiming[stage];
+  }
+  void PublishStageTiming();
 protected:
   float m_sinkCacheTotal;
   float m_sinkLatency;
@@ -212,6 +217,7 @@ protected:
     CAESyncInfo::AESyncState m_syncState;
   };
   std::vector<StreamStats> m_streamStats;
+  CAELatencyHistogram m_stageTiming[CDataCacheCore::AE_STAGE_MAX];
 };
 
 class CActiveAE : public IAE, public IDispResource, private CThread
@@ -299,6 +305,7 @@ protected:
   CActiveAEStream* CreateStream(MsgStreamNew *streamMsg);
   void DiscardStream(CActiveAEStream *stream);
   void SFlushStream(CActiveAEStream *stream);
+  bool ReceiveStreamSamples();
   void FlushEngine();
   void ClearDiscardedBuffers();
   void SStopSound(CActiveAESound *sound);
@@ -326,6 +333,7 @@ protected:
   bool m_extError;
   bool m_extDrain;
   XbmcThreads::EndTime m_extDrainTimer;
+  XbmcThreads::EndTime m_stageTimingPublishTimer;
   unsigned int m_extKeepConfig;
   bool m_extDeferData;
   std::queue<time_t> m_extLastDeviceChange;
@@ -362,6 +370,16 @@ protected:
   std::list<CActiveAEBufferPool*> m_discardBufferPools;
   unsigned int m_streamIdGen;
 
+  // streams mixed in the current period, kept to reuse their storage
+  struct MixState
+  {
+    CActiveAEStream *stream;
+    CSampleBuffer *buffer;
+    bool fading;
+  };
+  std::vector<CActiveAEMixer::Input> m_mixInputs;
+  std::vector<MixState> m_mixStreams;
+
   // gui sounds
   struct SoundState
   {
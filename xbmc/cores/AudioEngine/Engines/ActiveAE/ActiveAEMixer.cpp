@@ -0,0 +1,114 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ActiveAEMixer.h"
+
+#include "cores/AudioEngine/Utils/AELimiter.h"
+#include "cores/AudioEngine/Utils/AEMixKernels.h"
+
+#include <algorithm>
+
+using namespace ActiveAE;
+
+constexpr int CActiveAEMixer::BLOCK_FRAMES;
+
+bool CActiveAEMixer::ComputeGains(Input& input, int offset, int frames, float* gains)
+{
+  if (!input.volume)
+  {
+    gains[0] = 1.0f;
+    return false;
+  }
+
+  if (!input.perFrame)
+  {
+    gains[0] = *input.volume * input.rgain;
+    return false;
+  }
+
+  const int stride = input.channels / input.planes;
+  for (int i = 0; i < frames; i++)
+  {
+    if (*input.fadingSamples > 0)
+    {
+      *input.volume += input.fadingStep;
+      (*input.fadingSamples)--;
+    }
+
+    float gain = *input.volume * input.rgain;
+    if (input.limiter)
+      gain *= input.limiter->Run(input.data, input.channels, (offset + i) * stride, input.planes > 1);
+    gains[i] = gain;
+  }
+  return true;
+}
+
+void CActiveAEMixer::Mix(const AEMixKernels& kernels, std::vector<Input>& inputs, int frames)
+{
+  if (inputs.empty() || frames <= 0)
+    return;
+
+  // fading and limiting are decided once per period
+  for (auto& input : inputs)
+    input.perFrame = input.volume && (input.limit || *input.fadingSamples > 0);
+
+  const Input& out = inputs.front();
+  const int stride = out.channels / out.planes;
+  float gains[BLOCK_FRAMES];
+
+  for (int offset = 0; offset < frames; offset += BLOCK_FRAMES)
+  {
+    const int count = std::min(BLOCK_FRAMES, frames - offset);
+    float peak = 0.0f;
+
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+      Input& input = inputs[i];
+      const bool perFrame = ComputeGains(input, offset, count, gains);
+      const int planes = std::min(out.planes, input.planes);
+
+      for (int j = 0; j < planes; j++)
+      {
+        float* dst = out.data[j] + offset * stride;
+        const float* src = input.data[j] + offset * stride;
+
+        // per frame gains mostly come in runs, the limiter is idle and
+        // fading ends, so every run of equal gains gets one kernel call
+        int run = 0;
+        while (run < count)
+        {
+          int end = perFrame ? run + 1 : count;
+          while (end < count && gains[end] == gains[run])
+            end++;
+
+          const float gain = gains[run];
+          const uint32_t floats = (end - run) * stride;
+          if (i == 0)
+          {
+            // the first stream is the output, scale it in place
+            if (gain != 1.0f)
+              kernels.MulArray(dst + run * stride, gain, floats);
+          }
+          else
+          {
+            peak = std::max(peak, kernels.MulAddArray(dst + run * stride, src + run * stride,
+                                                      gain, floats));
+          }
+          run = end;
+        }
+      }
+    }
+
+    // clamp while the block is still in cache
+    if (peak > 1.0f)
+    {
+      for (int j = 0; j < out.planes; j++)
+        kernels.ClampArray(out.data[j] + offset * stride, count * stride);
+    }
+  }
+}
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <vector>
+
+class CAELimiter;
+struct AEMixKernels;
+
+namespace ActiveAE
+{
+
+/*!
+ * \brief Fused gain, limiter and mix stage for all streams of one period
+ *
+ * Instead of walking the output once per stream and once more for clamping,
+ * the period is processed in blocks small enough to stay in L1: for every
+ * block the gain of each stream is applied and accumulated, then the block
+ * is clamped if needed.
+ */
+class CActiveAEMixer
+{
+public:
+  struct Input
+  {
+    //! float samples, interleaved or one pointer per plane
+    float** data = nullptr;
+    int planes = 1;
+    int channels = 0;
+
+    //! stream volume, advanced by fadingStep per frame while fading,
+    //! nullptr for samples which are already scaled
+    float* volume = nullptr;
+    //! frames left to fade, decremented while fading
+    int* fadingSamples = nullptr;
+    float fadingStep = 0.0f;
+    float rgain = 1.0f;
+
+    //! limit every frame, used for amplification and un-normalized downmixes
+    CAELimiter* limiter = nullptr;
+    bool limit = false;
+
+    //! set by Mix(), gains are computed per frame for the whole period
+    bool perFrame = false;
+  };
+
+  //! frames per block, 256 frames of 7.1 float are 8 KiB
+  static constexpr int BLOCK_FRAMES = 256;
+
+  /*!
+   \brief mix all inputs into the samples of the first one
+   \param kernels mix kernels to use
+   \param inputs streams to mix, the first one is the output
+   \param frames number of frames in every input
+   */
+  static void Mix(const AEMixKernels& kernels, std::vector<Input>& inputs, int frames);
+
+private:
+  //! \return true if gains holds one gain per frame, false if gains[0] applies to all
+  static bool ComputeGains(Input& input, int offset, int frames, float* gains);
+};
+
+}
@@ -15,9 +15,11 @@
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "utils/EndianSwap.h"
 #include "utils/MemUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/log.h"
 
 #include <algorithm>
+#include <cmath>
 #include <new> // for std::bad_alloc
 #include <sstream>
 
@@ -777,6 +779,8 @@ void CActiveAESink::OpenSink()
 
   CLog::Log(LOGINFO, "CActiveAESink::OpenSink - initialize sink");
 
+  m_lastSinkDelayTick = 0;
+
   if (m_sink)
   {
     m_sink->Drain();
@@ -987,6 +991,8 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
   }
 
   int framesOrPackets;
+  int64_t writeStart = CurrentHostCounter();
+  bool measure = frames > 0;
 
   while (frames > 0)
   {
@@ -1025,16 +1031,39 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
 
     m_sink->GetDelay(status);
 
+    // without iec packing raw sinks account in packets, not frames
+    if (m_requestedFormat.m_dataFormat != AE_FMT_RAW || m_needIecPack)
+      TrackDelayDrift(status, written);
+
     if (m_requestedFormat.m_dataFormat != AE_FMT_RAW)
       m_stats->UpdateSinkDelay(status, samples->pool ? written : 0);
   }
 
+  if (measure)
+    m_stats->GetStageTiming(CDataCacheCore::AE_STAGE_SINKWRITE).AddElapsed(writeStart);
+
   if (m_requestedFormat.m_dataFormat == AE_FMT_RAW)
     m_stats->UpdateSinkDelay(status, samples->pool ? 1 : 0);
 
   return status.delay * 1000;
 }
 
+void CActiveAESink::TrackDelayDrift(const AEDelayStatus& status, unsigned int frames)
+{
+  // between two writes the sink delay should grow by what was written and
+  // shrink by the time passed, anything else is drift of the device clock
+  // or jitter in the delay reported by the sink
+  if (m_lastSinkDelayTick && status.tick > m_lastSinkDelayTick && m_sinkFormat.m_sampleRate)
+  {
+    double elapsed = (double)(status.tick - m_lastSinkDelayTick) / CurrentHostFrequency();
+    double expected = m_lastSinkDelay + (double)frames / m_sinkFormat.m_sampleRate - elapsed;
+    double drift = std::abs(status.delay - expected);
+    m_stats->GetStageTiming(CDataCacheCore::AE_STAGE_SINKDRIFT).Add(drift * 1000000);
+  }
+  m_lastSinkDelay = status.delay;
+  m_lastSinkDelayTick = status.tick;
+}
+
 void CActiveAESink::SwapInit(CSampleBuffer* samples)
 {
   if ((m_requestedFormat.m_dataFormat == AE_FMT_RAW) && CAEUtil::S16NeedsByteSwap(AE_FMT_S16NE, m_sinkFormat.m_dataFormat))
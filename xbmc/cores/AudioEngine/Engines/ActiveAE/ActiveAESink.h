@@ -105,6 +105,7 @@ protected:
 
   unsigned int OutputSamples(CSampleBuffer* samples);
   void SwapInit(CSampleBuffer* samples);
+  void TrackDelayDrift(const AEDelayStatus& status, unsigned int frames);
 
   void GenerateNoise();
 
@@ -140,6 +141,8 @@ protected:
   CAEBitstreamPacker *m_packer;
   bool m_needIecPack;
   bool m_streamNoise;
+  double m_lastSinkDelay = 0.0;
+  int64_t m_lastSinkDelayTick = 0;
 };
 
 }
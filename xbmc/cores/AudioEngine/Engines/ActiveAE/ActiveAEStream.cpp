@@ -52,6 +52,8 @@ CActiveAEStream::CActiveAEStream(AEAudioFormat *format, unsigned int streamid, C
   m_lastPtsJump = 0;
   m_errorInterval = 1000;
   m_clockSpeed = 1.0;
+  m_freeRing.Create(MAX_RING_BUFFERS * sizeof(CSampleBuffer*));
+  m_sampleRing.Create(MAX_RING_BUFFERS * sizeof(CSampleBuffer*));
 }
 
 CActiveAEStream::~CActiveAEStream()
@@ -63,22 +65,49 @@ CActiveAEStream::~CActiveAEStream()
 
 void CActiveAEStream::IncFreeBuffers()
 {
-  CSingleLock lock(m_streamLock);
   m_streamFreeBuffers++;
 }
 
 void CActiveAEStream::DecFreeBuffers()
 {
-  CSingleLock lock(m_streamLock);
   m_streamFreeBuffers--;
 }
 
 void CActiveAEStream::ResetFreeBuffers()
 {
-  CSingleLock lock(m_streamLock);
   m_streamFreeBuffers = 0;
 }
 
+bool CActiveAEStream::PopFreeBuffer(CSampleBuffer *&buffer)
+{
+  return m_freeRing.Read(reinterpret_cast<unsigned char*>(&buffer), sizeof(CSampleBuffer*)) == AE_RING_BUFFER_OK;
+}
+
+void CActiveAEStream::PushSample(CSampleBuffer *buffer)
+{
+  // can't overflow, the ring is as large as the engine's outstanding buffers
+  m_sampleRing.Write(reinterpret_cast<unsigned char*>(&buffer), sizeof(CSampleBuffer*));
+  m_activeAE->m_outMsgEvent.Set();
+}
+
+void CActiveAEStream::PushFreeBuffer(CSampleBuffer *buffer)
+{
+  m_freeRing.Write(reinterpret_cast<unsigned char*>(&buffer), sizeof(CSampleBuffer*));
+  m_inMsgEvent.Set();
+}
+
+bool CActiveAEStream::PopSample(CSampleBuffer *&buffer)
+{
+  return m_sampleRing.Read(reinterpret_cast<unsigned char*>(&buffer), sizeof(CSampleBuffer*)) == AE_RING_BUFFER_OK;
+}
+
+void CActiveAEStream::ResetRings()
+{
+  // only while the writing thread waits for the engine, i.e. on flush
+  m_freeRing.Reset();
+  m_sampleRing.Reset();
+}
+
 void CActiveAEStream::InitRemapper()
 {
   // check if input format follows ffmpeg channel mask
@@ -311,33 +340,25 @@ unsigned int CActiveAEStream::AddData(const uint8_t* const *data, unsigned int o
 
       if (m_currentBuffer->pkt->nb_samples == m_currentBuffer->pkt->max_nb_samples || rawPktComplete)
       {
-        MsgStreamSample msgData;
-        msgData.buffer = m_currentBuffer;
-        msgData.stream = this;
         RemapBuffer();
-        m_streamPort->SendOutMessage(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
+        PushSample(m_currentBuffer);
         m_currentBuffer = nullptr;
       }
       continue;
     }
+    else if (PopFreeBuffer(m_currentBuffer))
+    {
+      m_currentBuffer->timestamp = 0;
+      m_currentBuffer->pkt->nb_samples = 0;
+      m_currentBuffer->pkt->pause_burst_ms = 0;
+      DecFreeBuffers();
+      continue;
+    }
     else if (m_streamPort->ReceiveInMessage(&msg))
     {
-      if (msg->signal == CActiveAEDataProtocol::STREAMBUFFER)
-      {
-        m_currentBuffer = *((CSampleBuffer**)msg->data);
-        m_currentBuffer->timestamp = 0;
-        m_currentBuffer->pkt->nb_samples = 0;
-        m_currentBuffer->pkt->pause_burst_ms = 0;
-        msg->Release();
-        DecFreeBuffers();
-        continue;
-      }
-      else
-      {
-        CLog::Log(LOGERROR, "CActiveAEStream::AddData - unknown signal");
-        msg->Release();
-        break;
-      }
+      CLog::Log(LOGERROR, "CActiveAEStream::AddData - unknown signal");
+      msg->Release();
+      break;
     }
     if (!m_inMsgEvent.WaitMSec(200))
       break;
@@ -413,33 +434,30 @@ void CActiveAEStream::Drain(bool wait)
 
   if (m_currentBuffer)
   {
-    MsgStreamSample msgData;
-    msgData.buffer = m_currentBuffer;
-    msgData.stream = this;
     RemapBuffer();
-    m_streamPort->SendOutMessage(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
+    PushSample(m_currentBuffer);
     m_currentBuffer = NULL;
   }
 
   XbmcThreads::EndTime timer(2000);
   while (!timer.IsTimePast())
   {
-    if (m_streamPort->ReceiveInMessage(&msg))
+    CSampleBuffer *buffer;
+    if (PopFreeBuffer(buffer))
     {
-      if (msg->signal == CActiveAEDataProtocol::STREAMBUFFER)
-      {
-        MsgStreamSample msgData;
-        msgData.stream = this;
-        msgData.buffer = *((CSampleBuffer**)msg->data);
-        msg->Reply(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
-        DecFreeBuffers();
-        continue;
-      }
-      else if (msg->signal == CActiveAEDataProtocol::STREAMDRAINED)
+      PushSample(buffer);
+      DecFreeBuffers();
+      continue;
+    }
+    else if (m_streamPort->ReceiveInMessage(&msg))
+    {
+      if (msg->signal == CActiveAEDataProtocol::STREAMDRAINED)
       {
         msg->Release();
         return;
       }
+      msg->Release();
+      continue;
     }
     else if (!wait)
       return;
@@ -13,6 +13,7 @@
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 #include "cores/AudioEngine/Utils/AEAudioFormat.h"
 #include "cores/AudioEngine/Utils/AELimiter.h"
+#include "cores/AudioEngine/Utils/AERingBuffer.h"
 #include "threads/Event.h"
 
 #include <atomic>
@@ -138,6 +139,11 @@ protected:
   void IncFreeBuffers();
   void DecFreeBuffers();
   void ResetFreeBuffers();
+  bool PopFreeBuffer(CSampleBuffer *&buffer);
+  void PushSample(CSampleBuffer *buffer);
+  void PushFreeBuffer(CSampleBuffer *buffer);
+  bool PopSample(CSampleBuffer *&buffer);
+  void ResetRings();
   void InitRemapper();
   void RemapBuffer();
   double CalcResampleRatio(double error);
@@ -197,7 +203,7 @@ protected:
   bool m_streamDraining;
   bool m_streamDrained;
   bool m_streamFading;
-  int m_streamFreeBuffers;
+  std::atomic_int m_streamFreeBuffers;
   bool m_streamIsBuffering;
   bool m_streamIsFlushed;
   IAEStream *m_streamSlave;
@@ -218,6 +224,13 @@ protected:
   std::deque<CSampleBuffer*> m_processingSamples;
   CActiveAEDataProtocol *m_streamPort;
   CEvent m_inMsgEvent;
+
+  // buffers handed between the writing thread and the engine for every period,
+  // free ones engine -> stream, filled ones stream -> engine. Both rings hold
+  // at most MAX_RING_BUFFERS pointers, the engine never has more outstanding.
+  static constexpr unsigned int MAX_RING_BUFFERS = 256;
+  AERingBuffer m_freeRing;
+  AERingBuffer m_sampleRing;
   bool m_drain;
   bool m_paused;
   bool m_started;
@@ -0,0 +1,277 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAEMixer.h"
+#include "cores/AudioEngine/Utils/AELimiter.h"
+#include "cores/AudioEngine/Utils/AEMixKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ActiveAE;
+
+namespace
+{
+const int CHANNELS = 8;
+
+struct Stream
+{
+  Stream(int frames, int planes, float range, unsigned int seed) : planes(planes)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(-range, range);
+    samples.resize(planes, std::vector<float>(frames * CHANNELS / planes));
+    for (auto& plane : samples)
+      for (auto& sample : plane)
+        sample = dist(gen);
+    Update();
+  }
+
+  Stream(const Stream& other)
+    : samples(other.samples), planes(other.planes), volume(other.volume),
+      fadingSamples(other.fadingSamples)
+  {
+    Update();
+  }
+
+  void Update()
+  {
+    pointers.clear();
+    for (auto& plane : samples)
+      pointers.push_back(plane.data());
+  }
+
+  CActiveAEMixer::Input Input()
+  {
+    CActiveAEMixer::Input input;
+    input.data = pointers.data();
+    input.planes = planes;
+    input.channels = CHANNELS;
+    input.volume = &volume;
+    input.fadingSamples = &fadingSamples;
+    return input;
+  }
+
+  std::vector<std::vector<float>> samples;
+  std::vector<float*> pointers;
+  int planes;
+  float volume = 1.0f;
+  int fadingSamples = 0;
+};
+
+/*!
+ * The mix stage as RunStages did it before the fused mixer: every stream
+ * walks the whole output once, a per frame gain is applied with one kernel
+ * call per frame, and the output is walked once more for clamping.
+ */
+void SequentialMix(const AEMixKernels& kernels,
+                   std::vector<CActiveAEMixer::Input>& inputs,
+                   int frames)
+{
+  const CActiveAEMixer::Input& out = inputs.front();
+  bool needClamp = false;
+  for (size_t s = 0; s < inputs.size(); s++)
+  {
+    CActiveAEMixer::Input& input = inputs[s];
+    int nb_floats = frames * input.channels / input.planes;
+    int nb_loops = 1;
+    if (input.limit || *input.fadingSamples > 0)
+    {
+      nb_floats = input.channels / input.planes;
+      nb_loops = frames;
+    }
+
+    for (int i = 0; i < nb_loops; i++)
+    {
+      if (*input.fadingSamples > 0)
+      {
+        *input.volume += input.fadingStep;
+        (*input.fadingSamples)--;
+      }
+
+      float volume = *input.volume * input.rgain;
+      if (nb_loops > 1 && input.limiter)
+        volume *= input.limiter->Run(input.data, input.channels, i * nb_floats, input.planes > 1);
+
+      for (int j = 0; j < out.planes && j < input.planes; j++)
+      {
+        if (s == 0)
+          kernels.MulArray(out.data[j] + i * nb_floats, volume, nb_floats);
+        else if (kernels.MulAddArray(out.data[j] + i * nb_floats, input.data[j] + i * nb_floats,
+                                     volume, nb_floats) > 1.0f)
+          needClamp = true;
+      }
+    }
+  }
+
+  if (needClamp)
+  {
+    for (int j = 0; j < out.planes; j++)
+      kernels.ClampArray(out.data[j], frames * out.channels / out.planes);
+  }
+}
+
+void ExpectEqual(const Stream& expected, const Stream& actual)
+{
+  for (size_t i = 0; i < expected.samples.size(); i++)
+  {
+    for (size_t j = 0; j < expected.samples[i].size(); j++)
+      ASSERT_NEAR(expected.samples[i][j], actual.samples[i][j], 1e-5f) << "plane " << i << " " << j;
+  }
+}
+
+class TestActiveAEMixer : public ::testing::TestWithParam<int>
+{
+};
+} // namespace
+
+TEST_P(TestActiveAEMixer, MatchesSequentialMix)
+{
+  const AEMixKernels& kernels = *CAEMixKernels::GetVariant(CAEMixKernels::VARIANT_C);
+  const int planes = GetParam();
+  // not a multiple of the block size
+  const int frames = 1000;
+
+  // low enough to never need clamping, that is done per block now
+  for (int count : {1, 2, 3, 8})
+  {
+    std::vector<Stream> expected;
+    for (int i = 0; i < count; i++)
+    {
+      expected.emplace_back(frames, planes, 0.1f, i + 1);
+      expected.back().volume = 0.5f + 0.1f * i;
+    }
+    std::vector<Stream> actual(expected);
+
+    std::vector<CActiveAEMixer::Input> expectedInputs;
+    std::vector<CActiveAEMixer::Input> actualInputs;
+    for (int i = 0; i < count; i++)
+    {
+      expectedInputs.push_back(expected[i].Input());
+      actualInputs.push_back(actual[i].Input());
+    }
+
+    SequentialMix(kernels, expectedInputs, frames);
+    CActiveAEMixer::Mix(kernels, actualInputs, frames);
+    ExpectEqual(expected.front(), actual.front());
+  }
+}
+
+TEST_P(TestActiveAEMixer, FadingAndLimiter)
+{
+  const AEMixKernels& kernels = *CAEMixKernels::GetVariant(CAEMixKernels::VARIANT_C);
+  const int planes = GetParam();
+  const int frames = 700;
+
+  // the limiter never kicks in for these levels, it only forces the per frame path
+  std::vector<Stream> expected;
+  expected.emplace_back(frames, planes, 0.4f, 1);
+  expected.emplace_back(frames, planes, 0.4f, 2);
+  expected[1].volume = 0.0f;
+  expected[1].fadingSamples = 500;
+  std::vector<Stream> actual(expected);
+
+  CAELimiter expectedLimiter;
+  CAELimiter actualLimiter;
+  std::vector<CActiveAEMixer::Input> expectedInputs = {expected[0].Input(), expected[1].Input()};
+  std::vector<CActiveAEMixer::Input> actualInputs = {actual[0].Input(), actual[1].Input()};
+  expectedInputs[0].limit = actualInputs[0].limit = true;
+  expectedInputs[0].limiter = &expectedLimiter;
+  actualInputs[0].limiter = &actualLimiter;
+  expectedInputs[1].fadingStep = actualInputs[1].fadingStep = 1.0f / 500;
+
+  SequentialMix(kernels, expectedInputs, frames);
+  CActiveAEMixer::Mix(kernels, actualInputs, frames);
+
+  ExpectEqual(expected.front(), actual.front());
+  EXPECT_EQ(0, actual[1].fadingSamples);
+  EXPECT_NEAR(expected[1].volume, actual[1].volume, 1e-5f);
+  EXPECT_NEAR(1.0f, actual[1].volume, 1e-3f);
+}
+
+TEST_P(TestActiveAEMixer, ClampsOnlyBlocksWithOvers)
+{
+  const AEMixKernels& kernels = *CAEMixKernels::GetVariant(CAEMixKernels::VARIANT_C);
+  const int planes = GetParam();
+  const int frames = 2 * CActiveAEMixer::BLOCK_FRAMES;
+  const int stride = CHANNELS / planes;
+
+  std::vector<Stream> streams;
+  streams.emplace_back(frames, planes, 0.2f, 1);
+  streams.emplace_back(frames, planes, 0.2f, 2);
+  // one over in the second block
+  streams[1].samples[0][CActiveAEMixer::BLOCK_FRAMES * stride] = 1.5f;
+  std::vector<float> first = streams[0].samples[0];
+  std::vector<float> second = streams[1].samples[0];
+
+  std::vector<CActiveAEMixer::Input> inputs = {streams[0].Input(), streams[1].Input()};
+  CActiveAEMixer::Mix(kernels, inputs, frames);
+
+  const std::vector<float>& out = streams[0].samples[0];
+  for (int i = 0; i < CActiveAEMixer::BLOCK_FRAMES * stride; i++)
+    ASSERT_FLOAT_EQ(first[i] + second[i], out[i]);
+  for (int i = CActiveAEMixer::BLOCK_FRAMES * stride; i < frames * stride; i++)
+    ASSERT_LE(std::abs(out[i]), 1.0f);
+}
+
+TEST_P(TestActiveAEMixer, Throughput)
+{
+  // a 7.1 period at 48kHz of the default engine buffer size
+  const AEMixKernels& kernels = CAEMixKernels::Get();
+  const int planes = GetParam();
+  const int frames = 1024;
+  const int iterations = 500;
+
+  for (int count : {1, 2, 4, 8})
+  {
+    // the output is silenced and refilled by the other streams on every
+    // iteration, one of them needs the per frame limiter
+    std::vector<Stream> streams;
+    for (int i = 0; i < count; i++)
+    {
+      streams.emplace_back(frames, planes, 0.5f, i + 1);
+      streams.back().volume = i ? 1.0f / count : 0.0f;
+    }
+
+    std::vector<CActiveAEMixer::Input> inputs;
+    for (auto& stream : streams)
+    {
+      inputs.push_back(stream.Input());
+      inputs.back().limit = count > 1 && &stream == &streams.back();
+    }
+
+    double ns[2];
+    for (int fused = 0; fused < 2; fused++)
+    {
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < iterations; i++)
+      {
+        if (fused)
+          CActiveAEMixer::Mix(kernels, inputs, frames);
+        else
+          SequentialMix(kernels, inputs, frames);
+      }
+      ns[fused] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+                      .count() /
+                  iterations;
+    }
+
+    const std::string name = std::to_string(count) + "_streams";
+    RecordProperty(name + "_sequential_ns", static_cast<int>(ns[0]));
+    RecordProperty(name + "_fused_ns", static_cast<int>(ns[1]));
+    EXPECT_GT(ns[1], 0.0);
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(InterleavedAndPlanar, TestActiveAEMixer, ::testing::Values(1, CHANNELS));
@@ -0,0 +1,313 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AESinkNULL.h"
+
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/EndianSwap.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+const unsigned int NULL_PERIODS = 4;
+const unsigned int NULL_PERIOD_MS = 20;
+
+const uint16_t WAVE_FORMAT_PCM = 1;
+const uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+const unsigned int WAV_HEADER_SIZE = 44;
+
+void PutLE16(uint8_t* dst, uint16_t value)
+{
+  value = Endian_SwapLE16(value);
+  memcpy(dst, &value, sizeof(value));
+}
+
+void PutLE32(uint8_t* dst, uint32_t value)
+{
+  value = Endian_SwapLE32(value);
+  memcpy(dst, &value, sizeof(value));
+}
+} // namespace
+
+CAESinkNULL::CAESinkNULL() = default;
+
+CAESinkNULL::~CAESinkNULL()
+{
+  Deinitialize();
+}
+
+void CAESinkNULL::Register()
+{
+  AE::AESinkRegEntry entry;
+  entry.sinkName = "NULL";
+  entry.createFunc = CAESinkNULL::Create;
+  entry.enumerateFunc = CAESinkNULL::EnumerateDevicesEx;
+  AE::CAESinkFactory::RegisterSink(entry);
+}
+
+IAESink* CAESinkNULL::Create(std::string &device, AEAudioFormat &desiredFormat)
+{
+  IAESink* sink = new CAESinkNULL();
+  if (sink->Initialize(desiredFormat, device))
+    return sink;
+
+  delete sink;
+  return nullptr;
+}
+
+bool CAESinkNULL::Initialize(AEAudioFormat &format, std::string &device)
+{
+  m_realtime = !StringUtils::EqualsNoCase(device, "fast");
+
+  if (format.m_dataFormat == AE_FMT_RAW)
+  {
+    // iec packed by the engine, this is what goes over the wire
+    format.m_dataFormat = AE_FMT_S16NE;
+  }
+  else if (format.m_dataFormat != AE_FMT_S16NE && format.m_dataFormat != AE_FMT_S32NE &&
+           format.m_dataFormat != AE_FMT_FLOAT)
+  {
+    format.m_dataFormat = AE_FMT_FLOAT;
+  }
+
+  if (format.m_sampleRate < 8000 || format.m_sampleRate > 384000)
+    format.m_sampleRate = 48000;
+
+  if (!format.m_channelLayout.Count())
+    format.m_channelLayout = AE_CH_LAYOUT_2_0;
+
+  format.m_frameSize = format.m_channelLayout.Count() *
+                       (CAEUtil::DataFormatToBits(format.m_dataFormat) >> 3);
+  format.m_frames = format.m_sampleRate * NULL_PERIOD_MS / 1000;
+
+  m_format = format;
+  m_bufferFrames = format.m_frames * NULL_PERIODS;
+  m_played = m_written = m_totalFrames = 0;
+  m_playStart = 0;
+  m_underruns = 0;
+  m_initTick = CurrentHostCounter();
+
+  const char* wavPath = getenv("KODI_AE_NULL_WAV");
+  if (wavPath && *wavPath && !OpenWav(wavPath))
+    CLog::Log(LOGERROR, "CAESinkNULL::Initialize - failed to open %s", wavPath);
+
+  CLog::Log(LOGINFO, "CAESinkNULL::Initialize - %s, %u frames buffer",
+            m_realtime ? "realtime" : "fast", m_bufferFrames);
+
+  return true;
+}
+
+void CAESinkNULL::Deinitialize()
+{
+  if (!m_initTick)
+    return;
+
+  const double elapsed = (double)(CurrentHostCounter() - m_initTick) / CurrentHostFrequency();
+  const double played = m_format.m_sampleRate ? (double)m_totalFrames / m_format.m_sampleRate : 0.0;
+  CLog::Log(LOGINFO,
+            "CAESinkNULL::Deinitialize - played %.2f s in %.2f s (%.2fx realtime), %u underruns",
+            played, elapsed, elapsed > 0.0 ? played / elapsed : 0.0, m_underruns);
+
+  CloseWav();
+  m_initTick = 0;
+}
+
+void CAESinkNULL::Play(int64_t now)
+{
+  if (!m_playStart)
+    return;
+
+  const uint64_t frames = static_cast<uint64_t>((double)(now - m_playStart) *
+                                                m_format.m_sampleRate / CurrentHostFrequency());
+  m_played = std::min(frames, m_written);
+}
+
+void CAESinkNULL::GetDelay(AEDelayStatus& status)
+{
+  if (!m_realtime)
+  {
+    status.SetDelay(0);
+    return;
+  }
+
+  Play(CurrentHostCounter());
+  status.SetDelay((double)(m_written - m_played) / m_format.m_sampleRate);
+}
+
+double CAESinkNULL::GetCacheTotal()
+{
+  if (!m_realtime)
+    return 0.0;
+
+  return (double)m_bufferFrames / m_format.m_sampleRate;
+}
+
+unsigned int CAESinkNULL::AddPackets(uint8_t **data, unsigned int frames, unsigned int offset)
+{
+  if (!frames)
+    return 0;
+
+  if (m_realtime)
+  {
+    int64_t now = CurrentHostCounter();
+    Play(now);
+
+    if (m_playStart && m_played == m_written)
+    {
+      // ran dry, a device would have played silence since
+      m_underruns++;
+      CLog::Log(LOGWARNING, "CAESinkNULL::AddPackets - underrun");
+      m_playStart = 0;
+    }
+
+    if (!m_playStart)
+    {
+      m_playStart = now;
+      m_played = m_written = 0;
+    }
+
+    // block like a device would until at least part of the packet fits
+    while (m_written - m_played >= m_bufferFrames)
+    {
+      const unsigned int wait = std::min(frames, m_format.m_frames);
+      std::this_thread::sleep_for(
+          std::chrono::microseconds(static_cast<int64_t>(wait) * 1000000 / m_format.m_sampleRate));
+      Play(CurrentHostCounter());
+    }
+
+    frames = std::min<unsigned int>(frames, m_bufferFrames - (m_written - m_played));
+  }
+
+  if (m_wavOpen)
+  {
+    const unsigned int size = frames * m_format.m_frameSize;
+    if (m_wavFile.Write(data[0] + offset * m_format.m_frameSize, size) == static_cast<ssize_t>(size))
+      m_wavDataSize += size;
+  }
+
+  m_written += frames;
+  m_totalFrames += frames;
+  return frames;
+}
+
+void CAESinkNULL::Drain()
+{
+  if (!m_realtime || !m_playStart)
+    return;
+
+  Play(CurrentHostCounter());
+  const uint64_t buffered = m_written - m_played;
+  std::this_thread::sleep_for(
+      std::chrono::microseconds(static_cast<int64_t>(buffered) * 1000000 / m_format.m_sampleRate));
+
+  m_playStart = 0;
+  m_played = m_written = 0;
+}
+
+bool CAESinkNULL::OpenWav(const std::string& path)
+{
+  uint16_t tag = WAVE_FORMAT_PCM;
+  if (m_format.m_dataFormat == AE_FMT_FLOAT)
+    tag = WAVE_FORMAT_IEEE_FLOAT;
+
+  const uint16_t channels = m_format.m_channelLayout.Count();
+  const uint16_t bits = CAEUtil::DataFormatToBits(m_format.m_dataFormat);
+
+  // sizes are patched when the file is closed
+  uint8_t header[WAV_HEADER_SIZE];
+  memcpy(header, "RIFF", 4);
+  PutLE32(header + 4, WAV_HEADER_SIZE - 8);
+  memcpy(header + 8, "WAVEfmt ", 8);
+  PutLE32(header + 16, 16);
+  PutLE16(header + 20, tag);
+  PutLE16(header + 22, channels);
+  PutLE32(header + 24, m_format.m_sampleRate);
+  PutLE32(header + 28, m_format.m_sampleRate * m_format.m_frameSize);
+  PutLE16(header + 32, m_format.m_frameSize);
+  PutLE16(header + 34, bits);
+  memcpy(header + 36, "data", 4);
+  PutLE32(header + 40, 0);
+
+  if (!m_wavFile.OpenForWrite(path, true))
+    return false;
+
+  if (m_wavFile.Write(header, sizeof(header)) != static_cast<ssize_t>(sizeof(header)))
+  {
+    m_wavFile.Close();
+    return false;
+  }
+
+  m_wavOpen = true;
+  m_wavDataSize = 0;
+  return true;
+}
+
+void CAESinkNULL::CloseWav()
+{
+  if (!m_wavOpen)
+    return;
+
+  uint8_t size[4];
+  PutLE32(size, m_wavDataSize + WAV_HEADER_SIZE - 8);
+  m_wavFile.Seek(4, SEEK_SET);
+  m_wavFile.Write(size, sizeof(size));
+
+  PutLE32(size, m_wavDataSize);
+  m_wavFile.Seek(40, SEEK_SET);
+  m_wavFile.Write(size, sizeof(size));
+
+  m_wavFile.Close();
+  m_wavOpen = false;
+}
+
+void CAESinkNULL::EnumerateDevicesEx(AEDeviceInfoList &list, bool force)
+{
+  static const struct
+  {
+    const char* name;
+    const char* displayName;
+  } devices[] = {{"realtime", "Benchmark (realtime)"}, {"fast", "Benchmark (as fast as possible)"}};
+
+  for (const auto& device : devices)
+  {
+    CAEDeviceInfo info;
+    info.m_deviceName = device.name;
+    info.m_displayName = device.displayName;
+    info.m_deviceType = AE_DEVTYPE_HDMI;
+    info.m_wantsIECPassthrough = true;
+    info.m_channels = AE_CH_LAYOUT_7_1;
+
+    info.m_sampleRates = {32000, 44100, 48000, 88200, 96000, 176400, 192000};
+
+    info.m_dataFormats.push_back(AE_FMT_FLOAT);
+    info.m_dataFormats.push_back(AE_FMT_S32NE);
+    info.m_dataFormats.push_back(AE_FMT_S16NE);
+    info.m_dataFormats.push_back(AE_FMT_RAW);
+
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_AC3);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_EAC3);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTSHD_CORE);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTS_2048);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTS_1024);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTS_512);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTSHD);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTSHD_MA);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_TRUEHD);
+
+    list.push_back(info);
+  }
+}
@@ -0,0 +1,74 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Interfaces/AESink.h"
+#include "cores/AudioEngine/Utils/AEDeviceInfo.h"
+#include "filesystem/File.h"
+
+#include <stdint.h>
+#include <string>
+
+/*!
+ * \brief Sink without an audio device, for benchmarking the engine
+ *
+ * The "realtime" device consumes samples at the pace of a hardware device
+ * with a buffer of a few periods, it blocks when that buffer is full and
+ * counts an underrun whenever the buffer ran dry before it got refilled.
+ * The "fast" device consumes everything as soon as it is added.
+ *
+ * If the environment variable KODI_AE_NULL_WAV holds a path, everything
+ * that was played is also written to that file as WAV. Passthrough is
+ * written IEC 61937 packed, like it would go out over S/PDIF or HDMI.
+ *
+ * Select it with KODI_AE_SINK=NULL.
+ */
+class CAESinkNULL : public IAESink
+{
+public:
+  const char *GetName() override { return "NULL"; }
+
+  CAESinkNULL();
+  ~CAESinkNULL() override;
+
+  static void Register();
+  static IAESink* Create(std::string &device, AEAudioFormat &desiredFormat);
+  static void EnumerateDevicesEx(AEDeviceInfoList &list, bool force = false);
+
+  bool Initialize(AEAudioFormat &format, std::string &device) override;
+  void Deinitialize() override;
+
+  void GetDelay(AEDelayStatus& status) override;
+  double GetCacheTotal() override;
+  unsigned int AddPackets(uint8_t **data, unsigned int frames, unsigned int offset) override;
+  void Drain() override;
+
+  unsigned int GetUnderruns() const { return m_underruns; }
+
+private:
+  //! advance the simulated playback position to now
+  void Play(int64_t now);
+  bool OpenWav(const std::string& path);
+  void CloseWav();
+
+  AEAudioFormat m_format;
+  bool m_realtime = true;
+  unsigned int m_bufferFrames = 0;
+
+  int64_t m_playStart = 0;
+  uint64_t m_played = 0;
+  uint64_t m_written = 0;
+  uint64_t m_totalFrames = 0;
+  unsigned int m_underruns = 0;
+  int64_t m_initTick = 0;
+
+  XFILE::CFile m_wavFile;
+  bool m_wavOpen = false;
+  uint32_t m_wavDataSize = 0;
+};
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+AEAudioFormat StereoFloat()
+{
+  AEAudioFormat format;
+  format.m_dataFormat = AE_FMT_FLOAT;
+  format.m_sampleRate = 48000;
+  format.m_channelLayout = AE_CH_LAYOUT_2_0;
+  return format;
+}
+} // namespace
+
+TEST(TestAESinkNULL, Fast)
+{
+  CAESinkNULL sink;
+  AEAudioFormat format = StereoFloat();
+  std::string device = "fast";
+  ASSERT_TRUE(sink.Initialize(format, device));
+  EXPECT_EQ(8u, format.m_frameSize);
+
+  // ten seconds of audio are gone at once
+  std::vector<uint8_t> buffer(format.m_frames * format.m_frameSize);
+  uint8_t* data = buffer.data();
+  for (unsigned int i = 0; i < 10 * 48000 / format.m_frames; i++)
+    EXPECT_EQ(format.m_frames, sink.AddPackets(&data, format.m_frames, 0));
+
+  AEDelayStatus status;
+  sink.GetDelay(status);
+  EXPECT_EQ(0.0, status.delay);
+  EXPECT_EQ(0u, sink.GetUnderruns());
+  sink.Deinitialize();
+}
+
+TEST(TestAESinkNULL, Realtime)
+{
+  CAESinkNULL sink;
+  AEAudioFormat format = StereoFloat();
+  std::string device = "realtime";
+  ASSERT_TRUE(sink.Initialize(format, device));
+
+  std::vector<uint8_t> buffer(format.m_frames * format.m_frameSize);
+  uint8_t* data = buffer.data();
+  const double cacheTotal = sink.GetCacheTotal();
+  ASSERT_GT(cacheTotal, 0.0);
+
+  // the buffer fills up, then the sink blocks like a device would
+  auto start = std::chrono::steady_clock::now();
+  unsigned int written = 0;
+  while (written < 48000 / 4)
+    written += sink.AddPackets(&data, format.m_frames, 0);
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_GE(elapsed, 0.25 - cacheTotal - 0.01);
+
+  AEDelayStatus status;
+  sink.GetDelay(status);
+  EXPECT_GT(status.delay, 0.0);
+  EXPECT_LE(status.delay, cacheTotal);
+  EXPECT_EQ(0u, sink.GetUnderruns());
+
+  // let it run dry
+  std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<int>(cacheTotal * 1000) + 20));
+  sink.GetDelay(status);
+  EXPECT_EQ(0.0, status.delay);
+  sink.AddPackets(&data, format.m_frames, 0);
+  EXPECT_EQ(1u, sink.GetUnderruns());
+
+  // draining does not count as an underrun
+  sink.Drain();
+  sink.AddPackets(&data, format.m_frames, 0);
+  EXPECT_EQ(1u, sink.GetUnderruns());
+  sink.Deinitialize();
+}
+
+TEST(TestAESinkNULL, Passthrough)
+{
+  CAESinkNULL sink;
+  AEAudioFormat format;
+  format.m_dataFormat = AE_FMT_RAW;
+  format.m_sampleRate = 192000;
+  format.m_channelLayout = AE_CH_LAYOUT_7_1;
+  std::string device = "realtime";
+  ASSERT_TRUE(sink.Initialize(format, device));
+
+  // iec packed frames go out as 16 bit
+  EXPECT_EQ(AE_FMT_S16NE, format.m_dataFormat);
+  EXPECT_EQ(192000u, format.m_sampleRate);
+  EXPECT_EQ(16u, format.m_frameSize);
+  sink.Deinitialize();
+}
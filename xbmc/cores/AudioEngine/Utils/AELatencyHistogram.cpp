@@ -0,0 +1,94 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AELatencyHistogram.h"
+
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
+
+namespace
+{
+int BucketIndex(uint64_t usec)
+{
+  int index = 0;
+  while (usec && index < CAELatencyHistogram::BUCKETS - 1)
+  {
+    usec >>= 1;
+    index++;
+  }
+  return index;
+}
+} // namespace
+
+CAELatencyHistogram::CAELatencyHistogram()
+{
+  Reset();
+}
+
+void CAELatencyHistogram::Add(uint64_t usec)
+{
+  m_buckets[BucketIndex(usec)].fetch_add(1, std::memory_order_relaxed);
+  m_count.fetch_add(1, std::memory_order_relaxed);
+  if (usec > m_max.load(std::memory_order_relaxed))
+    m_max.store(usec, std::memory_order_relaxed);
+}
+
+void CAELatencyHistogram::AddElapsed(int64_t start)
+{
+  const int64_t elapsed = CurrentHostCounter() - start;
+  Add(elapsed > 0 ? elapsed * 1000000 / CurrentHostFrequency() : 0);
+}
+
+void CAELatencyHistogram::Reset()
+{
+  for (auto& bucket : m_buckets)
+    bucket.store(0, std::memory_order_relaxed);
+  m_count.store(0, std::memory_order_relaxed);
+  m_max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t CAELatencyHistogram::GetCount() const
+{
+  return m_count.load(std::memory_order_relaxed);
+}
+
+uint64_t CAELatencyHistogram::GetMax() const
+{
+  return m_max.load(std::memory_order_relaxed);
+}
+
+uint64_t CAELatencyHistogram::GetPercentile(double percentile) const
+{
+  uint32_t counts[BUCKETS];
+  uint64_t total = 0;
+  for (int i = 0; i < BUCKETS; i++)
+  {
+    counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+
+  if (total == 0)
+    return 0;
+
+  percentile = std::max(0.0, std::min(percentile, 100.0));
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(total * percentile / 100.0 + 0.5));
+
+  uint64_t seen = 0;
+  for (int i = 0; i < BUCKETS; i++)
+  {
+    seen += counts[i];
+    if (seen >= rank)
+    {
+      // the bucket bound overestimates, never report more than we have seen
+      const uint64_t bound = (i == 0) ? 0 : (UINT64_C(1) << i) - 1;
+      return std::min(bound, GetMax());
+    }
+  }
+  return GetMax();
+}
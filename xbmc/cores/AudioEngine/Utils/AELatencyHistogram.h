@@ -0,0 +1,51 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * Log2 bucketed histogram of durations in microseconds.
+ *
+ * Add() is cheap enough to be called for every period from the audio
+ * threads, it only does a few shifts and relaxed atomic updates. It must
+ * only be called from one thread, the getters may be called from any thread and
+ * return a consistent enough view for statistics.
+ */
+class CAELatencyHistogram
+{
+public:
+  //! bucket n holds values in [2^(n-1), 2^n) us, bucket 0 holds 0, the last one everything above
+  static constexpr int BUCKETS = 26;
+
+  CAELatencyHistogram();
+
+  void Add(uint64_t usec);
+
+  //! record the time passed since start, a CurrentHostCounter() value
+  void AddElapsed(int64_t start);
+
+  void Reset();
+
+  uint64_t GetCount() const;
+  uint64_t GetMax() const;
+
+  /*!
+   \brief upper bound of the bucket holding the given percentile
+   \param percentile 0.0 .. 100.0
+   \return the duration in us, 0 if nothing has been recorded
+   */
+  uint64_t GetPercentile(double percentile) const;
+
+private:
+  std::atomic<uint32_t> m_buckets[BUCKETS];
+  std::atomic<uint64_t> m_count;
+  std::atomic<uint64_t> m_max;
+};
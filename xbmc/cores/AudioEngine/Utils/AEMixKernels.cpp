@@ -0,0 +1,349 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AEMixKernels.h"
+
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(HAVE_SSE) && defined(__SSE__)
+#include <xmmintrin.h>
+#define AE_MIX_SSE 1
+#endif
+
+// the AVX kernels are built with a per function target so the rest of the
+// audio engine does not depend on AVX being enabled for the whole build
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define AE_MIX_AVX 1
+#define AE_MIX_AVX_TARGET __attribute__((target("avx")))
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#define AE_MIX_AVX 1
+#define AE_MIX_AVX_TARGET
+#endif
+
+#if defined(HAS_NEON)
+#include <arm_neon.h>
+#define AE_MIX_NEON 1
+#endif
+
+namespace
+{
+/*
+   This is a rational function to approximate a tanh-like soft clipper.
+   It is based on the pade-approximation of the tanh function with tweaked coefficients.
+   See: http://www.musicdsp.org/showone.php?id=238
+   The function reaches +-1.0 at +-3.0, so inputs are limited to that range first.
+*/
+const float CLAMP_LIMIT = 3.0f;
+const float CLAMP_C1 = 27.0f;
+const float CLAMP_C2 = 9.0f;
+
+inline float SoftClamp(float x)
+{
+  x = std::min(std::max(x, -CLAMP_LIMIT), CLAMP_LIMIT);
+  const float y = x * x;
+  return x * (CLAMP_C1 + y) / (CLAMP_C1 + CLAMP_C2 * y);
+}
+
+//------------------------------------------------------------------------------
+// plain C
+//------------------------------------------------------------------------------
+
+void MulArrayC(float* data, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] *= mul;
+}
+
+float MulAddArrayC(float* data, const float* add, float mul, uint32_t count)
+{
+  float peak = 0.0f;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    data[i] += add[i] * mul;
+    peak = std::max(peak, std::fabs(data[i]));
+  }
+  return peak;
+}
+
+void ClampArrayC(float* data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] = SoftClamp(data[i]);
+}
+
+const AEMixKernels kernelsC = {"C", MulArrayC, MulAddArrayC, ClampArrayC};
+
+//------------------------------------------------------------------------------
+// SSE
+//------------------------------------------------------------------------------
+
+#if defined(AE_MIX_SSE)
+inline __m128 AbsSSE(__m128 v)
+{
+  return _mm_andnot_ps(_mm_set_ps1(-0.0f), v);
+}
+
+inline float HorizontalMaxSSE(__m128 v)
+{
+  v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+  v = _mm_max_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(v);
+}
+
+void MulArraySSE(float* data, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set_ps1(mul);
+  const uint32_t even = count & ~0x3;
+
+  uint32_t i = 0;
+  for (; i < even; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+
+  MulArrayC(data + i, mul, count - i);
+}
+
+float MulAddArraySSE(float* data, const float* add, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set_ps1(mul);
+  const uint32_t even = count & ~0x3;
+  __m128 peak = _mm_setzero_ps();
+
+  uint32_t i = 0;
+  for (; i < even; i += 4)
+  {
+    const __m128 out = _mm_add_ps(_mm_loadu_ps(data + i), _mm_mul_ps(_mm_loadu_ps(add + i), m));
+    _mm_storeu_ps(data + i, out);
+    peak = _mm_max_ps(peak, AbsSSE(out));
+  }
+
+  return std::max(HorizontalMaxSSE(peak), MulAddArrayC(data + i, add + i, mul, count - i));
+}
+
+void ClampArraySSE(float* data, uint32_t count)
+{
+  const __m128 c1 = _mm_set_ps1(CLAMP_C1);
+  const __m128 c2 = _mm_set_ps1(CLAMP_C2);
+  const __m128 hi = _mm_set_ps1(CLAMP_LIMIT);
+  const __m128 lo = _mm_set_ps1(-CLAMP_LIMIT);
+  const uint32_t even = count & ~0x3;
+
+  uint32_t i = 0;
+  for (; i < even; i += 4)
+  {
+    const __m128 x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), lo), hi);
+    const __m128 y = _mm_mul_ps(x, x);
+    _mm_storeu_ps(data + i, _mm_div_ps(_mm_mul_ps(x, _mm_add_ps(c1, y)),
+                                       _mm_add_ps(c1, _mm_mul_ps(c2, y))));
+  }
+
+  ClampArrayC(data + i, count - i);
+}
+
+const AEMixKernels kernelsSSE = {"SSE", MulArraySSE, MulAddArraySSE, ClampArraySSE};
+#endif
+
+//------------------------------------------------------------------------------
+// AVX
+//------------------------------------------------------------------------------
+
+#if defined(AE_MIX_AVX)
+AE_MIX_AVX_TARGET void MulArrayAVX(float* data, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  const uint32_t even = count & ~0x7;
+
+  uint32_t i = 0;
+  for (; i < even; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+
+  MulArrayC(data + i, mul, count - i);
+}
+
+AE_MIX_AVX_TARGET float MulAddArrayAVX(float* data, const float* add, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  const __m256 signMask = _mm256_set1_ps(-0.0f);
+  const uint32_t even = count & ~0x7;
+  __m256 peak = _mm256_setzero_ps();
+
+  uint32_t i = 0;
+  for (; i < even; i += 8)
+  {
+    const __m256 out =
+        _mm256_add_ps(_mm256_loadu_ps(data + i), _mm256_mul_ps(_mm256_loadu_ps(add + i), m));
+    _mm256_storeu_ps(data + i, out);
+    peak = _mm256_max_ps(peak, _mm256_andnot_ps(signMask, out));
+  }
+
+  __m128 peak4 = _mm_max_ps(_mm256_castps256_ps128(peak), _mm256_extractf128_ps(peak, 1));
+  peak4 = _mm_max_ps(peak4, _mm_movehl_ps(peak4, peak4));
+  peak4 = _mm_max_ss(peak4, _mm_shuffle_ps(peak4, peak4, _MM_SHUFFLE(1, 1, 1, 1)));
+
+  // avoid AVX/SSE transition penalties before returning to non-AVX code
+  const float result = _mm_cvtss_f32(peak4);
+  _mm256_zeroupper();
+
+  return std::max(result, MulAddArrayC(data + i, add + i, mul, count - i));
+}
+
+AE_MIX_AVX_TARGET void ClampArrayAVX(float* data, uint32_t count)
+{
+  const __m256 c1 = _mm256_set1_ps(CLAMP_C1);
+  const __m256 c2 = _mm256_set1_ps(CLAMP_C2);
+  const __m256 hi = _mm256_set1_ps(CLAMP_LIMIT);
+  const __m256 lo = _mm256_set1_ps(-CLAMP_LIMIT);
+  const uint32_t even = count & ~0x7;
+
+  uint32_t i = 0;
+  for (; i < even; i += 8)
+  {
+    const __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data + i), lo), hi);
+    const __m256 y = _mm256_mul_ps(x, x);
+    _mm256_storeu_ps(data + i, _mm256_div_ps(_mm256_mul_ps(x, _mm256_add_ps(c1, y)),
+                                             _mm256_add_ps(c1, _mm256_mul_ps(c2, y))));
+  }
+  _mm256_zeroupper();
+
+  ClampArrayC(data + i, count - i);
+}
+
+const AEMixKernels kernelsAVX = {"AVX", MulArrayAVX, MulAddArrayAVX, ClampArrayAVX};
+#endif
+
+//------------------------------------------------------------------------------
+// NEON
+//------------------------------------------------------------------------------
+
+#if defined(AE_MIX_NEON)
+inline float HorizontalMaxNEON(float32x4_t v)
+{
+#if defined(__aarch64__)
+  return vmaxvq_f32(v);
+#else
+  float32x2_t m = vpmax_f32(vget_low_f32(v), vget_high_f32(v));
+  m = vpmax_f32(m, m);
+  return vget_lane_f32(m, 0);
+#endif
+}
+
+void MulArrayNEON(float* data, float mul, uint32_t count)
+{
+  const uint32_t even = count & ~0x3;
+
+  uint32_t i = 0;
+  for (; i < even; i += 4)
+    vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), mul));
+
+  MulArrayC(data + i, mul, count - i);
+}
+
+float MulAddArrayNEON(float* data, const float* add, float mul, uint32_t count)
+{
+  const float32x4_t m = vdupq_n_f32(mul);
+  const uint32_t even = count & ~0x3;
+  float32x4_t peak = vdupq_n_f32(0.0f);
+
+  uint32_t i = 0;
+  for (; i < even; i += 4)
+  {
+    const float32x4_t out = vaddq_f32(vld1q_f32(data + i), vmulq_f32(vld1q_f32(add + i), m));
+    vst1q_f32(data + i, out);
+    peak = vmaxq_f32(peak, vabsq_f32(out));
+  }
+
+  return std::max(HorizontalMaxNEON(peak), MulAddArrayC(data + i, add + i, mul, count - i));
+}
+
+void ClampArrayNEON(float* data, uint32_t count)
+{
+  const float32x4_t c1 = vdupq_n_f32(CLAMP_C1);
+  const float32x4_t hi = vdupq_n_f32(CLAMP_LIMIT);
+  const float32x4_t lo = vdupq_n_f32(-CLAMP_LIMIT);
+  const uint32_t even = count & ~0x3;
+
+  uint32_t i = 0;
+  for (; i < even; i += 4)
+  {
+    const float32x4_t x = vminq_f32(vmaxq_f32(vld1q_f32(data + i), lo), hi);
+    const float32x4_t y = vmulq_f32(x, x);
+    const float32x4_t num = vmulq_f32(x, vaddq_f32(c1, y));
+    const float32x4_t den = vmlaq_n_f32(c1, y, CLAMP_C2);
+#if defined(__aarch64__)
+    vst1q_f32(data + i, vdivq_f32(num, den));
+#else
+    // no division on armv7, refine the reciprocal estimate with two newton-raphson steps
+    float32x4_t rcp = vrecpeq_f32(den);
+    rcp = vmulq_f32(vrecpsq_f32(den, rcp), rcp);
+    rcp = vmulq_f32(vrecpsq_f32(den, rcp), rcp);
+    vst1q_f32(data + i, vmulq_f32(num, rcp));
+#endif
+  }
+
+  ClampArrayC(data + i, count - i);
+}
+
+const AEMixKernels kernelsNEON = {"NEON", MulArrayNEON, MulAddArrayNEON, ClampArrayNEON};
+#endif
+
+} // namespace
+
+#if defined(AE_MIX_SSE)
+const AEMixKernels* CAEMixKernels::m_active = &kernelsSSE;
+#else
+const AEMixKernels* CAEMixKernels::m_active = &kernelsC;
+#endif
+
+void CAEMixKernels::Select(unsigned int cpuFeatures)
+{
+  const AEMixKernels* kernels = &kernelsC;
+
+#if defined(AE_MIX_SSE)
+  if (cpuFeatures & CPU_FEATURE_SSE)
+    kernels = &kernelsSSE;
+#endif
+#if defined(AE_MIX_AVX)
+  if (cpuFeatures & CPU_FEATURE_AVX)
+    kernels = &kernelsAVX;
+#endif
+#if defined(AE_MIX_NEON)
+  if (cpuFeatures & CPU_FEATURE_NEON)
+    kernels = &kernelsNEON;
+#endif
+
+  m_active = kernels;
+  CLog::Log(LOGINFO, "CAEMixKernels::%s - using %s mix kernels", __FUNCTION__, kernels->name);
+}
+
+const AEMixKernels* CAEMixKernels::GetVariant(Variant variant)
+{
+  switch (variant)
+  {
+    case VARIANT_C:
+      return &kernelsC;
+#if defined(AE_MIX_SSE)
+    case VARIANT_SSE:
+      return &kernelsSSE;
+#endif
+#if defined(AE_MIX_AVX)
+    case VARIANT_AVX:
+      return &kernelsAVX;
+#endif
+#if defined(AE_MIX_NEON)
+    case VARIANT_NEON:
+      return &kernelsNEON;
+#endif
+    default:
+      return nullptr;
+  }
+}
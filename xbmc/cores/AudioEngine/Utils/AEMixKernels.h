@@ -0,0 +1,63 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*!
+ * \brief Table of float sample kernels used by ActiveAE for gain, mixing and clamping
+ *
+ * All kernels work on unaligned buffers of arbitrary length, aligned buffers
+ * just take the fast path for the whole array.
+ */
+struct AEMixKernels
+{
+  const char* name;
+
+  /*! \brief data[i] *= mul */
+  void (*MulArray)(float* data, float mul, uint32_t count);
+
+  /*! \brief data[i] += add[i] * mul
+   \return the largest absolute value of data after mixing, used to decide if clamping is needed
+   */
+  float (*MulAddArray)(float* data, const float* add, float mul, uint32_t count);
+
+  /*! \brief tanh-like soft clamp of data to [-1.0, 1.0] */
+  void (*ClampArray)(float* data, uint32_t count);
+};
+
+class CAEMixKernels
+{
+public:
+  enum Variant
+  {
+    VARIANT_C = 0,
+    VARIANT_SSE,
+    VARIANT_AVX,
+    VARIANT_NEON,
+    VARIANT_MAX
+  };
+
+  /*! \brief pick the fastest kernels supported by the given CCPUInfo feature mask
+   Must be called before any audio thread uses the kernels.
+   \param cpuFeatures mask of CpuFeature flags
+   */
+  static void Select(unsigned int cpuFeatures);
+
+  /*! \brief the kernels selected by Select(), plain C or SSE (if built with it) before that */
+  static const AEMixKernels& Get() { return *m_active; }
+
+  /*! \brief access a specific implementation, e.g. for testing
+   \return nullptr if the variant was not compiled in
+   */
+  static const AEMixKernels* GetVariant(Variant variant);
+
+private:
+  static const AEMixKernels* m_active;
+};
@@ -8,50 +8,44 @@
 
 #pragma once
 
-#define AE_RING_BUFFER_OK 0;
-#define AE_RING_BUFFER_EMPTY 1;
-#define AE_RING_BUFFER_FULL 2;
-#define AE_RING_BUFFER_NOTAVAILABLE 3;
+#define AE_RING_BUFFER_OK 0
+#define AE_RING_BUFFER_EMPTY 1
+#define AE_RING_BUFFER_FULL 2
+#define AE_RING_BUFFER_NOTAVAILABLE 3
 
 //#define AE_RING_BUFFER_DEBUG
 
 #include "utils/log.h"
 #include "utils/MemUtils.h"
 
+#include <atomic>
+
 #include <string.h>
 
 /**
  * This buffer can be used by one read and one write thread at any one time
  * without the risk of data corruption.
+ * Neither side ever blocks or takes a lock: the writer publishes data by a
+ * release store of the write counter, the reader frees space by a release
+ * store of the read counter. Each side keeps its own state on a separate
+ * cache line so a realtime reader (e.g. a CoreAudio callback) does not
+ * contend with the writer.
  * If you intend to call the Reset() method, please use Locks.
  * All other operations are thread-safe.
  */
 class AERingBuffer {
 
 public:
-  AERingBuffer() :
-    m_iReadPos(0),
-    m_iWritePos(0),
-    m_iRead(0),
-    m_iWritten(0),
-    m_iSize(0),
-    m_planes(0),
-    m_Buffer(NULL)
-  {
-  }
+  AERingBuffer() = default;
 
-  AERingBuffer(unsigned int size, unsigned int planes = 1) :
-    m_iReadPos(0),
-    m_iWritePos(0),
-    m_iRead(0),
-    m_iWritten(0),
-    m_iSize(0),
-    m_planes(0),
-    m_Buffer(NULL)
+  AERingBuffer(unsigned int size, unsigned int planes = 1)
   {
     Create(size, planes);
   }
 
+  AERingBuffer(const AERingBuffer&) = delete;
+  AERingBuffer& operator=(const AERingBuffer&) = delete;
+
   ~AERingBuffer()
   {
 #ifdef AE_RING_BUFFER_DEBUG
@@ -91,10 +85,12 @@ public:
 #ifdef AE_RING_BUFFER_DEBUG
     CLog::Log(LOGDEBUG, "AERingBuffer::Reset: Buffer reset.");
 #endif
-    m_iWritten = 0;
-    m_iRead = 0;
+    m_iWritten.store(0, std::memory_order_relaxed);
+    m_iRead.store(0, std::memory_order_relaxed);
     m_iReadPos = 0;
     m_iWritePos = 0;
+    m_iCachedRead = 0;
+    m_iCachedWritten = 0;
   }
 
   /**
@@ -105,7 +101,15 @@ public:
    */
   int Write(unsigned char *src, unsigned int size, unsigned int plane = 0)
   {
-    unsigned int space = GetWriteSize();
+    const unsigned int written = m_iWritten.load(std::memory_order_relaxed);
+    unsigned int space = m_iSize - (written - m_iCachedRead);
+
+    // only touch the reader's cache line if the cached view is too pessimistic
+    if (size > space)
+    {
+      m_iCachedRead = m_iRead.load(std::memory_order_acquire);
+      space = m_iSize - (written - m_iCachedRead);
+    }
 
     //do we have enough space for all the data?
     if (size > space || plane >= m_planes)
@@ -150,7 +154,15 @@ public:
    */
   int Read(unsigned char *dest, unsigned int size, unsigned int plane = 0)
   {
-    unsigned int space = GetReadSize();
+    const unsigned int read = m_iRead.load(std::memory_order_relaxed);
+    unsigned int space = m_iCachedWritten - read;
+
+    // only touch the writer's cache line if the cached view is too pessimistic
+    if (size > space || space == 0)
+    {
+      m_iCachedWritten = m_iWritten.load(std::memory_order_acquire);
+      space = m_iCachedWritten - read;
+    }
 
     //want to read more than we have written?
     if( space == 0 )
@@ -217,7 +229,7 @@ public:
       }
     }
     bufferContents[m_iSize*m_planes] = '\0';
-    CLog::Log(LOGDEBUG, "AERingBuffer::Dump()\n%s",bufferContents);
+    CLog::Log(LOGDEBUG, "AERingBuffer::Dump()\n%s", reinterpret_cast<const char*>(bufferContents));
     KODI::MEMORY::AlignedFree(bufferContents);
   }
 
@@ -227,7 +239,8 @@ public:
    */
   unsigned int GetWriteSize()
   {
-    return m_iSize - ( m_iWritten - m_iRead );
+    return m_iSize - (m_iWritten.load(std::memory_order_relaxed) -
+                      m_iRead.load(std::memory_order_acquire));
   }
 
   /**
@@ -236,7 +249,8 @@ public:
    */
   unsigned int GetReadSize()
   {
-    return m_iWritten - m_iRead;
+    return m_iWritten.load(std::memory_order_acquire) -
+           m_iRead.load(std::memory_order_relaxed);
   }
 
   /**
@@ -266,8 +280,9 @@ private:
     else // wrapping
       m_iWritePos = size - (m_iSize - m_iWritePos);
 
-    //we can increase the write count now
-    m_iWritten+=size;
+    //we can increase the write count now, this publishes the data to the reader
+    m_iWritten.store(m_iWritten.load(std::memory_order_relaxed) + size,
+                     std::memory_order_release);
   }
 
   /**
@@ -281,15 +296,27 @@ private:
     else
       m_iReadPos = size - (m_iSize - m_iReadPos);
 
-    //we can increase the read count now
-    m_iRead+=size;
+    //we can increase the read count now, this hands the space back to the writer
+    m_iRead.store(m_iRead.load(std::memory_order_relaxed) + size, std::memory_order_release);
   }
 
-  unsigned int m_iReadPos;
-  unsigned int m_iWritePos;
-  unsigned int m_iRead;
-  unsigned int m_iWritten;
-  unsigned int m_iSize;
-  unsigned int m_planes;
-  unsigned char **m_Buffer;
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
+  // shared, read-only after Create()
+  unsigned int m_iSize = 0;
+  unsigned int m_planes = 0;
+  unsigned char **m_Buffer = nullptr;
+  char m_padShared[CACHE_LINE_SIZE];
+
+  // owned by the writer
+  std::atomic<unsigned int> m_iWritten{0};
+  unsigned int m_iWritePos = 0;
+  unsigned int m_iCachedRead = 0;
+  char m_padWriter[CACHE_LINE_SIZE];
+
+  // owned by the reader
+  std::atomic<unsigned int> m_iRead{0};
+  unsigned int m_iReadPos = 0;
+  unsigned int m_iCachedWritten = 0;
+  char m_padReader[CACHE_LINE_SIZE];
 };
@@ -0,0 +1,53 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AELatencyHistogram.h"
+
+#include <gtest/gtest.h>
+
+TEST(TestAELatencyHistogram, Empty)
+{
+  CAELatencyHistogram histogram;
+  EXPECT_EQ(0u, histogram.GetCount());
+  EXPECT_EQ(0u, histogram.GetMax());
+  EXPECT_EQ(0u, histogram.GetPercentile(50.0));
+}
+
+TEST(TestAELatencyHistogram, Percentiles)
+{
+  CAELatencyHistogram histogram;
+  // 98 fast periods and two slow ones
+  for (int i = 0; i < 98; i++)
+    histogram.Add(100);
+  histogram.Add(5000);
+  histogram.Add(20000);
+
+  EXPECT_EQ(100u, histogram.GetCount());
+  EXPECT_EQ(20000u, histogram.GetMax());
+
+  // 100us lands in [64, 128)
+  EXPECT_EQ(127u, histogram.GetPercentile(50.0));
+  // 5000us lands in [4096, 8192)
+  EXPECT_EQ(8191u, histogram.GetPercentile(99.0));
+  // never above the largest recorded value
+  EXPECT_EQ(20000u, histogram.GetPercentile(100.0));
+}
+
+TEST(TestAELatencyHistogram, Reset)
+{
+  CAELatencyHistogram histogram;
+  histogram.Add(0);
+  histogram.Add(UINT64_C(1) << 40);
+  EXPECT_EQ(2u, histogram.GetCount());
+  EXPECT_EQ(0u, histogram.GetPercentile(50.0));
+
+  histogram.Reset();
+  EXPECT_EQ(0u, histogram.GetCount());
+  EXPECT_EQ(0u, histogram.GetMax());
+  EXPECT_EQ(0u, histogram.GetPercentile(99.0));
+}
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AEMixKernels.h"
+#include "utils/CPUInfo.h"
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// one period of 7.1 float at the default ActiveAE buffer size
+const uint32_t PERIOD_FLOATS = 8 * 1024;
+
+bool IsSupported(CAEMixKernels::Variant variant)
+{
+  const unsigned int features = CCPUInfo::GetCPUInfo()->GetCPUFeatures();
+  switch (variant)
+  {
+    case CAEMixKernels::VARIANT_SSE:
+      return (features & CPU_FEATURE_SSE) != 0;
+    case CAEMixKernels::VARIANT_AVX:
+      return (features & CPU_FEATURE_AVX) != 0;
+    case CAEMixKernels::VARIANT_NEON:
+      return (features & CPU_FEATURE_NEON) != 0;
+    default:
+      return true;
+  }
+}
+
+std::vector<float> RandomSamples(uint32_t count, float range)
+{
+  std::mt19937 gen(count);
+  std::uniform_real_distribution<float> dist(-range, range);
+  std::vector<float> samples(count);
+  for (auto& sample : samples)
+    sample = dist(gen);
+  return samples;
+}
+
+class TestAEMixKernels : public ::testing::TestWithParam<CAEMixKernels::Variant>
+{
+protected:
+  void SetUp() override
+  {
+    if (!IsSupported(GetParam()))
+      return;
+    m_kernels = CAEMixKernels::GetVariant(GetParam());
+    m_reference = CAEMixKernels::GetVariant(CAEMixKernels::VARIANT_C);
+  }
+
+  const AEMixKernels* m_kernels = nullptr;
+  const AEMixKernels* m_reference = nullptr;
+};
+} // namespace
+
+TEST_P(TestAEMixKernels, MulArray)
+{
+  if (!m_kernels)
+    return;
+
+  // odd offsets and sizes exercise the unaligned head and the scalar tail
+  for (uint32_t offset = 0; offset < 4; ++offset)
+  {
+    for (uint32_t count : {0u, 1u, 3u, 7u, 17u, 1023u})
+    {
+      std::vector<float> expected = RandomSamples(count + offset, 2.0f);
+      std::vector<float> actual = expected;
+
+      m_reference->MulArray(expected.data() + offset, 0.7f, count);
+      m_kernels->MulArray(actual.data() + offset, 0.7f, count);
+
+      for (uint32_t i = 0; i < count + offset; ++i)
+        EXPECT_FLOAT_EQ(expected[i], actual[i]);
+    }
+  }
+}
+
+TEST_P(TestAEMixKernels, MulAddArray)
+{
+  if (!m_kernels)
+    return;
+
+  for (uint32_t offset = 0; offset < 4; ++offset)
+  {
+    for (uint32_t count : {0u, 1u, 3u, 7u, 17u, 1023u})
+    {
+      std::vector<float> expected = RandomSamples(count + offset, 1.0f);
+      std::vector<float> actual = expected;
+      const std::vector<float> add = RandomSamples(count + offset + 1, 1.0f);
+
+      const float expectedPeak =
+          m_reference->MulAddArray(expected.data() + offset, add.data() + 1, 0.8f, count);
+      const float actualPeak =
+          m_kernels->MulAddArray(actual.data() + offset, add.data() + 1, 0.8f, count);
+
+      EXPECT_FLOAT_EQ(expectedPeak, actualPeak);
+      for (uint32_t i = 0; i < count + offset; ++i)
+        EXPECT_FLOAT_EQ(expected[i], actual[i]);
+    }
+  }
+}
+
+TEST_P(TestAEMixKernels, ClampArray)
+{
+  if (!m_kernels)
+    return;
+
+  for (uint32_t offset = 0; offset < 4; ++offset)
+  {
+    for (uint32_t count : {0u, 1u, 3u, 7u, 17u, 1023u})
+    {
+      std::vector<float> expected = RandomSamples(count + offset, 5.0f);
+      std::vector<float> actual = expected;
+
+      m_reference->ClampArray(expected.data() + offset, count);
+      m_kernels->ClampArray(actual.data() + offset, count);
+
+      for (uint32_t i = 0; i < count + offset; ++i)
+      {
+        EXPECT_NEAR(expected[i], actual[i], 1e-6f);
+        if (i >= offset)
+          EXPECT_LE(std::fabs(actual[i]), 1.0f + 1e-6f);
+      }
+    }
+  }
+}
+
+TEST_P(TestAEMixKernels, Throughput)
+{
+  if (!m_kernels)
+    return;
+
+  // mix a 7.1 stream and four gui sounds into one period, then clamp
+  const int iterations = 2000;
+  std::vector<float> out(PERIOD_FLOATS);
+  std::vector<std::vector<float>> streams;
+  for (int i = 0; i < 5; ++i)
+    streams.push_back(RandomSamples(PERIOD_FLOATS, 0.5f));
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i)
+  {
+    std::fill(out.begin(), out.end(), 0.0f);
+    float peak = 0.0f;
+    for (const auto& stream : streams)
+      peak = m_kernels->MulAddArray(out.data(), stream.data(), 0.5f, PERIOD_FLOATS);
+    if (peak > 1.0f)
+      m_kernels->ClampArray(out.data(), PERIOD_FLOATS);
+    m_kernels->MulArray(out.data(), 0.9f, PERIOD_FLOATS);
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+
+  const double nsPerPeriod = static_cast<double>(elapsed) / iterations;
+  RecordProperty("kernels", m_kernels->name);
+  RecordProperty("ns_per_period", static_cast<int>(nsPerPeriod));
+  EXPECT_GT(nsPerPeriod, 0.0);
+}
+
+INSTANTIATE_TEST_CASE_P(AllVariants,
+                        TestAEMixKernels,
+                        ::testing::Values(CAEMixKernels::VARIANT_C,
+                                          CAEMixKernels::VARIANT_SSE,
+                                          CAEMixKernels::VARIANT_AVX,
+                                          CAEMixKernels::VARIANT_NEON));
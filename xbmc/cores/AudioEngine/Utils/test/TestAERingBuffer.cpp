@@ -0,0 +1,136 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AERingBuffer.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#if defined(TARGET_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <gtest/gtest.h>
+
+namespace
+{
+void PinToCore(std::thread& thread, unsigned int core)
+{
+#if defined(TARGET_LINUX)
+  const unsigned int cores = std::thread::hardware_concurrency();
+  if (cores < 2)
+    return;
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core % cores, &set);
+  pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#endif
+}
+} // namespace
+
+TEST(TestAERingBuffer, WriteRead)
+{
+  AERingBuffer buffer(16);
+  unsigned char in[12];
+  unsigned char out[16];
+  for (unsigned int i = 0; i < sizeof(in); i++)
+    in[i] = i;
+
+  EXPECT_EQ(16u, buffer.GetWriteSize());
+  EXPECT_EQ(0u, buffer.GetReadSize());
+  EXPECT_EQ(AE_RING_BUFFER_EMPTY, buffer.Read(out, 1));
+
+  // second write and read wrap around the end of the buffer
+  for (int pass = 0; pass < 2; pass++)
+  {
+    EXPECT_EQ(AE_RING_BUFFER_OK, buffer.Write(in, sizeof(in)));
+    EXPECT_EQ(4u, buffer.GetWriteSize());
+    EXPECT_EQ(AE_RING_BUFFER_FULL, buffer.Write(in, 5));
+    EXPECT_EQ(AE_RING_BUFFER_NOTAVAILABLE, buffer.Read(out, 13));
+    EXPECT_EQ(AE_RING_BUFFER_OK, buffer.Read(out, sizeof(in)));
+    EXPECT_EQ(0, memcmp(in, out, sizeof(in)));
+    EXPECT_EQ(0u, buffer.GetReadSize());
+  }
+}
+
+TEST(TestAERingBuffer, Planes)
+{
+  AERingBuffer buffer(8, 2);
+  unsigned char left[4] = {1, 2, 3, 4};
+  unsigned char right[4] = {5, 6, 7, 8};
+  unsigned char out[4];
+
+  EXPECT_EQ(2u, buffer.NumPlanes());
+  EXPECT_EQ(AE_RING_BUFFER_OK, buffer.Write(left, 4, 0));
+  // data is only published once the last plane is written
+  EXPECT_EQ(0u, buffer.GetReadSize());
+  EXPECT_EQ(AE_RING_BUFFER_OK, buffer.Write(right, 4, 1));
+  EXPECT_EQ(4u, buffer.GetReadSize());
+
+  EXPECT_EQ(AE_RING_BUFFER_OK, buffer.Read(out, 4, 0));
+  EXPECT_EQ(0, memcmp(left, out, 4));
+  EXPECT_EQ(AE_RING_BUFFER_OK, buffer.Read(out, 4, 1));
+  EXPECT_EQ(0, memcmp(right, out, 4));
+  EXPECT_EQ(8u, buffer.GetWriteSize());
+}
+
+TEST(TestAERingBuffer, ProducerConsumerStress)
+{
+  // odd sizes so chunks keep landing on different wrap positions
+  const unsigned int bufferSize = 4093;
+  const unsigned int total = 32 * 1024 * 1024;
+  AERingBuffer buffer(bufferSize);
+  std::atomic<bool> corrupted(false);
+
+  std::thread producer([&]() {
+    std::vector<unsigned char> chunk(509);
+    unsigned int sent = 0;
+    while (sent < total && !corrupted)
+    {
+      unsigned int size = std::min<unsigned int>(1 + sent % chunk.size(), total - sent);
+      for (unsigned int i = 0; i < size; i++)
+        chunk[i] = static_cast<unsigned char>(sent + i);
+      if (buffer.Write(chunk.data(), size) == AE_RING_BUFFER_OK)
+        sent += size;
+      else
+        std::this_thread::yield();
+    }
+  });
+
+  std::thread consumer([&]() {
+    std::vector<unsigned char> chunk(311);
+    unsigned int received = 0;
+    while (received < total && !corrupted)
+    {
+      unsigned int size = std::min<unsigned int>(1 + received % chunk.size(), total - received);
+      if (buffer.Read(chunk.data(), size) != AE_RING_BUFFER_OK)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      for (unsigned int i = 0; i < size; i++)
+      {
+        if (chunk[i] != static_cast<unsigned char>(received + i))
+          corrupted = true;
+      }
+      received += size;
+    }
+  });
+
+  PinToCore(producer, 0);
+  PinToCore(consumer, 1);
+
+  producer.join();
+  consumer.join();
+
+  EXPECT_FALSE(corrupted);
+  EXPECT_EQ(0u, buffer.GetReadSize());
+}
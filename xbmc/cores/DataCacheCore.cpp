@@ -244,6 +244,48 @@ int CDataCacheCore::GetAudioBitsPerSample()
   return m_playerAudioInfo.bitsPerSample;
 }
 
+void CDataCacheCore::SetAudioEngineTiming(AudioEngineStage stage, const SAudioEngineTiming& timing)
+{
+  CSingleLock lock(m_audioEngineSection);
+
+  m_audioEngineTiming[stage] = timing;
+}
+
+CDataCacheCore::SAudioEngineTiming CDataCacheCore::GetAudioEngineTiming(AudioEngineStage stage)
+{
+  CSingleLock lock(m_audioEngineSection);
+
+  return m_audioEngineTiming[stage];
+}
+
+void CDataCacheCore::SetDemuxPacketStats(const SDemuxPacketStats& stats)
+{
+  CSingleLock lock(m_demuxSection);
+
+  m_demuxPacketStats = stats;
+}
+
+CDataCacheCore::SDemuxPacketStats CDataCacheCore::GetDemuxPacketStats()
+{
+  CSingleLock lock(m_demuxSection);
+
+  return m_demuxPacketStats;
+}
+
+void CDataCacheCore::SetVideoBufferStats(const SVideoBufferStats& stats)
+{
+  CSingleLock lock(m_videoBufferSection);
+
+  m_videoBufferStats = stats;
+}
+
+CDataCacheCore::SVideoBufferStats CDataCacheCore::GetVideoBufferStats()
+{
+  CSingleLock lock(m_videoBufferSection);
+
+  return m_videoBufferStats;
+}
+
 void CDataCacheCore::SetCutList(const std::vector<EDL::Cut>& cutList)
 {
   CSingleLock lock(m_contentSection);
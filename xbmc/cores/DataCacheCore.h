@@ -59,6 +59,47 @@ public:
   void SetAudioBitsPerSample(int bitsPerSample);
   int GetAudioBitsPerSample();
 
+  // audio engine timing
+  enum AudioEngineStage
+  {
+    AE_STAGE_RESAMPLE = 0,
+    AE_STAGE_MIX,
+    AE_STAGE_ENCODE,
+    AE_STAGE_SINKWRITE,
+    AE_STAGE_SINKDRIFT,
+    AE_STAGE_MAX
+  };
+  struct SAudioEngineTiming
+  {
+    uint64_t count = 0; // number of periods measured
+    uint64_t median = 0; // all durations in microseconds
+    uint64_t p99 = 0;
+    uint64_t max = 0;
+  };
+  void SetAudioEngineTiming(AudioEngineStage stage, const SAudioEngineTiming& timing);
+  SAudioEngineTiming GetAudioEngineTiming(AudioEngineStage stage);
+
+  // demux packet buffers
+  struct SDemuxPacketStats
+  {
+    unsigned int allocations = 0; // heap allocations per second
+    unsigned int reused = 0; // buffers taken from the pool per second
+    unsigned int wrapped = 0; // packets referencing demuxer buffers per second
+    uint64_t copyBytes = 0; // bytes copied per second
+  };
+  void SetDemuxPacketStats(const SDemuxPacketStats& stats);
+  SDemuxPacketStats GetDemuxPacketStats();
+
+  // software decoded frame buffers
+  struct SVideoBufferStats
+  {
+    unsigned int buffers = 0; // frame buffers allocated
+    unsigned int used = 0; // frame buffers referenced by decoder, filters or renderer
+    uint64_t bytes = 0; // memory held by the frame buffers
+  };
+  void SetVideoBufferStats(const SVideoBufferStats& stats);
+  SVideoBufferStats GetVideoBufferStats();
+
   // content info
   void SetCutList(const std::vector<EDL::Cut>& cutList);
   std::vector<EDL::Cut> GetCutList() const;
@@ -152,6 +193,15 @@ protected:
     int bitsPerSample;
   } m_playerAudioInfo;
 
+  CCriticalSection m_audioEngineSection;
+  SAudioEngineTiming m_audioEngineTiming[AE_STAGE_MAX];
+
+  CCriticalSection m_demuxSection;
+  SDemuxPacketStats m_demuxPacketStats;
+
+  CCriticalSection m_videoBufferSection;
+  SVideoBufferStats m_videoBufferStats;
+
   mutable CCriticalSection m_contentSection;
   struct SContentInfo
   {
@@ -21,6 +21,9 @@
 #include "utils/log.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderManager.h"
 #include "utils/StringUtils.h"
+#include "utils/MemUtils.h"
+#include "threads/SystemClock.h"
+#include <atomic>
 #include <memory>
 
 extern "C" {
@@ -30,6 +33,7 @@ extern "C" {
 #include <libavfilter/buffersink.h>
 #include <libavfilter/buffersrc.h>
 #include <libavutil/pixdesc.h>
+#include <libavutil/imgutils.h>
 }
 
 #ifndef TARGET_POSIX
@@ -40,6 +44,9 @@ extern "C" {
 #define RINT lrint
 #endif
 
+// frames in the filter thread before the decoder waits for it
+#define FILTER_THREAD_DEPTH 2
+
 enum DecoderState
 {
   STATE_NONE,
@@ -181,6 +188,137 @@ void CVideoBufferPoolFFmpeg::Return(int id)
   m_free.push_back(id);
 }
 
+//------------------------------------------------------------------------------
+// Frame buffers of software decoding
+//------------------------------------------------------------------------------
+
+/*!
+ * Frame data of software decoded pictures. Every frame is a single aligned
+ * allocation holding all planes, it is referenced by the decoder, the filters
+ * and the renderer and returns here when the last reference is gone. The
+ * pool is freed when the codec released it and no frame is out any more.
+ */
+class CVideoFramePoolFFmpeg
+{
+public:
+  static const int ALIGN = 64;
+
+  CVideoFramePoolFFmpeg() = default;
+
+  //! called by the owner instead of delete
+  void Release()
+  {
+    {
+      CSingleLock lock(m_critSection);
+      m_released = true;
+      ClearFree();
+    }
+    Unref();
+  }
+
+  AVBufferRef* Get(size_t size)
+  {
+    uint8_t* data = nullptr;
+    {
+      CSingleLock lock(m_critSection);
+      if (size != m_size)
+      {
+        ClearFree();
+        m_size = size;
+      }
+      if (!m_free.empty())
+      {
+        data = m_free.back();
+        m_free.pop_back();
+      }
+    }
+
+    if (!data)
+    {
+      uint8_t* raw = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(size + HEADER, ALIGN));
+      if (!raw)
+        return nullptr;
+      *reinterpret_cast<size_t*>(raw) = size;
+      data = raw + HEADER;
+      m_buffers++;
+      m_bytes += size;
+    }
+
+    AVBufferRef* buffer = av_buffer_create(data, size, FreeBuffer, this, 0);
+    if (!buffer)
+    {
+      Put(data);
+      return nullptr;
+    }
+    m_refs++;
+    m_used++;
+    return buffer;
+  }
+
+  CDataCacheCore::SVideoBufferStats GetStats() const
+  {
+    CDataCacheCore::SVideoBufferStats stats;
+    stats.buffers = m_buffers;
+    stats.used = m_used;
+    stats.bytes = m_bytes;
+    return stats;
+  }
+
+private:
+  static const int HEADER = ALIGN; // keeps the size of the allocation, data stays aligned
+  static const size_t MAX_FREE = 32;
+
+  ~CVideoFramePoolFFmpeg() = default;
+
+  static void FreeBuffer(void* opaque, uint8_t* data)
+  {
+    CVideoFramePoolFFmpeg* pool = static_cast<CVideoFramePoolFFmpeg*>(opaque);
+    pool->m_used--;
+    pool->Put(data);
+    pool->Unref();
+  }
+
+  void Put(uint8_t* data)
+  {
+    CSingleLock lock(m_critSection);
+    if (!m_released && m_free.size() < MAX_FREE && GetSize(data) == m_size)
+      m_free.push_back(data);
+    else
+      Free(data);
+  }
+
+  void Unref()
+  {
+    if (--m_refs == 0)
+      delete this;
+  }
+
+  static size_t GetSize(uint8_t* data) { return *reinterpret_cast<size_t*>(data - HEADER); }
+
+  void Free(uint8_t* data)
+  {
+    m_buffers--;
+    m_bytes -= GetSize(data);
+    KODI::MEMORY::AlignedFree(data - HEADER);
+  }
+
+  void ClearFree()
+  {
+    for (auto data : m_free)
+      Free(data);
+    m_free.clear();
+  }
+
+  CCriticalSection m_critSection;
+  std::vector<uint8_t*> m_free;
+  size_t m_size = 0;
+  bool m_released = false;
+  std::atomic<int> m_refs{1}; // the owner and every buffer out
+  std::atomic<unsigned int> m_buffers{0};
+  std::atomic<unsigned int> m_used{0};
+  std::atomic<uint64_t> m_bytes{0};
+};
+
 //------------------------------------------------------------------------------
 // main class
 //------------------------------------------------------------------------------
@@ -266,7 +404,7 @@ enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx
   if (ctx->HasHardware())
   {
     ctx->SetHardware(nullptr);
-    avctx->get_buffer2 = avcodec_default_get_buffer2;
+    avctx->get_buffer2 = GetBuffer;
     avctx->slice_flags = 0;
     av_buffer_unref(&avctx->hw_frames_ctx);
   }
@@ -300,10 +438,63 @@ enum AVPixelFormat CDVDVideoCodecFFmpeg::GetFormat(struct AVCodecContext * avctx
   return avcodec_default_get_format(avctx, fmt);
 }
 
+int CDVDVideoCodecFFmpeg::GetBuffer(AVCodecContext* avctx, AVFrame* frame, int flags)
+{
+  ICallbackHWAccel* cb = static_cast<ICallbackHWAccel*>(avctx->opaque);
+  CDVDVideoCodecFFmpeg* ctx = dynamic_cast<CDVDVideoCodecFFmpeg*>(cb);
+
+  const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+  if (!ctx->m_framePool || avctx->hw_frames_ctx || !desc ||
+      !(avctx->codec->capabilities & AV_CODEC_CAP_DR1) ||
+      (desc->flags & (AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_BITSTREAM)))
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+
+  // codecs write past the visible picture, widen until all planes have aligned strides
+  int width = frame->width;
+  int height = frame->height;
+  int alignment[AV_NUM_DATA_POINTERS];
+  avcodec_align_dimensions2(avctx, &width, &height, alignment);
+
+  int linesize[4];
+  while (true)
+  {
+    if (av_image_fill_linesizes(linesize, static_cast<AVPixelFormat>(frame->format), width) < 0)
+      return avcodec_default_get_buffer2(avctx, frame, flags);
+
+    bool aligned = true;
+    for (int i = 0; i < 4; i++)
+      aligned = aligned && linesize[i] % CVideoFramePoolFFmpeg::ALIGN == 0;
+    if (aligned)
+      break;
+    width += width & ~(width - 1);
+  }
+
+  uint8_t* data[4];
+  int size = av_image_fill_pointers(data, static_cast<AVPixelFormat>(frame->format), height,
+                                    nullptr, linesize);
+  if (size < 0)
+    return avcodec_default_get_buffer2(avctx, frame, flags);
+
+  // some codecs read 16 bytes past the end of the last plane
+  frame->buf[0] = ctx->m_framePool->Get(size + 16);
+  if (!frame->buf[0])
+    return AVERROR(ENOMEM);
+
+  for (int i = 0; i < 4; i++)
+  {
+    frame->linesize[i] = linesize[i];
+    frame->data[i] = linesize[i] ? frame->buf[0]->data + (data[i] - data[0]) : nullptr;
+  }
+  frame->extended_data = frame->data;
+
+  return 0;
+}
+
 CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg(CProcessInfo &processInfo)
 : CDVDVideoCodec(processInfo), m_postProc(processInfo)
 {
   m_videoBufferPool = std::make_shared<CVideoBufferPoolFFmpeg>();
+  m_framePool = new CVideoFramePoolFFmpeg();
 
   m_decoderState = STATE_NONE;
 }
@@ -311,6 +502,9 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg(CProcessInfo &processInfo)
 CDVDVideoCodecFFmpeg::~CDVDVideoCodecFFmpeg()
 {
   Dispose();
+
+  // frames may still be referenced by the renderer, those keep the pool alive
+  m_framePool->Release();
 }
 
 bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options)
@@ -353,6 +547,7 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->debug = 0;
   m_pCodecContext->workaround_bugs = FF_BUG_AUTODETECT;
   m_pCodecContext->get_format = GetFormat;
+  m_pCodecContext->get_buffer2 = GetBuffer;
   m_pCodecContext->codec_tag = hints.codec_tag;
 
   // setup threading model
@@ -395,6 +590,10 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     m_pCodecContext->skip_loop_filter = static_cast<AVDiscard>(iSkipLoopFilter);
   }
 
+  // filter sw decoded frames, e.g. deinterlace, while the next ones are decoded
+  m_useFilterThread = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoFilterThread &&
+                      CServiceBroker::GetCPUInfo()->GetCPUCount() > 1;
+
   // set any special options
   for(std::vector<CDVDCodecOption>::iterator it = options.m_keys.begin(); it != options.m_keys.end(); ++it)
   {
@@ -859,6 +1058,13 @@ bool CDVDVideoCodecFFmpeg::SetPictureParams(VideoPicture* pVideoPicture)
   buffer->SetRef(m_pFrame);
   pVideoPicture->videoBuffer = buffer;
 
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (now - m_bufferStatsTime >= 1000)
+  {
+    m_processInfo.SetVideoBufferStats(m_framePool->GetStats());
+    m_bufferStatsTime = now;
+  }
+
   if (m_processInfo.GetVideoSettings().m_PostProcess)
   {
     m_postProc.SetType(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoPPFFmpegPostProc, false);
@@ -1168,6 +1374,9 @@ int CDVDVideoCodecFFmpeg::FilterOpen(const std::string& filters, bool scale)
     }
   }
 
+  if (m_useFilterThread)
+    m_filterThread.Attach(m_pFilterIn, m_pFilterOut);
+
   m_filterEof = false;
   return result;
 }
@@ -1177,6 +1386,7 @@ void CDVDVideoCodecFFmpeg::FilterClose()
   if (m_pFilterGraph)
   {
     CLog::Log(LOGDEBUG, LOGVIDEO, "CDVDVideoCodecFFmpeg::FilterClose - Freeing filter graph");
+    m_filterThread.Detach();
     avfilter_graph_free(&m_pFilterGraph);
 
     // Disposed by above code
@@ -1189,31 +1399,51 @@ CDVDVideoCodec::VCReturn CDVDVideoCodecFFmpeg::FilterProcess(AVFrame* frame)
 {
   int result;
 
-  if (frame || (m_codecControlFlags & DVD_CODEC_CTRL_DRAIN))
+  if (m_filterThread.IsAttached())
   {
-    result = av_buffersrc_add_frame(m_pFilterIn, frame);
-    if (result < 0)
+    if (frame || (m_codecControlFlags & DVD_CODEC_CTRL_DRAIN))
+      m_filterThread.AddFrame(frame);
+
+    // decode ahead while the filter works, but not more than a few frames
+    bool wait = (m_codecControlFlags & DVD_CODEC_CTRL_DRAIN) ||
+                m_filterThread.GetPending() >= FILTER_THREAD_DEPTH;
+    CDVDVideoCodec::VCReturn ret = m_filterThread.GetFrame(m_pFilterFrame, wait);
+    if (ret == VC_EOF)
     {
-      CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::FilterProcess - av_buffersrc_add_frame");
-      return VC_ERROR;
+      m_filterEof = true;
+      return VC_BUFFER;
     }
+    else if (ret != VC_PICTURE)
+      return ret;
   }
-
-  result = av_buffersink_get_frame(m_pFilterOut, m_pFilterFrame);
-
-  if (result  == AVERROR(EAGAIN))
-    return VC_BUFFER;
-  else if (result == AVERROR_EOF)
+  else
   {
+    if (frame || (m_codecControlFlags & DVD_CODEC_CTRL_DRAIN))
+    {
+      result = av_buffersrc_add_frame(m_pFilterIn, frame);
+      if (result < 0)
+      {
+        CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::FilterProcess - av_buffersrc_add_frame");
+        return VC_ERROR;
+      }
+    }
+
     result = av_buffersink_get_frame(m_pFilterOut, m_pFilterFrame);
-    m_filterEof = true;
-    if (result < 0)
+
+    if (result  == AVERROR(EAGAIN))
       return VC_BUFFER;
-  }
-  else if (result < 0)
-  {
-    CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::FilterProcess - av_buffersink_get_frame");
-    return VC_ERROR;
+    else if (result == AVERROR_EOF)
+    {
+      result = av_buffersink_get_frame(m_pFilterOut, m_pFilterFrame);
+      m_filterEof = true;
+      if (result < 0)
+        return VC_BUFFER;
+    }
+    else if (result < 0)
+    {
+      CLog::Log(LOGERROR, "CDVDVideoCodecFFmpeg::FilterProcess - av_buffersink_get_frame");
+      return VC_ERROR;
+    }
   }
 
   av_frame_unref(m_pFrame);
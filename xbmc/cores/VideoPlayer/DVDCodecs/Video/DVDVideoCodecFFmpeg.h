@@ -11,6 +11,7 @@
 #include "cores/VideoPlayer/DVDCodecs/DVDCodecs.h"
 #include "cores/VideoPlayer/DVDStreamInfo.h"
 #include "DVDVideoCodec.h"
+#include "DVDVideoFilterThread.h"
 #include "DVDVideoPPFFmpeg.h"
 #include <string>
 #include <vector>
@@ -25,6 +26,7 @@ extern "C" {
 }
 
 class CVideoBufferPoolFFmpeg;
+class CVideoFramePoolFFmpeg;
 
 class CDVDVideoCodecFFmpeg : public CDVDVideoCodec, public ICallbackHWAccel
 {
@@ -48,6 +50,7 @@ public:
 protected:
   void Dispose();
   static enum AVPixelFormat GetFormat(struct AVCodecContext * avctx, const AVPixelFormat * fmt);
+  static int GetBuffer(AVCodecContext* avctx, AVFrame* frame, int flags);
 
   int  FilterOpen(const std::string& filters, bool scale);
   void FilterClose();
@@ -63,6 +66,8 @@ protected:
   AVFrame* m_pDecodedFrame = nullptr;;
   AVCodecContext* m_pCodecContext = nullptr;;
   std::shared_ptr<CVideoBufferPoolFFmpeg> m_videoBufferPool;
+  CVideoFramePoolFFmpeg* m_framePool; // frame data of software decoding, outlives the codec
+  unsigned int m_bufferStatsTime = 0;
 
   std::string m_filters;
   std::string m_filters_next;
@@ -72,6 +77,8 @@ protected:
   AVFrame* m_pFilterFrame = nullptr;;
   bool m_filterEof = false;
   bool m_eof = false;
+  bool m_useFilterThread = false;
+  CDVDVideoFilterThread m_filterThread;
 
   CDVDVideoPPFFmpeg m_postProc;
 
@@ -0,0 +1,223 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDVideoFilterThread.h"
+
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+extern "C" {
+#include <libavfilter/buffersink.h>
+#include <libavfilter/buffersrc.h>
+#include <libavutil/frame.h>
+}
+
+CDVDVideoFilterThread::CDVDVideoFilterThread() : CThread("VideoFilter")
+{
+}
+
+CDVDVideoFilterThread::~CDVDVideoFilterThread()
+{
+  {
+    CSingleLock lock(m_section);
+    m_bStop = true;
+    m_inputCond.notifyAll();
+  }
+  StopThread(true);
+
+  ClearQueue(m_input);
+  ClearQueue(m_output);
+  for (auto frame : m_unused)
+    av_frame_free(&frame);
+}
+
+void CDVDVideoFilterThread::Attach(AVFilterContext* filterIn, AVFilterContext* filterOut)
+{
+  CSingleLock lock(m_section);
+  Flush(lock);
+  m_filterIn = filterIn;
+  m_filterOut = filterOut;
+
+  if (!IsRunning())
+    Create();
+}
+
+void CDVDVideoFilterThread::Detach()
+{
+  CSingleLock lock(m_section);
+  Flush(lock);
+  m_filterIn = nullptr;
+  m_filterOut = nullptr;
+}
+
+void CDVDVideoFilterThread::AddFrame(AVFrame* frame)
+{
+  CSingleLock lock(m_section);
+
+  // eof is already on its way
+  if (!frame && !m_input.empty() && !m_input.back())
+    return;
+
+  while (m_input.size() >= MAX_INPUT && !m_error)
+    m_outputCond.wait(lock);
+
+  AVFrame* queued = nullptr;
+  if (frame)
+  {
+    if (!m_unused.empty())
+    {
+      queued = m_unused.front();
+      m_unused.pop_front();
+    }
+    else if (!(queued = av_frame_alloc()))
+    {
+      CLog::Log(LOGERROR, "CDVDVideoFilterThread::AddFrame - unable to alloc frame");
+      av_frame_unref(frame);
+      return;
+    }
+    av_frame_move_ref(queued, frame);
+  }
+
+  m_input.push_back(queued);
+  m_inputCond.notifyAll();
+}
+
+CDVDVideoCodec::VCReturn CDVDVideoFilterThread::GetFrame(AVFrame* frame, bool wait)
+{
+  CSingleLock lock(m_section);
+  while (wait && m_output.empty() && !m_error && (m_busy || !m_input.empty()))
+    m_outputCond.wait(lock);
+
+  if (!m_output.empty())
+  {
+    AVFrame* filtered = m_output.front();
+    m_output.pop_front();
+    av_frame_unref(frame);
+    av_frame_move_ref(frame, filtered);
+    m_unused.push_back(filtered);
+    return CDVDVideoCodec::VC_PICTURE;
+  }
+
+  if (m_error)
+    return CDVDVideoCodec::VC_ERROR;
+
+  if (m_eof && !m_busy && m_input.empty())
+    return CDVDVideoCodec::VC_EOF;
+
+  return CDVDVideoCodec::VC_BUFFER;
+}
+
+unsigned int CDVDVideoFilterThread::GetPending()
+{
+  CSingleLock lock(m_section);
+  return m_input.size() + m_output.size() + (m_busy ? 1 : 0);
+}
+
+void CDVDVideoFilterThread::Process()
+{
+  CSingleLock lock(m_section);
+
+  while (!m_bStop)
+  {
+    if (m_input.empty() || !m_filterIn)
+    {
+      m_inputCond.wait(lock);
+      continue;
+    }
+
+    AVFrame* frame = m_input.front();
+    m_input.pop_front();
+    AVFilterContext* filterIn = m_filterIn;
+    AVFilterContext* filterOut = m_filterOut;
+    m_busy = true;
+    m_outputCond.notifyAll();
+
+    // the graph is only touched here while busy, Detach waits for it
+    bool error = false;
+    bool eof = false;
+    std::deque<AVFrame*> filtered;
+    AVFrame* spare = nullptr;
+    {
+      CSingleExit exit(m_section);
+
+      if (av_buffersrc_add_frame(filterIn, frame) < 0)
+      {
+        CLog::Log(LOGERROR, "CDVDVideoFilterThread::Process - av_buffersrc_add_frame");
+        error = true;
+      }
+
+      while (!error)
+      {
+        AVFrame* out = nullptr;
+        {
+          CSingleLock unusedLock(m_section);
+          if (!m_unused.empty())
+          {
+            out = m_unused.front();
+            m_unused.pop_front();
+          }
+        }
+        if (!out && !(out = av_frame_alloc()))
+        {
+          CLog::Log(LOGERROR, "CDVDVideoFilterThread::Process - unable to alloc frame");
+          error = true;
+          break;
+        }
+
+        int result = av_buffersink_get_frame(filterOut, out);
+        if (result < 0)
+        {
+          spare = out;
+          if (result == AVERROR_EOF)
+            eof = true;
+          else if (result != AVERROR(EAGAIN))
+          {
+            CLog::Log(LOGERROR, "CDVDVideoFilterThread::Process - av_buffersink_get_frame");
+            error = true;
+          }
+          break;
+        }
+        filtered.push_back(out);
+      }
+    }
+
+    if (frame)
+      m_unused.push_back(frame);
+    if (spare)
+      m_unused.push_back(spare);
+    m_output.insert(m_output.end(), filtered.begin(), filtered.end());
+    m_eof = m_eof || eof;
+    m_error = m_error || error;
+    m_busy = false;
+    m_outputCond.notifyAll();
+  }
+}
+
+void CDVDVideoFilterThread::Flush(CSingleLock& lock)
+{
+  while (m_busy)
+    m_outputCond.wait(lock);
+
+  ClearQueue(m_input);
+  ClearQueue(m_output);
+  m_eof = false;
+  m_error = false;
+}
+
+void CDVDVideoFilterThread::ClearQueue(std::deque<AVFrame*>& queue)
+{
+  for (auto frame : queue)
+  {
+    if (frame)
+    {
+      av_frame_unref(frame);
+      m_unused.push_back(frame);
+    }
+  }
+  queue.clear();
+}
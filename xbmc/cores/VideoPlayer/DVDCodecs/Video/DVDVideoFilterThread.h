@@ -0,0 +1,90 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "DVDVideoCodec.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+
+#include <deque>
+
+struct AVFilterContext;
+struct AVFrame;
+
+/*!
+ * \brief Runs a filter graph of the software decoder on its own thread
+ *
+ * Decoded frames are queued by the decoder thread and filtered while it
+ * decodes the next ones, filtered frames are returned in decode order. A
+ * single graph keeps the state temporal filters like yadif depend on, the
+ * filters themselves use the slice threads of the graph.
+ */
+class CDVDVideoFilterThread : private CThread
+{
+public:
+  CDVDVideoFilterThread();
+  ~CDVDVideoFilterThread() override;
+
+  /*!
+   * \brief filter into the given graph, starts the thread on first use
+   * Frames still queued for a previous graph are dropped.
+   */
+  void Attach(AVFilterContext* filterIn, AVFilterContext* filterOut);
+
+  /*!
+   * \brief drop all queued frames and stop using the graph, it may be freed afterwards
+   */
+  void Detach();
+
+  bool IsAttached() const { return m_filterIn != nullptr; }
+
+  /*!
+   * \brief queue a frame for filtering, nullptr signals end of stream
+   * The reference is moved out of frame. Blocks while MAX_INPUT frames are queued.
+   */
+  void AddFrame(AVFrame* frame);
+
+  /*!
+   * \brief get the next filtered frame
+   * \param wait block until a frame is ready or the queued input is filtered
+   * \return VC_PICTURE with a frame, VC_EOF if the graph signaled eof,
+   * VC_ERROR if filtering failed and VC_BUFFER otherwise
+   */
+  CDVDVideoCodec::VCReturn GetFrame(AVFrame* frame, bool wait);
+
+  /*!
+   * \brief number of frames queued or being filtered plus ready frames
+   */
+  unsigned int GetPending();
+
+  static const unsigned int MAX_INPUT = 4;
+
+protected:
+  void Process() override;
+
+private:
+  void Flush(CSingleLock& lock);
+  void ClearQueue(std::deque<AVFrame*>& queue);
+
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_inputCond;
+  XbmcThreads::ConditionVariable m_outputCond;
+
+  std::deque<AVFrame*> m_input; // nullptr is end of stream
+  std::deque<AVFrame*> m_output;
+  std::deque<AVFrame*> m_unused; // empty frames for reuse
+  bool m_busy = false;
+  bool m_eof = false;
+  bool m_error = false;
+
+  AVFilterContext* m_filterIn = nullptr;
+  AVFilterContext* m_filterOut = nullptr;
+};
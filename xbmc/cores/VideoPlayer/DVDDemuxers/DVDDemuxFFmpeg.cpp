@@ -1000,23 +1000,29 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
 
       if (IsVideoReady())
       {
+        bool inProgram = true;
         if (m_program != UINT_MAX)
         {
           /* check so packet belongs to selected program */
+          inProgram = false;
           for (unsigned int i = 0; i < m_pFormatContext->programs[m_program]->nb_stream_indexes; i++)
           {
             if (m_pkt.pkt.stream_index == (int)m_pFormatContext->programs[m_program]->stream_index[i])
             {
-              pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+              inProgram = true;
               break;
             }
           }
-
-          if (!pPacket)
-            bReturnEmpty = true;
         }
-        else
-          pPacket = CDVDDemuxUtils::AllocateDemuxPacket(m_pkt.pkt.size);
+
+        // take the payload into our own packet, either by reference or by copy
+        if (inProgram)
+          pPacket = CDVDDemuxUtils::AllocateDemuxPacket(
+              &m_pkt.pkt,
+              CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoDemuxZeroCopy);
+
+        if (!pPacket)
+          bReturnEmpty = true;
       }
       else
         bReturnEmpty = true;
@@ -1030,13 +1036,6 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
           m_pkt.pkt.pts = AV_NOPTS_VALUE;
         }
 
-        // copy contents into our own packet
-        pPacket->iSize = m_pkt.pkt.size;
-
-        // maybe we can avoid a memcpy here by detecting where pkt.destruct is pointing too?
-        if (m_pkt.pkt.data)
-          memcpy(pPacket->pData, m_pkt.pkt.data, pPacket->iSize);
-
         pPacket->pts = ConvertTimestamp(m_pkt.pkt.pts, stream->time_base.den, stream->time_base.num);
         pPacket->dts = ConvertTimestamp(m_pkt.pkt.dts, stream->time_base.den, stream->time_base.num);
         pPacket->duration =  DVD_SEC_TO_TIME((double)m_pkt.pkt.duration * stream->time_base.num / stream->time_base.den);
@@ -8,34 +8,144 @@
 
 #include "DVDDemuxUtils.h"
 #include "cores/VideoPlayer/Interface/Addon/DemuxCrypto.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/MemUtils.h"
 
+#include <vector>
+
 extern "C" {
 #include <libavcodec/avcodec.h>
 }
 
+namespace
+{
+
+struct DemuxPacketEx : public DemuxPacket
+{
+  int sizeClass = -1; // pool class of pData, -1 if it is not pooled
+  AVBufferRef* buffer = nullptr; // ffmpeg buffer pData points into
+};
+
+/*!
+ * Buffers are handed out in power of two size classes and kept for reuse
+ * when the packet is freed, at high bitrates this replaces hundreds of
+ * heap allocations per second with a lookup in a free list.
+ */
+class CPacketBufferPool
+{
+public:
+  ~CPacketBufferPool() { Clear(); }
+
+  uint8_t* Get(size_t size, int& sizeClass, bool& reused)
+  {
+    sizeClass = GetSizeClass(size);
+    reused = false;
+    if (sizeClass >= 0)
+    {
+      const size_t classSize = static_cast<size_t>(1) << (sizeClass + MIN_CLASS);
+      CSingleLock lock(m_section);
+      std::vector<uint8_t*>& buffers = m_free[sizeClass];
+      if (!buffers.empty())
+      {
+        uint8_t* data = buffers.back();
+        buffers.pop_back();
+        m_pooledBytes -= classSize;
+        reused = true;
+        return data;
+      }
+      size = classSize;
+    }
+
+    return static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(size, 16));
+  }
+
+  void Put(uint8_t* data, int sizeClass)
+  {
+    if (sizeClass >= 0)
+    {
+      const size_t classSize = static_cast<size_t>(1) << (sizeClass + MIN_CLASS);
+      CSingleLock lock(m_section);
+      std::vector<uint8_t*>& buffers = m_free[sizeClass];
+      if (buffers.size() < MAX_POOLED_BUFFERS && m_pooledBytes + classSize <= MAX_POOLED_BYTES)
+      {
+        buffers.push_back(data);
+        m_pooledBytes += classSize;
+        return;
+      }
+    }
+    KODI::MEMORY::AlignedFree(data);
+  }
+
+  void Clear()
+  {
+    CSingleLock lock(m_section);
+    for (auto& buffers : m_free)
+    {
+      for (auto data : buffers)
+        KODI::MEMORY::AlignedFree(data);
+      buffers.clear();
+    }
+    m_pooledBytes = 0;
+  }
+
+private:
+  static const int MIN_CLASS = 10; // 1 KiB
+  static const int MAX_CLASS = 23; // 8 MiB, enough for UHD key frames
+  static const size_t MAX_POOLED_BUFFERS = 256; // per class
+  static const size_t MAX_POOLED_BYTES = 32 * 1024 * 1024; // all classes together
+
+  static int GetSizeClass(size_t size)
+  {
+    int bits = MIN_CLASS;
+    while ((static_cast<size_t>(1) << bits) < size)
+    {
+      if (++bits > MAX_CLASS)
+        return -1;
+    }
+    return bits - MIN_CLASS;
+  }
+
+  CCriticalSection m_section;
+  std::vector<uint8_t*> m_free[MAX_CLASS - MIN_CLASS + 1];
+  size_t m_pooledBytes = 0;
+};
+
+CPacketBufferPool& GetPool()
+{
+  static CPacketBufferPool pool;
+  return pool;
+}
+
+thread_local CDVDDemuxUtils::CPacketCounters* threadCounters = nullptr;
+
+} // namespace
+
 void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
-    if (pPacket->pData)
-      KODI::MEMORY::AlignedFree(pPacket->pData);
-    if (pPacket->iSideDataElems)
+    DemuxPacketEx* packet = static_cast<DemuxPacketEx*>(pPacket);
+    if (packet->buffer)
+      av_buffer_unref(&packet->buffer);
+    else if (packet->pData)
+      GetPool().Put(packet->pData, packet->sizeClass);
+    if (packet->iSideDataElems)
     {
       AVPacket avPkt;
       av_init_packet(&avPkt);
-      avPkt.side_data = static_cast<AVPacketSideData*>(pPacket->pSideData);
-      avPkt.side_data_elems = pPacket->iSideDataElems;
+      avPkt.side_data = static_cast<AVPacketSideData*>(packet->pSideData);
+      avPkt.side_data_elems = packet->iSideDataElems;
       av_packet_free_side_data(&avPkt);
     }
-    delete pPacket;
+    delete packet;
   }
 }
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket();
+  DemuxPacketEx* pPacket = new DemuxPacketEx();
 
   if (iDataSize > 0)
   {
@@ -48,12 +158,20 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
      * Note, if the first 23 bits of the additional bytes are not 0 then damaged
      * MPEG bitstreams could cause overread and segfault
      */
-    pPacket->pData = static_cast<uint8_t*>(KODI::MEMORY::AlignedMalloc(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, 16));
+    bool reused;
+    pPacket->pData = GetPool().Get(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, pPacket->sizeClass, reused);
     if (!pPacket->pData)
     {
       FreeDemuxPacket(pPacket);
       return NULL;
     }
+    if (threadCounters)
+    {
+      if (reused)
+        threadCounters->m_reused++;
+      else
+        threadCounters->m_allocations++;
+    }
 
     // reset the last 8 bytes to 0;
     memset(pPacket->pData + iDataSize, 0, AV_INPUT_BUFFER_PADDING_SIZE);
@@ -70,6 +188,39 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(unsigned int iDataSize, unsigne
   return ret;
 }
 
+DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(AVPacket* src, bool zeroCopy)
+{
+  // refcounted ffmpeg packets are padded, they can go to the decoders as they are
+  if (zeroCopy && src->buf && src->data)
+  {
+    DemuxPacketEx* pPacket = new DemuxPacketEx();
+    pPacket->buffer = av_buffer_ref(src->buf);
+    if (!pPacket->buffer)
+    {
+      delete pPacket;
+      return NULL;
+    }
+    pPacket->pData = src->data;
+    pPacket->iSize = src->size;
+    if (threadCounters)
+      threadCounters->m_wrapped++;
+    return pPacket;
+  }
+
+  DemuxPacket* pPacket = AllocateDemuxPacket(src->size);
+  if (pPacket)
+  {
+    pPacket->iSize = src->size;
+    if (src->data)
+    {
+      memcpy(pPacket->pData, src->data, src->size);
+      if (threadCounters)
+        threadCounters->m_copyBytes += src->size;
+    }
+  }
+  return pPacket;
+}
+
 void CDVDDemuxUtils::StoreSideData(DemuxPacket *pkt, AVPacket *src)
 {
   AVPacket avPkt;
@@ -78,3 +229,23 @@ void CDVDDemuxUtils::StoreSideData(DemuxPacket *pkt, AVPacket *src)
   pkt->pSideData = avPkt.side_data;
   pkt->iSideDataElems = avPkt.side_data_elems;
 }
+
+CDVDDemuxUtils::SPacketStats CDVDDemuxUtils::CPacketCounters::Get() const
+{
+  SPacketStats stats;
+  stats.allocations = m_allocations;
+  stats.reused = m_reused;
+  stats.wrapped = m_wrapped;
+  stats.copyBytes = m_copyBytes;
+  return stats;
+}
+
+void CDVDDemuxUtils::SetThreadPacketCounters(CPacketCounters* counters)
+{
+  threadCounters = counters;
+}
+
+void CDVDDemuxUtils::ClearPacketPool()
+{
+  GetPool().Clear();
+}
@@ -9,6 +9,9 @@
 #pragma once
 
 #include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
+
+#include <atomic>
+
 extern "C" {
 #include <libavcodec/avcodec.h>
 }
@@ -19,6 +22,51 @@ public:
   static void FreeDemuxPacket(DemuxPacket* pPacket);
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
   static DemuxPacket* AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount);
+
+  /*!
+   \brief allocate a packet holding the payload of an ffmpeg packet
+   \param src packet to take the payload from, it is not modified
+   \param zeroCopy reference the buffer of src instead of copying it if it is refcounted
+   */
+  static DemuxPacket* AllocateDemuxPacket(AVPacket* src, bool zeroCopy);
   static void StoreSideData(DemuxPacket *pkt, AVPacket *src);
-};
 
+  /*!
+   \brief snapshot of packet counters
+   */
+  struct SPacketStats
+  {
+    uint64_t allocations = 0; // buffers allocated from the heap
+    uint64_t reused = 0; // buffers taken from the pool
+    uint64_t wrapped = 0; // packets referencing an ffmpeg buffer
+    uint64_t copyBytes = 0; // payload bytes copied from ffmpeg packets
+  };
+
+  /*!
+   \brief counters of the packets allocated by the threads they are set for
+   */
+  class CPacketCounters
+  {
+  public:
+    SPacketStats Get() const;
+
+  private:
+    friend class CDVDDemuxUtils;
+    std::atomic<uint64_t> m_allocations{0};
+    std::atomic<uint64_t> m_reused{0};
+    std::atomic<uint64_t> m_wrapped{0};
+    std::atomic<uint64_t> m_copyBytes{0};
+  };
+
+  /*!
+   \brief count the packets allocated by the calling thread in counters
+   \param counters the counters, or nullptr to stop counting. They have to
+   outlive the thread or be reset before they are destroyed.
+   */
+  static void SetThreadPacketCounters(CPacketCounters* counters);
+
+  /*!
+   \brief release all buffers kept for reuse
+   */
+  static void ClearPacketPool();
+};
@@ -14,6 +14,32 @@
 #include "utils/log.h"
 
 #include <math.h>
+#include <thread>
+
+namespace
+{
+
+DemuxPacket* GetPacket(CDVDMsg* msg)
+{
+  if (msg->IsType(CDVDMsg::DEMUXER_PACKET))
+    return static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket();
+  return nullptr;
+}
+
+double GetTimestamp(CDVDMsg* msg)
+{
+  DemuxPacket* packet = GetPacket(msg);
+  if (packet)
+  {
+    if (packet->dts != DVD_NOPTS_VALUE)
+      return packet->dts;
+    else if (packet->pts != DVD_NOPTS_VALUE)
+      return packet->pts;
+  }
+  return DVD_NOPTS_VALUE;
+}
+
+} // namespace
 
 CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
 {
@@ -25,6 +51,9 @@ CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m
   m_TimeFront = DVD_NOPTS_VALUE;
   m_TimeSize = 1.0 / 4.0; /* 4 seconds */
   m_iMaxDataSize = 0;
+
+  m_inboxHead = &m_inboxStub;
+  m_inboxTail = &m_inboxStub;
 }
 
 CDVDMessageQueue::~CDVDMessageQueue()
@@ -47,17 +76,43 @@ void CDVDMessageQueue::Flush(CDVDMsg::Message type)
 {
   CSingleLock lock(m_section);
 
-  m_messages.remove_if([type](const DVDMessageListItem &item){
-    return type == CDVDMsg::NONE || item.message->IsType(type);
-  });
+  DrainInbox();
+
+  for (NodeList* list : {&m_messages, &m_prioMessages})
+  {
+    Node* prev = nullptr;
+    Node* node = list->first;
+    while (node)
+    {
+      Node* next = node->next;
+      if (type == CDVDMsg::NONE || node->message->IsType(type))
+      {
+        if (prev)
+          prev->next = next;
+        else
+          list->first = next;
+        if (list->last == node)
+          list->last = prev;
+
+        if (list == &m_messages)
+        {
+          DemuxPacket* packet = GetPacket(node->message);
+          if (packet)
+            m_iDataSize -= packet->iSize;
+          m_count--;
+        }
 
-  m_prioMessages.remove_if([type](const DVDMessageListItem &item){
-    return type == CDVDMsg::NONE || item.message->IsType(type);
-  });
+        node->message->Release();
+        FreeNode(node);
+      }
+      else
+        prev = node;
+      node = next;
+    }
+  }
 
   if (type == CDVDMsg::DEMUXER_PACKET ||  type == CDVDMsg::NONE)
   {
-    m_iDataSize = 0;
     m_TimeBack = DVD_NOPTS_VALUE;
     m_TimeFront = DVD_NOPTS_VALUE;
   }
@@ -80,7 +135,6 @@ void CDVDMessageQueue::End()
   Flush(CDVDMsg::NONE);
 
   m_bInitialized = false;
-  m_iDataSize = 0;
   m_bAbortRequest = false;
 }
 
@@ -96,8 +150,6 @@ MsgQueueReturnCode CDVDMessageQueue::PutBack(CDVDMsg* pMsg, int priority)
 
 MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front)
 {
-  CSingleLock lock(m_section);
-
   if (!m_bInitialized)
   {
     CLog::Log(LOGWARNING, "CDVDMessageQueue(%s)::Put MSGQ_NOT_INITIALIZED", m_owner.c_str());
@@ -110,50 +162,75 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
     return MSGQ_INVALID_MSG;
   }
 
+  Node* node = AllocNode();
+  node->message = pMsg;
+  node->priority = priority;
+  node->next = nullptr;
+
   if (priority > 0)
   {
     int prio = priority;
     if (!front)
       prio++;
 
-    auto it = std::find_if(m_prioMessages.begin(), m_prioMessages.end(),
-                           [prio](const DVDMessageListItem &item){
-                             return prio <= item.priority;
-                           });
-    m_prioMessages.emplace(it, pMsg, priority);
+    CSingleLock lock(m_section);
+
+    // highest priority first, fifo within a priority unless put back
+    Node** it = &m_prioMessages.first;
+    while (*it && (*it)->priority >= prio)
+      it = &(*it)->next;
+    node->next = *it;
+    *it = node;
+    if (!node->next)
+      m_prioMessages.last = node;
+
+    m_hEvent.Set();
+    return MSGQ_OK;
   }
-  else
+
+  // the accounting is done before the message can be taken out again
+  const bool wasEmpty = m_count++ == 0;
+  DemuxPacket* packet = GetPacket(pMsg);
+  if (packet)
+    m_iDataSize += packet->iSize;
+
+  if (!front)
   {
-    if (m_messages.empty())
-    {
-      m_iDataSize = 0;
-      m_TimeBack = DVD_NOPTS_VALUE;
+    CSingleLock lock(m_section);
+
+    if (wasEmpty)
       m_TimeFront = DVD_NOPTS_VALUE;
-    }
 
-    if (front)
-      m_messages.emplace_front(pMsg, priority);
-    else
-      m_messages.emplace_back(pMsg, priority);
+    node->next = m_messages.first;
+    m_messages.first = node;
+    if (!m_messages.last)
+      m_messages.last = node;
+
+    UpdateTimeBack();
+
+    m_hEvent.Set();
+    return MSGQ_OK;
   }
 
-  if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
+  if (wasEmpty)
   {
-    DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(pMsg)->GetPacket();
-    if (packet)
-    {
-      m_iDataSize += packet->iSize;
-      if (front)
-        UpdateTimeFront();
-      else
-        UpdateTimeBack();
-    }
+    m_TimeFront = DVD_NOPTS_VALUE;
+    m_TimeBack = DVD_NOPTS_VALUE;
   }
 
-  pMsg->Release();
+  const double timestamp = GetTimestamp(pMsg);
+  if (timestamp != DVD_NOPTS_VALUE)
+  {
+    m_TimeFront = timestamp;
+    double nopts = DVD_NOPTS_VALUE;
+    m_TimeBack.compare_exchange_strong(nopts, timestamp);
+  }
 
-  // inform waiter for new packet
-  m_hEvent.Set();
+  PushInbox(node);
+
+  // inform waiter for new packet, the consumer announces when it is about to sleep
+  if (m_waiting)
+    m_hEvent.Set();
 
   return MSGQ_OK;
 }
@@ -174,24 +251,29 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
+    DrainInbox();
+
+    NodeList& msgs = (priority > 0 || m_prioMessages.first) ? m_prioMessages : m_messages;
 
-    if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
+    if (msgs.first && (msgs.first->priority >= priority || m_drain))
     {
-      DVDMessageListItem& item(msgs.back());
-      priority = item.priority;
+      Node* node = msgs.first;
+      msgs.first = node->next;
+      if (!msgs.first)
+        msgs.last = nullptr;
+
+      priority = node->priority;
 
-      if (item.message->IsType(CDVDMsg::DEMUXER_PACKET) && item.priority == 0)
+      if (&msgs == &m_messages)
       {
-        DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
+        DemuxPacket* packet = GetPacket(node->message);
         if (packet)
-        {
           m_iDataSize -= packet->iSize;
-        }
+        m_count--;
       }
 
-      *pMsg = item.message->Acquire();
-      msgs.pop_back();
+      *pMsg = node->message;
+      FreeNode(node);
       UpdateTimeBack();
       ret = MSGQ_OK;
       break;
@@ -203,11 +285,25 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     }
     else
     {
+      // producers only signal the event while we wait, check the inbox
+      // once more after announcing it to not miss a message
+      m_waiting = true;
       m_hEvent.Reset();
+      if (m_inboxHead.load() != &m_inboxStub)
+      {
+        m_waiting = false;
+        lock.Leave();
+        std::this_thread::yield();
+        lock.Enter();
+        continue;
+      }
+
       lock.Leave();
 
       // wait for a new message
-      if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
+      bool signaled = m_hEvent.WaitMSec(iTimeoutInMilliSeconds);
+      m_waiting = false;
+      if (!signaled)
         return MSGQ_TIMEOUT;
 
       lock.Enter();
@@ -220,47 +316,155 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
   return (MsgQueueReturnCode)ret;
 }
 
-void CDVDMessageQueue::UpdateTimeFront()
+void CDVDMessageQueue::UpdateTimeBack()
 {
-  if (!m_messages.empty())
+  if (m_messages.first)
   {
-    auto &item = m_messages.front();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+    const double timestamp = GetTimestamp(m_messages.first->message);
+    if (timestamp != DVD_NOPTS_VALUE)
     {
-      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
-      if (packet)
-      {
-        if (packet->dts != DVD_NOPTS_VALUE)
-          m_TimeFront = packet->dts;
-        else if (packet->pts != DVD_NOPTS_VALUE)
-          m_TimeFront = packet->pts;
+      m_TimeBack = timestamp;
 
-        if (m_TimeBack == DVD_NOPTS_VALUE)
-          m_TimeBack = m_TimeFront;
-      }
+      double nopts = DVD_NOPTS_VALUE;
+      m_TimeFront.compare_exchange_strong(nopts, timestamp);
     }
   }
 }
 
-void CDVDMessageQueue::UpdateTimeBack()
+CDVDMessageQueue::Node* CDVDMessageQueue::AllocNode()
 {
-  if (!m_messages.empty())
+  uint64_t head = m_freeHead.load(std::memory_order_acquire);
+  while (true)
   {
-    auto &item = m_messages.back();
-    if (item.message->IsType(CDVDMsg::DEMUXER_PACKET))
+    const uint32_t index = static_cast<uint32_t>(head);
+    if (!index)
     {
-      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(item.message)->GetPacket();
-      if (packet)
+      if (!GrowPool())
       {
-        if (packet->dts != DVD_NOPTS_VALUE)
-          m_TimeBack = packet->dts;
-        else if (packet->pts != DVD_NOPTS_VALUE)
-          m_TimeBack = packet->pts;
-
-        if (m_TimeFront == DVD_NOPTS_VALUE)
-          m_TimeFront = m_TimeBack;
+        // more messages than the pool can ever hold, don't fail the put
+        Node* node = new Node;
+        node->index = HEAP_NODE;
+        return node;
       }
+      head = m_freeHead.load(std::memory_order_acquire);
+      continue;
     }
+
+    // the node may be taken by another thread meanwhile, the tag makes the exchange fail then
+    Node* node = &m_chunks[(index - 1) / CHUNK_NODES][(index - 1) % CHUNK_NODES];
+    const uint64_t next = (((head >> 32) + 1) << 32) | node->freeNext.load(std::memory_order_relaxed);
+    if (m_freeHead.compare_exchange_weak(head, next, std::memory_order_acq_rel,
+                                         std::memory_order_acquire))
+      return node;
+  }
+}
+
+void CDVDMessageQueue::FreeNode(Node* node)
+{
+  if (node->index == HEAP_NODE)
+  {
+    delete node;
+    return;
+  }
+
+  node->message = nullptr;
+
+  uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+  uint64_t next;
+  do
+  {
+    node->freeNext.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    next = (((head >> 32) + 1) << 32) | (node->index + 1);
+  } while (!m_freeHead.compare_exchange_weak(head, next, std::memory_order_release,
+                                             std::memory_order_relaxed));
+}
+
+bool CDVDMessageQueue::GrowPool()
+{
+  CSingleLock lock(m_poolSection);
+
+  // another producer may have grown it already
+  if (static_cast<uint32_t>(m_freeHead.load(std::memory_order_acquire)))
+    return true;
+
+  if (m_chunkCount == MAX_CHUNKS)
+    return false;
+
+  const uint32_t chunk = m_chunkCount++;
+  m_chunks[chunk].reset(new Node[CHUNK_NODES]);
+  Node* nodes = m_chunks[chunk].get();
+  for (uint32_t i = 0; i < CHUNK_NODES; i++)
+  {
+    nodes[i].index = chunk * CHUNK_NODES + i;
+    nodes[i].freeNext.store(i + 1 < CHUNK_NODES ? nodes[i].index + 2 : 0,
+                            std::memory_order_relaxed);
+  }
+
+  // link the new nodes in front of whatever got freed meanwhile
+  Node* last = &nodes[CHUNK_NODES - 1];
+  uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+  uint64_t next;
+  do
+  {
+    last->freeNext.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    next = (((head >> 32) + 1) << 32) | (nodes[0].index + 1);
+  } while (!m_freeHead.compare_exchange_weak(head, next, std::memory_order_release,
+                                             std::memory_order_relaxed));
+
+  return true;
+}
+
+void CDVDMessageQueue::PushInbox(Node* node)
+{
+  node->inboxNext.store(nullptr, std::memory_order_relaxed);
+  Node* prev = m_inboxHead.exchange(node);
+  prev->inboxNext.store(node, std::memory_order_release);
+}
+
+CDVDMessageQueue::Node* CDVDMessageQueue::PopInbox()
+{
+  Node* tail = m_inboxTail;
+  Node* next = tail->inboxNext.load(std::memory_order_acquire);
+  if (tail == &m_inboxStub)
+  {
+    if (!next)
+      return nullptr;
+    m_inboxTail = next;
+    tail = next;
+    next = next->inboxNext.load(std::memory_order_acquire);
+  }
+
+  if (next)
+  {
+    m_inboxTail = next;
+    return tail;
+  }
+
+  // a producer is between exchanging the head and linking its node
+  if (tail != m_inboxHead.load())
+    return nullptr;
+
+  PushInbox(&m_inboxStub);
+
+  next = tail->inboxNext.load(std::memory_order_acquire);
+  if (next)
+  {
+    m_inboxTail = next;
+    return tail;
+  }
+  return nullptr;
+}
+
+void CDVDMessageQueue::DrainInbox()
+{
+  while (Node* node = PopInbox())
+  {
+    node->next = nullptr;
+    if (m_messages.last)
+      m_messages.last->next = node;
+    else
+      m_messages.first = node;
+    m_messages.last = node;
   }
 }
 
@@ -271,15 +475,17 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
   if (!m_bInitialized)
     return 0;
 
+  DrainInbox();
+
   unsigned count = 0;
-  for (const auto &item : m_messages)
+  for (Node* node = m_messages.first; node; node = node->next)
   {
-    if(item.message->IsType(type))
+    if (node->message->IsType(type))
       count++;
   }
-  for (const auto &item : m_prioMessages)
+  for (Node* node = m_prioMessages.first; node; node = node->next)
   {
-    if(item.message->IsType(type))
+    if (node->message->IsType(type))
       count++;
   }
 
@@ -288,10 +494,7 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
 
 void CDVDMessageQueue::WaitUntilEmpty()
 {
-  {
-    CSingleLock lock(m_section);
-    m_drain = true;
-  }
+  m_drain = true;
 
   CLog::Log(LOGNOTICE, "CDVDMessageQueue(%s)::WaitUntilEmpty", m_owner.c_str());
   CDVDMsgGeneralSynchronize* msg = new CDVDMsgGeneralSynchronize(40000, SYNCSOURCE_ANY);
@@ -299,30 +502,27 @@ void CDVDMessageQueue::WaitUntilEmpty()
   msg->Wait(m_bAbortRequest, 0);
   msg->Release();
 
-  {
-    CSingleLock lock(m_section);
-    m_drain = false;
-  }
+  m_drain = false;
 }
 
 int CDVDMessageQueue::GetLevel() const
 {
-  CSingleLock lock(m_section);
+  const int dataSize = m_iDataSize;
 
-  if (m_iDataSize > m_iMaxDataSize)
+  if (dataSize > m_iMaxDataSize)
     return 100;
-  if (m_iDataSize == 0)
+  if (dataSize == 0)
     return 0;
 
   if (IsDataBased())
   {
-    return std::min(100, 100 * m_iDataSize / m_iMaxDataSize);
+    return std::min(100, 100 * dataSize / m_iMaxDataSize);
   }
 
   int level = std::min(100.0, ceil(100.0 * m_TimeSize * (m_TimeFront - m_TimeBack) / DVD_TIME_BASE ));
 
   // if we added lots of packets with NOPTS, make sure that the queue is not signalled empty
-  if (level == 0 && m_iDataSize != 0)
+  if (level == 0 && dataSize != 0)
   {
     CLog::Log(LOGDEBUG, "CDVDMessageQueue::GetLevel() - can't determine level");
     return 1;
@@ -333,8 +533,6 @@ int CDVDMessageQueue::GetLevel() const
 
 int CDVDMessageQueue::GetTimeSize() const
 {
-  CSingleLock lock(m_section);
-
   if (IsDataBased())
     return 0;
   else
@@ -343,7 +541,9 @@ int CDVDMessageQueue::GetTimeSize() const
 
 bool CDVDMessageQueue::IsDataBased() const
 {
-  return (m_TimeBack == DVD_NOPTS_VALUE  ||
-          m_TimeFront == DVD_NOPTS_VALUE ||
-          m_TimeFront <= m_TimeBack);
+  const double timeBack = m_TimeBack;
+  const double timeFront = m_TimeFront;
+  return (timeBack == DVD_NOPTS_VALUE  ||
+          timeFront == DVD_NOPTS_VALUE ||
+          timeFront <= timeBack);
 }
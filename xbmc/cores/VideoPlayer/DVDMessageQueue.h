@@ -14,34 +14,10 @@
 
 #include <algorithm>
 #include <atomic>
-#include <list>
+#include <cstdint>
+#include <memory>
 #include <string>
 
-struct DVDMessageListItem
-{
-  DVDMessageListItem(CDVDMsg* msg, int prio)
-  {
-    message = msg->Acquire();
-    priority = prio;
-  }
-  DVDMessageListItem()
-  {
-    message = NULL;
-    priority = 0;
-  }
-  DVDMessageListItem(const DVDMessageListItem&) = delete;
- ~DVDMessageListItem()
-  {
-    if(message)
-      message->Release();
-  }
-
-  DVDMessageListItem& operator=(const DVDMessageListItem&) = delete;
-
-  CDVDMsg* message;
-  int priority;
-};
-
 enum MsgQueueReturnCode
 {
   MSGQ_OK = 1,
@@ -54,6 +30,15 @@ enum MsgQueueReturnCode
 
 #define MSGQ_IS_ERROR(c)    (c < 0)
 
+/*!
+ * \brief Message queue between VideoPlayer and its stream players
+ *
+ * Normal messages are put into a lock-free MPSC inbox, so producers never
+ * take a lock or allocate: list nodes come from a per queue pool that only
+ * grows when more messages are queued than ever before, up to 64k nodes. The consumer moves
+ * the inbox into its own list when it gets a message. Priority messages,
+ * PutBack and Flush are rare and go through m_section.
+ */
 class CDVDMessageQueue
 {
 public:
@@ -98,27 +83,64 @@ public:
   bool IsDataBased() const;
 
 private:
+  struct Node
+  {
+    CDVDMsg* message = nullptr;
+    int priority = 0;
+    Node* next = nullptr; // consumer lists, m_section held
+    std::atomic<Node*> inboxNext{nullptr};
+    std::atomic<uint32_t> freeNext{0}; // index + 1 of the next free node, 0 for none
+    uint32_t index = 0;
+  };
+
+  //! singly linked list, first is the next message to get
+  struct NodeList
+  {
+    Node* first = nullptr;
+    Node* last = nullptr;
+  };
+
+  static const uint32_t CHUNK_NODES = 256;
+  static const uint32_t MAX_CHUNKS = 256;
+  static const uint32_t HEAP_NODE = UINT32_MAX; // index of nodes allocated beyond the pool
 
   MsgQueueReturnCode Put(CDVDMsg* pMsg, int priority, bool front);
-  void UpdateTimeFront();
+  Node* AllocNode();
+  void FreeNode(Node* node);
+  bool GrowPool();
+  void PushInbox(Node* node);
+  Node* PopInbox();
+  void DrainInbox();
   void UpdateTimeBack();
 
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
 
   std::atomic<bool> m_bAbortRequest;
-  bool m_bInitialized;
-  bool m_drain = false;
-
-  int m_iDataSize;
-  double m_TimeFront;
-  double m_TimeBack;
+  std::atomic<bool> m_bInitialized;
+  std::atomic<bool> m_drain{false};
+  std::atomic<bool> m_waiting{false};
+
+  std::atomic<int> m_iDataSize;
+  std::atomic<int> m_count{0}; // normal messages, including the inbox
+  std::atomic<double> m_TimeFront;
+  std::atomic<double> m_TimeBack;
   double m_TimeSize;
 
   int m_iMaxDataSize;
   std::string m_owner;
 
-  std::list<DVDMessageListItem> m_messages;
-  std::list<DVDMessageListItem> m_prioMessages;
-};
+  // inbox, Vyukov's intrusive MPSC queue, popped with m_section held
+  std::atomic<Node*> m_inboxHead;
+  Node* m_inboxTail;
+  Node m_inboxStub;
 
+  NodeList m_messages;
+  NodeList m_prioMessages;
+
+  // node pool, the free list head is a tagged index to rule out ABA
+  std::atomic<uint64_t> m_freeHead{0};
+  std::unique_ptr<Node[]> m_chunks[MAX_CHUNKS];
+  uint32_t m_chunkCount = 0;
+  CCriticalSection m_poolSection;
+};
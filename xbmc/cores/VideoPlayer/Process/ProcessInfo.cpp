@@ -656,6 +656,42 @@ int64_t CProcessInfo::GetMaxTime()
   return m_timeMax;
 }
 
+//******************************************************************************
+// demuxer
+//******************************************************************************
+void CProcessInfo::SetDemuxPacketStats(const CDataCacheCore::SDemuxPacketStats& stats)
+{
+  CSingleLock lock(m_demuxSection);
+  m_demuxPacketStats = stats;
+
+  if (m_dataCache)
+    m_dataCache->SetDemuxPacketStats(stats);
+}
+
+CDataCacheCore::SDemuxPacketStats CProcessInfo::GetDemuxPacketStats()
+{
+  CSingleLock lock(m_demuxSection);
+  return m_demuxPacketStats;
+}
+
+//******************************************************************************
+// video buffers
+//******************************************************************************
+void CProcessInfo::SetVideoBufferStats(const CDataCacheCore::SVideoBufferStats& stats)
+{
+  CSingleLock lock(m_videoBufferSection);
+  m_videoBufferStats = stats;
+
+  if (m_dataCache)
+    m_dataCache->SetVideoBufferStats(stats);
+}
+
+CDataCacheCore::SVideoBufferStats CProcessInfo::GetVideoBufferStats()
+{
+  CSingleLock lock(m_videoBufferSection);
+  return m_videoBufferStats;
+}
+
 //******************************************************************************
 // settings
 //******************************************************************************
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "VideoBuffer.h"
+#include "cores/DataCacheCore.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderInfo.h"
 #include "cores/VideoSettings.h"
 #include "threads/CriticalSection.h"
@@ -19,7 +20,6 @@
 #include <string>
 
 class CProcessInfo;
-class CDataCacheCore;
 
 using CreateProcessControl = CProcessInfo* (*)();
 
@@ -106,6 +106,14 @@ public:
   void SetPlayTimes(time_t start, int64_t current, int64_t min, int64_t max);
   int64_t GetMaxTime();
 
+  // demuxer
+  void SetDemuxPacketStats(const CDataCacheCore::SDemuxPacketStats& stats);
+  CDataCacheCore::SDemuxPacketStats GetDemuxPacketStats();
+
+  // video buffers
+  void SetVideoBufferStats(const CDataCacheCore::SVideoBufferStats& stats);
+  CDataCacheCore::SVideoBufferStats GetVideoBufferStats();
+
   // settings
   CVideoSettings GetVideoSettings();
   void SetVideoSettings(CVideoSettings &settings);
@@ -165,6 +173,14 @@ protected:
   int64_t m_timeMin;
   bool m_realTimeStream;
 
+  // demuxer
+  CCriticalSection m_demuxSection;
+  CDataCacheCore::SDemuxPacketStats m_demuxPacketStats;
+
+  // video buffers
+  CCriticalSection m_videoBufferSection;
+  CDataCacheCore::SVideoBufferStats m_videoBufferStats;
+
   // settings
   CCriticalSection m_settingsSection;
   CVideoSettings m_videoSettings;
@@ -1306,6 +1306,7 @@ void CVideoPlayer::Prepare()
 void CVideoPlayer::Process()
 {
   CServiceBroker::GetWinSystem()->RegisterRenderLoop(this);
+  CDVDDemuxUtils::SetThreadPacketCounters(&m_demuxPacketCounters);
 
   Prepare();
 
@@ -2442,6 +2443,10 @@ void CVideoPlayer::OnExit()
 
   m_messenger.End();
 
+  // give back the demux buffers kept for reuse
+  CDVDDemuxUtils::ClearPacketPool();
+  CDVDDemuxUtils::SetThreadPacketCounters(nullptr);
+
   CFFmpegLog::ClearLogLevel();
   m_bStop = true;
 
@@ -4706,11 +4711,34 @@ void CVideoPlayer::UpdatePlayState(double timeout)
   }
 
   m_processInfo->SetPlayTimes(state.startTime, state.time, state.timeMin, state.timeMax);
+  UpdateDemuxPacketStats();
 
   CSingleLock lock(m_StateSection);
   m_State = state;
 }
 
+void CVideoPlayer::UpdateDemuxPacketStats()
+{
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  unsigned int elapsed = now - m_demuxStatsTime;
+  if (m_demuxStatsTime && elapsed < 1000)
+    return;
+
+  CDVDDemuxUtils::SPacketStats stats = m_demuxPacketCounters.Get();
+  if (m_demuxStatsTime)
+  {
+    CDataCacheCore::SDemuxPacketStats rates;
+    rates.allocations = static_cast<unsigned int>((stats.allocations - m_demuxStats.allocations) * 1000 / elapsed);
+    rates.reused = static_cast<unsigned int>((stats.reused - m_demuxStats.reused) * 1000 / elapsed);
+    rates.wrapped = static_cast<unsigned int>((stats.wrapped - m_demuxStats.wrapped) * 1000 / elapsed);
+    rates.copyBytes = (stats.copyBytes - m_demuxStats.copyBytes) * 1000 / elapsed;
+    m_processInfo->SetDemuxPacketStats(rates);
+  }
+
+  m_demuxStats = stats;
+  m_demuxStatsTime = now;
+}
+
 int64_t CVideoPlayer::GetUpdatedTime()
 {
   UpdatePlayState(0);
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "DVDClock.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
 #include "DVDMessageQueue.h"
 #include "Edl.h"
 #include "FileItem.h"
@@ -427,6 +428,7 @@ protected:
   void OpenDefaultStreams(bool reset = true);
 
   void UpdatePlayState(double timeout);
+  void UpdateDemuxPacketStats();
   void GetGeneralInfo(std::string& strVideoInfo);
   int64_t GetUpdatedTime();
   int64_t GetTime();
@@ -529,6 +531,10 @@ protected:
   mutable CCriticalSection m_StateSection;
   XbmcThreads::EndTime m_syncTimer;
 
+  CDVDDemuxUtils::CPacketCounters m_demuxPacketCounters; // of the packets demuxed by this player
+  CDVDDemuxUtils::SPacketStats m_demuxStats;
+  unsigned int m_demuxStatsTime = 0;
+
   CEdl m_Edl;
   bool m_SkipCommercials;
 
@@ -84,6 +84,7 @@ CVideoPlayerVideo::~CVideoPlayerVideo()
 {
   m_bAbortOutput = true;
   StopThread();
+  ClearPackets();
 }
 
 double CVideoPlayerVideo::GetOutputDelay()
@@ -217,7 +218,7 @@ void CVideoPlayerVideo::OpenStream(CDVDStreamInfo &hint, CDVDVideoCodec* codec)
   m_hints = hint;
   m_stalled = m_messageQueue.GetPacketCount(CDVDMsg::DEMUXER_PACKET) == 0;
   m_rewindStalled = false;
-  m_packets.clear();
+  ClearPackets();
   m_syncState = IDVDStreamPlayer::SYNC_STARTING;
   m_renderManager.ShowVideo(false);
 }
@@ -430,7 +431,7 @@ void CVideoPlayerVideo::Process()
         m_picture.videoBuffer->Release();
         m_picture.videoBuffer = nullptr;
       }
-      m_packets.clear();
+      ClearPackets();
       m_droppingStats.Reset();
       m_syncState = IDVDStreamPlayer::SYNC_STARTING;
       m_renderManager.ShowVideo(false);
@@ -446,7 +447,7 @@ void CVideoPlayerVideo::Process()
         m_picture.videoBuffer->Release();
         m_picture.videoBuffer = nullptr;
       }
-      m_packets.clear();
+      ClearPackets();
       pts = 0;
       m_rewindStalled = false;
 
@@ -564,10 +565,13 @@ void CVideoPlayerVideo::Process()
         // buffer packets so we can recover should decoder flush for some reason
         if (m_pVideoCodec->GetConvergeCount() > 0)
         {
-          m_packets.emplace_back(pMsg, 0);
+          m_packets.push_back(static_cast<CDVDMsgDemuxerPacket*>(pMsg->Acquire()));
           if (m_packets.size() > m_pVideoCodec->GetConvergeCount() ||
               m_packets.size() * frametime > DVD_SEC_TO_TIME(10))
+          {
+            m_packets.front()->Release();
             m_packets.pop_front();
+          }
         }
 
         m_videoStats.AddSampleBytes(pPacket->iSize);
@@ -602,16 +606,9 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
   if (decoderState == CDVDVideoCodec::VC_FLUSHED)
   {
     CLog::Log(LOGDEBUG, "CVideoPlayerVideo - video decoder was flushed");
-    while (!m_packets.empty())
-    {
-      CDVDMsgDemuxerPacket* msg = static_cast<CDVDMsgDemuxerPacket*>(m_packets.front().message->Acquire());
-      m_packets.pop_front();
-
-      SendMessage(msg, 10);
-    }
+    ResendPackets();
 
     m_pVideoCodec->Reset();
-    m_packets.clear();
     //picture.iFlags &= ~DVP_FLAG_ALLOCATED;
     m_renderManager.DiscardBuffer();
     return false;
@@ -619,15 +616,9 @@ bool CVideoPlayerVideo::ProcessDecoderOutput(double &frametime, double &pts)
 
   if (decoderState == CDVDVideoCodec::VC_REOPEN)
   {
-    while (!m_packets.empty())
-    {
-      CDVDMsgDemuxerPacket* msg = static_cast<CDVDMsgDemuxerPacket*>(m_packets.front().message->Acquire());
-      m_packets.pop_front();
-      SendMessage(msg, 10);
-    }
+    ResendPackets();
 
     m_pVideoCodec->Reopen();
-    m_packets.clear();
     m_renderManager.DiscardBuffer();
     return false;
   }
@@ -953,6 +944,21 @@ int CVideoPlayerVideo::GetVideoBitrate()
   return (int)m_videoStats.GetBitrate();
 }
 
+void CVideoPlayerVideo::ResendPackets()
+{
+  // the queue takes over the references of the packets
+  for (auto msg : m_packets)
+    SendMessage(msg, 10);
+  m_packets.clear();
+}
+
+void CVideoPlayerVideo::ClearPackets()
+{
+  for (auto msg : m_packets)
+    msg->Release();
+  m_packets.clear();
+}
+
 void CVideoPlayerVideo::ResetFrameRateCalc()
 {
   m_fStableFrameRate = 0.0;
@@ -20,6 +20,7 @@
 #include "utils/BitstreamStats.h"
 
 #include <atomic>
+#include <deque>
 
 #define DROP_DROPPED 1
 #define DROP_VERYLATE 2
@@ -91,6 +92,8 @@ protected:
   void Process() override;
 
   bool ProcessDecoderOutput(double &frametime, double &pts);
+  void ResendPackets();
+  void ClearPackets();
   void SendMessageBack(CDVDMsg* pMsg, int priority = 0);
   MsgQueueReturnCode GetMessage(CDVDMsg** pMsg, unsigned int iTimeoutInMilliSeconds, int &priority);
 
@@ -133,7 +136,7 @@ protected:
   CDVDStreamInfo m_hints;
   CDVDVideoCodec* m_pVideoCodec;
   CPtsTracker m_ptsTracker;
-  std::list<DVDMessageListItem> m_packets;
+  std::deque<CDVDMsgDemuxerPacket*> m_packets; // acquired, to resend should the decoder flush
   CDroppingStats m_droppingStats;
   CRenderManager& m_renderManager;
   VideoPicture m_picture;
@@ -0,0 +1,195 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+CDVDMsg* CreatePacket(int size, double dts)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+  packet->iSize = size;
+  packet->dts = dts;
+  return new CDVDMsgDemuxerPacket(packet);
+}
+
+CDVDMsg* CreateInt(int value, CDVDMsg::Message type = CDVDMsg::GENERAL_RESYNC)
+{
+  return new CDVDMsgInt(type, value);
+}
+
+int GetInt(CDVDMessageQueue& queue, int& priority)
+{
+  CDVDMsg* msg = nullptr;
+  if (queue.Get(&msg, 0, priority) != MSGQ_OK)
+    return -1;
+  int value = static_cast<CDVDMsgInt*>(msg)->m_value;
+  msg->Release();
+  return value;
+}
+
+int GetInt(CDVDMessageQueue& queue)
+{
+  int priority = 0;
+  return GetInt(queue, priority);
+}
+} // namespace
+
+TEST(TestDVDMessageQueue, Order)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(CreateInt(1));
+  queue.Put(CreateInt(2));
+  queue.PutBack(CreateInt(0));
+  queue.Put(CreateInt(10), 1);
+  queue.Put(CreateInt(20), 2);
+  queue.Put(CreateInt(11), 1);
+  queue.PutBack(CreateInt(12), 1);
+  queue.Put(CreateInt(3));
+
+  EXPECT_EQ(20, GetInt(queue));
+  EXPECT_EQ(12, GetInt(queue));
+  EXPECT_EQ(10, GetInt(queue));
+  EXPECT_EQ(11, GetInt(queue));
+  EXPECT_EQ(0, GetInt(queue));
+  EXPECT_EQ(1, GetInt(queue));
+  EXPECT_EQ(2, GetInt(queue));
+  EXPECT_EQ(3, GetInt(queue));
+  EXPECT_EQ(-1, GetInt(queue));
+
+  queue.End();
+}
+
+TEST(TestDVDMessageQueue, MinimumPriority)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(CreateInt(1));
+  queue.Put(CreateInt(2), 1);
+
+  int priority = 2;
+  EXPECT_EQ(-1, GetInt(queue, priority));
+  priority = 1;
+  EXPECT_EQ(2, GetInt(queue, priority));
+  EXPECT_EQ(1, priority);
+  EXPECT_EQ(-1, GetInt(queue, priority));
+  priority = 0;
+  EXPECT_EQ(1, GetInt(queue, priority));
+
+  queue.End();
+}
+
+TEST(TestDVDMessageQueue, Accounting)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+  queue.SetMaxDataSize(1000);
+  queue.SetMaxTimeSize(8.0);
+
+  EXPECT_EQ(0, queue.GetLevel());
+
+  for (int i = 0; i < 5; i++)
+    queue.Put(CreatePacket(10, i * DVD_TIME_BASE));
+  queue.Put(CreateInt(1, CDVDMsg::GENERAL_EOF));
+
+  EXPECT_EQ(50, queue.GetDataSize());
+  EXPECT_EQ(4, queue.GetTimeSize());
+  EXPECT_EQ(50, queue.GetLevel());
+  EXPECT_EQ(5u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  CDVDMsg* msg = nullptr;
+  ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+  msg->Release();
+  EXPECT_EQ(40, queue.GetDataSize());
+  EXPECT_EQ(3, queue.GetTimeSize());
+
+  queue.Flush();
+  EXPECT_EQ(0, queue.GetDataSize());
+  EXPECT_EQ(0, queue.GetLevel());
+  EXPECT_EQ(0u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(1u, queue.GetPacketCount(CDVDMsg::GENERAL_EOF));
+
+  queue.End();
+  EXPECT_EQ(0u, queue.GetPacketCount(CDVDMsg::GENERAL_EOF));
+}
+
+TEST(TestDVDMessageQueue, BlockingGet)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  std::thread producer([&queue]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.Put(CreateInt(7));
+  });
+
+  CDVDMsg* msg = nullptr;
+  EXPECT_EQ(MSGQ_OK, queue.Get(&msg, 5000));
+  ASSERT_NE(nullptr, msg);
+  EXPECT_EQ(7, static_cast<CDVDMsgInt*>(msg)->m_value);
+  msg->Release();
+  producer.join();
+
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(&msg, 10));
+
+  std::thread aborter([&queue]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.Abort();
+  });
+  EXPECT_EQ(MSGQ_ABORT, queue.Get(&msg, 5000));
+  aborter.join();
+
+  queue.End();
+}
+
+TEST(TestDVDMessageQueue, ConcurrentProducers)
+{
+  const int producers = 4;
+  const int messages = 20000;
+
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; p++)
+  {
+    threads.emplace_back([&queue, p]() {
+      for (int i = 0; i < messages; i++)
+        queue.Put(CreateInt(p * messages + i));
+    });
+  }
+
+  // every producer's messages arrive in order
+  std::vector<int> next(producers, 0);
+  for (int received = 0; received < producers * messages; received++)
+  {
+    CDVDMsg* msg = nullptr;
+    ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 5000));
+    int value = static_cast<CDVDMsgInt*>(msg)->m_value;
+    msg->Release();
+    int p = value / messages;
+    ASSERT_EQ(next[p], value % messages);
+    next[p]++;
+  }
+
+  for (auto& thread : threads)
+    thread.join();
+
+  EXPECT_EQ(0u, queue.GetPacketCount(CDVDMsg::GENERAL_RESYNC));
+  queue.End();
+}
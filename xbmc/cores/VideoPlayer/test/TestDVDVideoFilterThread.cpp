@@ -0,0 +1,298 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoFilterThread.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavfilter/avfilter.h>
+#include <libavfilter/buffersink.h>
+#include <libavfilter/buffersrc.h>
+#include <libavformat/avformat.h>
+#include <libavutil/frame.h>
+}
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// returns false when there are no more frames
+using FrameSource = std::function<bool(AVFrame*)>;
+
+class CFilterGraph
+{
+public:
+  ~CFilterGraph() { avfilter_graph_free(&m_graph); }
+
+  bool Open(const std::string& filters, int width, int height, AVPixelFormat format)
+  {
+    m_graph = avfilter_graph_alloc();
+    if (!m_graph)
+      return false;
+
+    std::string args = std::to_string(width) + ":" + std::to_string(height) + ":" +
+                       std::to_string(format) + ":1:25:1:1";
+    if (avfilter_graph_create_filter(&m_in, avfilter_get_by_name("buffer"), "src", args.c_str(),
+                                     nullptr, m_graph) < 0 ||
+        avfilter_graph_create_filter(&m_out, avfilter_get_by_name("buffersink"), "out", nullptr,
+                                     nullptr, m_graph) < 0)
+      return false;
+
+    AVFilterInOut* outputs = avfilter_inout_alloc();
+    AVFilterInOut* inputs = avfilter_inout_alloc();
+    outputs->name = av_strdup("in");
+    outputs->filter_ctx = m_in;
+    inputs->name = av_strdup("out");
+    inputs->filter_ctx = m_out;
+    int result = avfilter_graph_parse_ptr(m_graph, filters.c_str(), &inputs, &outputs, nullptr);
+    avfilter_inout_free(&outputs);
+    avfilter_inout_free(&inputs);
+
+    return result >= 0 && avfilter_graph_config(m_graph, nullptr) >= 0;
+  }
+
+  AVFilterGraph* m_graph = nullptr;
+  AVFilterContext* m_in = nullptr;
+  AVFilterContext* m_out = nullptr;
+};
+
+// interlaced frames with a moving pattern, writing them stands in for decoding
+FrameSource SyntheticSource(int width, int height, int count)
+{
+  int index = 0;
+  return [width, height, count, index](AVFrame* frame) mutable {
+    if (index >= count)
+      return false;
+
+    frame->width = width;
+    frame->height = height;
+    frame->format = AV_PIX_FMT_YUV420P;
+    if (av_frame_get_buffer(frame, 32) < 0)
+      return false;
+
+    for (int plane = 0; plane < 3; plane++)
+    {
+      const int h = plane ? height / 2 : height;
+      const int w = plane ? width / 2 : width;
+      for (int y = 0; y < h; y++)
+      {
+        uint8_t* line = frame->data[plane] + y * frame->linesize[plane];
+        for (int x = 0; x < w; x++)
+          line[x] = static_cast<uint8_t>((x + y * 3 + index * (y & 1 ? 7 : 3)) >> plane);
+      }
+    }
+    frame->interlaced_frame = 1;
+    frame->top_field_first = 1;
+    frame->pts = index++;
+    return true;
+  };
+}
+
+// decodes the first video stream of a file, used when KODI_TEST_VIDEO is set
+class CFileSource
+{
+public:
+  ~CFileSource()
+  {
+    av_packet_free(&m_packet);
+    avcodec_free_context(&m_codec);
+    avformat_close_input(&m_format);
+  }
+
+  bool Open(const char* path)
+  {
+    if (avformat_open_input(&m_format, path, nullptr, nullptr) < 0 ||
+        avformat_find_stream_info(m_format, nullptr) < 0)
+      return false;
+
+    AVCodec* codec = nullptr;
+    m_stream = av_find_best_stream(m_format, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+    if (m_stream < 0 || !(m_codec = avcodec_alloc_context3(codec)) ||
+        avcodec_parameters_to_context(m_codec, m_format->streams[m_stream]->codecpar) < 0)
+      return false;
+
+    m_codec->thread_count = 0;
+    m_packet = av_packet_alloc();
+    return m_packet && avcodec_open2(m_codec, codec, nullptr) >= 0;
+  }
+
+  bool Get(AVFrame* frame)
+  {
+    while (true)
+    {
+      int result = avcodec_receive_frame(m_codec, frame);
+      if (result == 0)
+        return true;
+      if (result != AVERROR(EAGAIN))
+        return false;
+
+      if (av_read_frame(m_format, m_packet) < 0)
+        avcodec_send_packet(m_codec, nullptr);
+      else
+      {
+        if (m_packet->stream_index == m_stream)
+          avcodec_send_packet(m_codec, m_packet);
+        av_packet_unref(m_packet);
+      }
+    }
+  }
+
+  AVFormatContext* m_format = nullptr;
+  AVCodecContext* m_codec = nullptr;
+  AVPacket* m_packet = nullptr;
+  int m_stream = -1;
+};
+
+// filters all frames on the calling thread like the decoder does without the filter thread
+std::vector<int64_t> FilterDirect(CFilterGraph& graph, const FrameSource& source)
+{
+  std::vector<int64_t> pts;
+  AVFrame* frame = av_frame_alloc();
+  bool input = true;
+  while (true)
+  {
+    if (input)
+    {
+      input = source(frame);
+      av_buffersrc_add_frame(graph.m_in, input ? frame : nullptr);
+    }
+    int result;
+    while ((result = av_buffersink_get_frame(graph.m_out, frame)) >= 0)
+    {
+      pts.push_back(frame->pts);
+      av_frame_unref(frame);
+    }
+    if (result == AVERROR_EOF)
+      break;
+  }
+  av_frame_free(&frame);
+  return pts;
+}
+
+// same loop with the filter on its own thread, mirrors CDVDVideoCodecFFmpeg::FilterProcess
+std::vector<int64_t> FilterThreaded(CFilterGraph& graph, const FrameSource& source)
+{
+  std::vector<int64_t> pts;
+  CDVDVideoFilterThread thread;
+  thread.Attach(graph.m_in, graph.m_out);
+
+  AVFrame* frame = av_frame_alloc();
+  bool input = true;
+  while (true)
+  {
+    if (input)
+    {
+      input = source(frame);
+      thread.AddFrame(input ? frame : nullptr);
+    }
+
+    CDVDVideoCodec::VCReturn ret;
+    while ((ret = thread.GetFrame(frame, !input || thread.GetPending() >= 2)) ==
+           CDVDVideoCodec::VC_PICTURE)
+    {
+      pts.push_back(frame->pts);
+      av_frame_unref(frame);
+    }
+    if (ret != CDVDVideoCodec::VC_BUFFER)
+    {
+      EXPECT_EQ(CDVDVideoCodec::VC_EOF, ret);
+      break;
+    }
+  }
+  av_frame_free(&frame);
+  thread.Detach();
+  return pts;
+}
+} // namespace
+
+TEST(TestDVDVideoFilterThread, Order)
+{
+  CFilterGraph direct;
+  CFilterGraph threaded;
+  ASSERT_TRUE(direct.Open("yadif=1", 320, 240, AV_PIX_FMT_YUV420P));
+  ASSERT_TRUE(threaded.Open("yadif=1", 320, 240, AV_PIX_FMT_YUV420P));
+
+  std::vector<int64_t> expected = FilterDirect(direct, SyntheticSource(320, 240, 50));
+  std::vector<int64_t> pts = FilterThreaded(threaded, SyntheticSource(320, 240, 50));
+
+  // field rate output, two frames per input frame
+  EXPECT_EQ(100u, expected.size());
+  EXPECT_EQ(expected, pts);
+}
+
+TEST(TestDVDVideoFilterThread, Detach)
+{
+  CFilterGraph graph;
+  ASSERT_TRUE(graph.Open("yadif", 320, 240, AV_PIX_FMT_YUV420P));
+
+  CDVDVideoFilterThread thread;
+  thread.Attach(graph.m_in, graph.m_out);
+
+  FrameSource source = SyntheticSource(320, 240, CDVDVideoFilterThread::MAX_INPUT);
+  AVFrame* frame = av_frame_alloc();
+  while (source(frame))
+    thread.AddFrame(frame);
+
+  // queued frames are dropped, nothing may touch the graph afterwards
+  thread.Detach();
+  EXPECT_EQ(0u, thread.GetPending());
+  EXPECT_EQ(CDVDVideoCodec::VC_BUFFER, thread.GetFrame(frame, true));
+  av_frame_free(&frame);
+}
+
+TEST(TestDVDVideoFilterThread, Throughput)
+{
+  // set KODI_TEST_VIDEO to a file to measure decode + filter instead of synthetic frames
+  const char* path = std::getenv("KODI_TEST_VIDEO");
+  const std::string filters = "yadif=0:-1:1";
+
+  double fps[2] = {};
+  int frames[2] = {};
+  for (int threaded = 0; threaded < 2; threaded++)
+  {
+    CFileSource file;
+    FrameSource source;
+    int width = 1920;
+    int height = 1080;
+    AVPixelFormat format = AV_PIX_FMT_YUV420P;
+    if (path)
+    {
+      ASSERT_TRUE(file.Open(path));
+      width = file.m_codec->width;
+      height = file.m_codec->height;
+      format = file.m_codec->pix_fmt;
+      source = [&file](AVFrame* frame) { return file.Get(frame); };
+    }
+    else
+      source = SyntheticSource(width, height, 200);
+
+    CFilterGraph graph;
+    ASSERT_TRUE(graph.Open(filters, width, height, format));
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int64_t> pts =
+        threaded ? FilterThreaded(graph, source) : FilterDirect(graph, source);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+    frames[threaded] = static_cast<int>(pts.size());
+    fps[threaded] = elapsed > 0 ? pts.size() * 1000000.0 / elapsed : 0.0;
+  }
+
+  RecordProperty("direct_fps", static_cast<int>(fps[0]));
+  RecordProperty("threaded_fps", static_cast<int>(fps[1]));
+  EXPECT_EQ(frames[0], frames[1]);
+  EXPECT_GT(fps[1], 0.0);
+}
@@ -0,0 +1,82 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoPlayerBenchmark.h"
+
+#include <cstdlib>
+#include <string>
+
+#include <gtest/gtest.h>
+
+/*
+ * Plays KODI_TEST_VIDEO through the demuxer, the codecs and a null
+ * renderer and sink. The tests are disabled as they need a file, run them
+ * with:
+ *
+ *   KODI_TEST_VIDEO=/path/to/file kodi-test --gtest_also_run_disabled_tests \
+ *     --gtest_filter=TestVideoPlayerBenchmark.*
+ *
+ * KODI_TEST_VIDEO_SECONDS limits how much of the file is played. The
+ * stage timings are written to the log and recorded as test properties,
+ * --gtest_output=xml keeps them for comparing releases.
+ */
+class TestVideoPlayerBenchmark : public ::testing::Test
+{
+protected:
+  void RunBenchmark(bool realtime)
+  {
+    const char* path = std::getenv("KODI_TEST_VIDEO");
+    ASSERT_NE(nullptr, path) << "KODI_TEST_VIDEO is not set";
+
+    CVideoPlayerBenchmark::SOptions options;
+    options.realtime = realtime;
+    const char* seconds = std::getenv("KODI_TEST_VIDEO_SECONDS");
+    if (seconds)
+      options.seconds = std::atof(seconds);
+    else if (realtime)
+      options.seconds = 30.0;
+
+    CVideoPlayerBenchmark benchmark;
+    ASSERT_TRUE(benchmark.Run(path, options));
+    benchmark.Log();
+
+    const CVideoPlayerBenchmark::SStages& stages = benchmark.GetStages();
+    const CVideoPlayerBenchmark::SResult& result = benchmark.GetResult();
+    Record("demux", stages.demux);
+    Record("demux_wait", stages.demuxWait);
+    Record("queue_wait", stages.queueWait);
+    Record("decode", stages.decode);
+    Record("handoff", stages.handoff);
+    Record("audio_decode", stages.audioDecode);
+    Record("audio_sink", stages.audioSink);
+    RecordProperty("pictures", static_cast<int>(result.pictures));
+    RecordProperty("dropped", static_cast<int>(result.dropped));
+    RecordProperty("audio_underruns", static_cast<int>(result.audioUnderruns));
+    RecordProperty("fps",
+                   static_cast<int>(result.elapsed > 0.0 ? result.pictures / result.elapsed : 0.0));
+
+    EXPECT_GT(result.pictures, 0u);
+  }
+
+  void Record(const std::string& name, const CAELatencyHistogram& histogram)
+  {
+    RecordProperty(name + "_median_us", static_cast<int>(histogram.GetPercentile(50.0)));
+    RecordProperty(name + "_p99_us", static_cast<int>(histogram.GetPercentile(99.0)));
+    RecordProperty(name + "_max_us", static_cast<int>(histogram.GetMax()));
+  }
+};
+
+TEST_F(TestVideoPlayerBenchmark, DISABLED_Fast)
+{
+  RunBenchmark(false);
+}
+
+TEST_F(TestVideoPlayerBenchmark, DISABLED_Realtime)
+{
+  RunBenchmark(true);
+}
@@ -0,0 +1,565 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoPlayerBenchmark.h"
+
+#include "FileItem.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "cores/VideoPlayer/DVDCodecs/Audio/DVDAudioCodec.h"
+#include "cores/VideoPlayer/DVDCodecs/DVDFactoryCodec.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemux.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDFactoryDemuxer.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDFactoryInputStream.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDInputStream.h"
+#include "cores/VideoPlayer/DVDStreamInfo.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "cores/VideoPlayer/Process/ProcessInfo.h"
+#include "threads/Condition.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <deque>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+namespace
+{
+// pictures queued in the render manager with the default settings
+const unsigned int RENDER_BUFFERS = 4;
+// consecutive failed reads before giving up on a stream that is not at eof
+const int MAX_READ_ERRORS = 100;
+
+int64_t ToHostTicks(double dvdTime)
+{
+  return static_cast<int64_t>(dvdTime * CurrentHostFrequency() / DVD_TIME_BASE);
+}
+} // namespace
+
+/*!
+ * Takes the place of CRenderManager: it holds up to RENDER_BUFFERS pictures,
+ * presents them at their pts or right away and drops pictures that are more
+ * than a frame late.
+ */
+class CVideoPlayerBenchmark::CNullRenderer
+{
+public:
+  explicit CNullRenderer(bool realtime) : m_realtime(realtime)
+  {
+    m_thread = std::thread([this]() { Process(); });
+  }
+
+  ~CNullRenderer() { Stop(); }
+
+  //! blocks while all buffers are in use, false if the renderer was stopped
+  bool AddPicture(const VideoPicture& picture)
+  {
+    CSingleLock lock(m_section);
+    while (m_queue.size() >= RENDER_BUFFERS && !m_stop)
+      m_cond.wait(lock);
+    if (m_stop)
+      return false;
+
+    SPicture entry;
+    entry.buffer = picture.videoBuffer;
+    entry.pts = picture.pts != DVD_NOPTS_VALUE ? picture.pts : m_nextPts;
+    entry.duration = picture.iDuration;
+    if (entry.buffer)
+      entry.buffer->Acquire();
+    m_nextPts = entry.pts + entry.duration;
+
+    m_queue.push_back(entry);
+    m_cond.notifyAll();
+    return true;
+  }
+
+  //! present everything queued and stop
+  void Finish()
+  {
+    {
+      CSingleLock lock(m_section);
+      m_finish = true;
+      m_cond.notifyAll();
+    }
+    if (m_thread.joinable())
+      m_thread.join();
+  }
+
+  void Stop()
+  {
+    {
+      CSingleLock lock(m_section);
+      m_stop = true;
+      m_cond.notifyAll();
+    }
+    if (m_thread.joinable())
+      m_thread.join();
+
+    for (auto& picture : m_queue)
+    {
+      if (picture.buffer)
+        picture.buffer->Release();
+    }
+    m_queue.clear();
+  }
+
+  unsigned int m_presented = 0;
+  unsigned int m_dropped = 0;
+  double m_mediaTime = 0.0;
+
+private:
+  struct SPicture
+  {
+    CVideoBuffer* buffer = nullptr;
+    double pts = 0.0;
+    double duration = 0.0;
+  };
+
+  void Process()
+  {
+    int64_t clockStart = 0;
+    double ptsStart = 0.0;
+
+    CSingleLock lock(m_section);
+    while (!m_stop)
+    {
+      if (m_queue.empty())
+      {
+        if (m_finish)
+          break;
+        m_cond.wait(lock);
+        continue;
+      }
+
+      // the buffer stays queued until it has been shown, like on screen
+      SPicture picture = m_queue.front();
+      {
+        CSingleExit exit(m_section);
+
+        if (!clockStart)
+        {
+          clockStart = CurrentHostCounter();
+          ptsStart = picture.pts;
+        }
+
+        bool late = false;
+        if (m_realtime)
+        {
+          const int64_t presentAt = clockStart + ToHostTicks(picture.pts - ptsStart);
+          const int64_t now = CurrentHostCounter();
+          if (now > presentAt + ToHostTicks(picture.duration))
+            late = true;
+          else if (now < presentAt)
+            std::this_thread::sleep_for(std::chrono::microseconds(
+                (presentAt - now) * 1000000 / CurrentHostFrequency()));
+        }
+
+        if (late)
+          m_dropped++;
+        else
+          m_presented++;
+        m_mediaTime = (picture.pts - ptsStart + picture.duration) / DVD_TIME_BASE;
+
+        if (picture.buffer)
+          picture.buffer->Release();
+      }
+
+      m_queue.pop_front();
+      m_cond.notifyAll();
+    }
+  }
+
+  bool m_realtime;
+  bool m_stop = false;
+  bool m_finish = false;
+  double m_nextPts = 0.0;
+  std::deque<SPicture> m_queue;
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_cond;
+  std::thread m_thread;
+};
+
+CVideoPlayerBenchmark::CVideoPlayerBenchmark()
+  : m_videoQueue("benchmark video"), m_audioQueue("benchmark audio")
+{
+  // same limits as VideoPlayerVideo and VideoPlayerAudio
+  m_videoQueue.SetMaxDataSize(40 * 1024 * 1024);
+  m_videoQueue.SetMaxTimeSize(8.0);
+  m_audioQueue.SetMaxDataSize(6 * 1024 * 1024);
+  m_audioQueue.SetMaxTimeSize(8.0);
+}
+
+CVideoPlayerBenchmark::~CVideoPlayerBenchmark()
+{
+  Close();
+}
+
+bool CVideoPlayerBenchmark::Run(const std::string& path, const SOptions& options)
+{
+  m_options = options;
+  m_result = SResult();
+  m_abort = false;
+
+  if (!Open(path))
+  {
+    Close();
+    return false;
+  }
+
+  m_renderer.reset(new CNullRenderer(m_options.realtime));
+  m_videoQueue.Init();
+  m_audioQueue.Init();
+
+  const unsigned int startTime = XbmcThreads::SystemClockMillis();
+
+  std::thread video([this]() { VideoThread(); });
+  std::thread audio;
+  if (m_audioCodec)
+    audio = std::thread([this]() { AudioThread(); });
+
+  DemuxThread();
+
+  video.join();
+  if (audio.joinable())
+    audio.join();
+  m_renderer->Finish();
+
+  m_result.elapsed = (XbmcThreads::SystemClockMillis() - startTime) / 1000.0;
+  m_result.pictures = m_renderer->m_presented;
+  m_result.dropped += m_renderer->m_dropped;
+  m_result.mediaTime = m_renderer->m_mediaTime;
+
+  Close();
+  return true;
+}
+
+bool CVideoPlayerBenchmark::Open(const std::string& path)
+{
+  CFileItem item(path, false);
+  m_input = CDVDFactoryInputStream::CreateInputStream(nullptr, item);
+  if (!m_input || !m_input->Open())
+  {
+    CLog::Log(LOGERROR, "CVideoPlayerBenchmark::Open - unable to open %s", path.c_str());
+    return false;
+  }
+
+  m_demuxer.reset(CDVDFactoryDemuxer::CreateDemuxer(m_input));
+  if (!m_demuxer)
+  {
+    CLog::Log(LOGERROR, "CVideoPlayerBenchmark::Open - unable to create demuxer");
+    return false;
+  }
+
+  m_processInfo.reset(CProcessInfo::CreateInstance());
+  std::vector<AVPixelFormat> pixFmts;
+  pixFmts.push_back(AV_PIX_FMT_YUV420P);
+  m_processInfo->SetPixFormats(pixFmts);
+
+  for (CDemuxStream* stream : m_demuxer->GetStreams())
+  {
+    if (stream->type == STREAM_VIDEO && !(stream->flags & AV_DISPOSITION_ATTACHED_PIC) &&
+        m_videoStream < 0)
+    {
+      CDVDStreamInfo hint(*stream, true);
+      hint.codecOptions = CODEC_FORCE_SOFTWARE;
+      m_videoCodec.reset(CDVDFactoryCodec::CreateVideoCodec(hint, *m_processInfo));
+      if (m_videoCodec)
+        m_videoStream = stream->uniqueId;
+    }
+    else if (stream->type == STREAM_AUDIO && m_options.audio && m_audioStream < 0)
+    {
+      CDVDStreamInfo hint(*stream, true);
+      m_audioCodec.reset(CDVDFactoryCodec::CreateAudioCodec(hint, *m_processInfo, false, false,
+                                                            CAEStreamInfo::STREAM_TYPE_NULL));
+      if (m_audioCodec)
+        m_audioStream = stream->uniqueId;
+    }
+  }
+
+  if (!m_videoCodec)
+  {
+    CLog::Log(LOGERROR, "CVideoPlayerBenchmark::Open - no decodable video stream");
+    return false;
+  }
+
+  for (CDemuxStream* stream : m_demuxer->GetStreams())
+  {
+    if (stream->uniqueId != m_videoStream && stream->uniqueId != m_audioStream)
+      m_demuxer->EnableStream(stream->demuxerId, stream->uniqueId, false);
+  }
+
+  return true;
+}
+
+void CVideoPlayerBenchmark::Close()
+{
+  // pictures hold buffers of the video codec
+  m_renderer.reset();
+  m_videoQueue.End();
+  m_audioQueue.End();
+  m_videoCodec.reset();
+  m_audioCodec.reset();
+  m_demuxer.reset();
+  m_input.reset();
+  m_processInfo.reset();
+  m_videoStream = -1;
+  m_audioStream = -1;
+}
+
+void CVideoPlayerBenchmark::DemuxThread()
+{
+  double startDts = DVD_NOPTS_VALUE;
+  int errors = 0;
+
+  while (!m_abort)
+  {
+    if (m_videoQueue.IsFull() || (m_audioCodec && m_audioQueue.IsFull()))
+    {
+      const int64_t start = CurrentHostCounter();
+      while (!m_abort && (m_videoQueue.IsFull() || (m_audioCodec && m_audioQueue.IsFull())))
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      m_stages.demuxWait.AddElapsed(start);
+    }
+
+    const int64_t start = CurrentHostCounter();
+    DemuxPacket* packet = m_demuxer->Read();
+    m_stages.demux.AddElapsed(start);
+
+    if (!packet)
+    {
+      if (m_input->IsEOF() || ++errors > MAX_READ_ERRORS)
+        break;
+      continue;
+    }
+    errors = 0;
+
+    if (m_options.seconds > 0.0 && packet->dts != DVD_NOPTS_VALUE)
+    {
+      if (startDts == DVD_NOPTS_VALUE)
+        startDts = packet->dts;
+      else if (packet->dts - startDts > m_options.seconds * DVD_TIME_BASE)
+      {
+        CDVDDemuxUtils::FreeDemuxPacket(packet);
+        break;
+      }
+    }
+
+    if (packet->iStreamId == m_videoStream)
+      m_videoQueue.Put(new CDVDMsgDemuxerPacket(packet));
+    else if (packet->iStreamId == m_audioStream && m_audioCodec)
+      m_audioQueue.Put(new CDVDMsgDemuxerPacket(packet));
+    else
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+
+  m_videoQueue.Put(new CDVDMsg(CDVDMsg::GENERAL_EOF));
+  if (m_audioCodec)
+    m_audioQueue.Put(new CDVDMsg(CDVDMsg::GENERAL_EOF));
+}
+
+void CVideoPlayerBenchmark::VideoThread()
+{
+  VideoPicture picture;
+  int64_t decodeTicks = 0;
+
+  while (!m_abort)
+  {
+    CDVDMsg* msg = nullptr;
+    const int64_t start = CurrentHostCounter();
+    MsgQueueReturnCode ret = m_videoQueue.Get(&msg, 1000);
+    m_stages.queueWait.AddElapsed(start);
+
+    if (ret == MSGQ_TIMEOUT)
+      continue;
+    else if (MSGQ_IS_ERROR(ret))
+      break;
+
+    if (msg->IsType(CDVDMsg::GENERAL_EOF))
+    {
+      m_videoCodec->SetCodecControl(DVD_CODEC_CTRL_DRAIN);
+      OutputPictures(picture, decodeTicks);
+      msg->Release();
+      break;
+    }
+    else if (msg->IsType(CDVDMsg::DEMUXER_PACKET))
+    {
+      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket();
+
+      // a full decoder takes the packet after its pictures have been fetched
+      bool added = false;
+      while (!added && !m_abort)
+      {
+        const int64_t addStart = CurrentHostCounter();
+        added = m_videoCodec->AddData(*packet);
+        decodeTicks += CurrentHostCounter() - addStart;
+
+        CDVDVideoCodec::VCReturn state = OutputPictures(picture, decodeTicks);
+        if (state == CDVDVideoCodec::VC_ERROR || state == CDVDVideoCodec::VC_EOF)
+          break;
+      }
+    }
+
+    msg->Release();
+  }
+}
+
+CDVDVideoCodec::VCReturn CVideoPlayerBenchmark::OutputPictures(VideoPicture& picture,
+                                                               int64_t& decodeTicks)
+{
+  while (!m_abort)
+  {
+    int64_t start = CurrentHostCounter();
+    CDVDVideoCodec::VCReturn state = m_videoCodec->GetPicture(&picture);
+    decodeTicks += CurrentHostCounter() - start;
+
+    if (state == CDVDVideoCodec::VC_NONE)
+      continue;
+    else if (state != CDVDVideoCodec::VC_PICTURE)
+      return state;
+
+    m_stages.decode.Add(decodeTicks * 1000000 / CurrentHostFrequency());
+    decodeTicks = 0;
+
+    if (picture.iFlags & DVP_FLAG_DROPPED)
+    {
+      m_result.dropped++;
+      continue;
+    }
+
+    start = CurrentHostCounter();
+    if (!m_renderer->AddPicture(picture))
+      return CDVDVideoCodec::VC_ERROR;
+    m_stages.handoff.AddElapsed(start);
+  }
+
+  return CDVDVideoCodec::VC_NONE;
+}
+
+void CVideoPlayerBenchmark::AudioThread()
+{
+  CAESinkNULL sink;
+  bool sinkOpen = false;
+  bool copyData = false;
+  unsigned int silenceFrames = 0;
+  std::vector<uint8_t> silence;
+
+  while (!m_abort)
+  {
+    CDVDMsg* msg = nullptr;
+    MsgQueueReturnCode ret = m_audioQueue.Get(&msg, 1000);
+    if (ret == MSGQ_TIMEOUT)
+      continue;
+    else if (MSGQ_IS_ERROR(ret))
+      break;
+
+    if (msg->IsType(CDVDMsg::GENERAL_EOF))
+    {
+      msg->Release();
+      break;
+    }
+    else if (msg->IsType(CDVDMsg::DEMUXER_PACKET))
+    {
+      DemuxPacket* packet = static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket();
+
+      int64_t start = CurrentHostCounter();
+      bool added = false;
+      while (!added && !m_abort)
+      {
+        added = m_audioCodec->AddData(*packet);
+
+        while (!m_abort)
+        {
+          DVDAudioFrame frame = {};
+          m_audioCodec->GetData(frame);
+          if (!frame.nb_frames)
+            break;
+          m_stages.audioDecode.AddElapsed(start);
+
+          if (!sinkOpen)
+          {
+            AEAudioFormat format = frame.format;
+            std::string device = m_options.realtime ? "realtime" : "fast";
+            sinkOpen = sink.Initialize(format, device);
+            // the sink may have picked another layout, feed silence then
+            copyData = format.m_dataFormat == frame.format.m_dataFormat && frame.planes == 1;
+            silenceFrames = format.m_frames;
+            silence.resize(static_cast<size_t>(format.m_frameSize) * silenceFrames);
+          }
+
+          unsigned int offset = 0;
+          while (sinkOpen && offset < frame.nb_frames && !m_abort)
+          {
+            uint8_t* data[1] = {silence.data()};
+            unsigned int frames = frame.nb_frames - offset;
+            if (!copyData)
+              frames = std::min(frames, silenceFrames);
+
+            const int64_t sinkStart = CurrentHostCounter();
+            unsigned int written =
+                sink.AddPackets(copyData ? frame.data : data, frames, copyData ? offset : 0);
+            m_stages.audioSink.AddElapsed(sinkStart);
+            if (!written)
+              break;
+            offset += written;
+          }
+          m_result.audioFrames += frame.nb_frames;
+          start = CurrentHostCounter();
+        }
+      }
+    }
+
+    msg->Release();
+  }
+
+  if (sinkOpen)
+  {
+    sink.Drain();
+    m_result.audioUnderruns = sink.GetUnderruns();
+    sink.Deinitialize();
+  }
+}
+
+void CVideoPlayerBenchmark::Log() const
+{
+  struct
+  {
+    const char* name;
+    const CAELatencyHistogram& histogram;
+  } stages[] = {
+      {"demux", m_stages.demux},
+      {"demux wait", m_stages.demuxWait},
+      {"queue wait", m_stages.queueWait},
+      {"decode", m_stages.decode},
+      {"handoff", m_stages.handoff},
+      {"audio decode", m_stages.audioDecode},
+      {"audio sink", m_stages.audioSink},
+  };
+
+  for (const auto& stage : stages)
+  {
+    CLog::Log(LOGINFO,
+              "CVideoPlayerBenchmark - %-12s count %8llu median %6llu us p99 %6llu us max %8llu us",
+              stage.name, static_cast<unsigned long long>(stage.histogram.GetCount()),
+              static_cast<unsigned long long>(stage.histogram.GetPercentile(50.0)),
+              static_cast<unsigned long long>(stage.histogram.GetPercentile(99.0)),
+              static_cast<unsigned long long>(stage.histogram.GetMax()));
+  }
+
+  CLog::Log(LOGINFO,
+            "CVideoPlayerBenchmark - %u pictures, %u dropped, %.1f s of video in %.1f s, %.1f fps, "
+            "%llu audio frames, %u underruns",
+            m_result.pictures, m_result.dropped, m_result.mediaTime, m_result.elapsed,
+            m_result.elapsed > 0.0 ? m_result.pictures / m_result.elapsed : 0.0,
+            static_cast<unsigned long long>(m_result.audioFrames), m_result.audioUnderruns);
+}
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Utils/AELatencyHistogram.h"
+#include "cores/VideoPlayer/DVDCodecs/Video/DVDVideoCodec.h"
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+class CDVDAudioCodec;
+class CDVDDemux;
+class CDVDInputStream;
+class CProcessInfo;
+
+/*!
+ * \brief Plays a local file through the VideoPlayer demuxer, codecs and
+ * message queues without a display or an audio device
+ *
+ * A demux thread feeds a video and an audio thread like VideoPlayer does.
+ * Decoded pictures are handed to a null renderer with as many buffers as
+ * the render manager, which presents them at 1x or as soon as they arrive
+ * and drops pictures that are late. Decoded audio goes to CAESinkNULL.
+ */
+class CVideoPlayerBenchmark
+{
+public:
+  struct SOptions
+  {
+    bool realtime = false; //!< present and play at 1x instead of as fast as possible
+    bool audio = true; //!< decode the audio stream as well
+    double seconds = 0.0; //!< stop after that much of the file, 0 for all of it
+  };
+
+  //! durations in us, each one is recorded by a single thread
+  struct SStages
+  {
+    CAELatencyHistogram demux; //!< CDVDDemux::Read
+    CAELatencyHistogram demuxWait; //!< demuxer blocked on a full queue
+    CAELatencyHistogram queueWait; //!< video thread waiting for a packet
+    CAELatencyHistogram decode; //!< video AddData/GetPicture per picture
+    CAELatencyHistogram handoff; //!< waiting for a free render buffer
+    CAELatencyHistogram audioDecode; //!< audio AddData/GetData per packet
+    CAELatencyHistogram audioSink; //!< CAESinkNULL::AddPackets per frame
+  };
+
+  struct SResult
+  {
+    unsigned int pictures = 0; //!< pictures presented
+    unsigned int dropped = 0; //!< dropped by the decoder or for being late
+    unsigned int audioUnderruns = 0;
+    uint64_t audioFrames = 0;
+    double elapsed = 0.0; //!< wall clock seconds
+    double mediaTime = 0.0; //!< seconds of video played
+  };
+
+  CVideoPlayerBenchmark();
+  ~CVideoPlayerBenchmark();
+
+  bool Run(const std::string& path, const SOptions& options);
+
+  const SStages& GetStages() const { return m_stages; }
+  const SResult& GetResult() const { return m_result; }
+
+  //! log a line per stage with median, 99th percentile and max
+  void Log() const;
+
+private:
+  class CNullRenderer;
+
+  bool Open(const std::string& path);
+  void Close();
+  void DemuxThread();
+  void VideoThread();
+  void AudioThread();
+  CDVDVideoCodec::VCReturn OutputPictures(VideoPicture& picture, int64_t& decodeTicks);
+
+  SOptions m_options;
+  SStages m_stages;
+  SResult m_result;
+  std::atomic<bool> m_abort{false};
+
+  std::unique_ptr<CProcessInfo> m_processInfo;
+  std::shared_ptr<CDVDInputStream> m_input;
+  std::unique_ptr<CDVDDemux> m_demuxer;
+  std::unique_ptr<CDVDVideoCodec> m_videoCodec;
+  std::unique_ptr<CDVDAudioCodec> m_audioCodec;
+  std::unique_ptr<CNullRenderer> m_renderer;
+  int m_videoStream = -1;
+  int m_audioStream = -1;
+
+  CDVDMessageQueue m_videoQueue;
+  CDVDMessageQueue m_audioQueue;
+};
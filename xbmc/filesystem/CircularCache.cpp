@@ -16,6 +16,9 @@
 
 using namespace XFILE;
 
+#define CACHE_BLOCK_SIZE_MAX (256 * 1024)
+#define CACHE_BLOCK_COUNT_MIN 32
+
 CCircularCache::CCircularCache(size_t front, size_t back)
  : CCacheStrategy()
  , m_beg(0)
@@ -24,6 +27,8 @@ CCircularCache::CCircularCache(size_t front, size_t back)
  , m_buf(NULL)
  , m_size(front + back)
  , m_size_back(back)
+ , m_blockSize(std::max<size_t>(1, std::min<size_t>(CACHE_BLOCK_SIZE_MAX, (front + back) / CACHE_BLOCK_COUNT_MIN)))
+ , m_useCount(0)
 #ifdef TARGET_WINDOWS
  , m_handle(NULL)
 #endif
@@ -50,6 +55,12 @@ int CCircularCache::Open()
   m_beg = 0;
   m_end = 0;
   m_cur = 0;
+
+  m_blocks.clear();
+  m_free.clear();
+  for (size_t slot = m_size / m_blockSize; slot > 0; slot--)
+    m_free.push_back(slot - 1);
+
   return CACHE_RC_OK;
 }
 
@@ -65,36 +76,34 @@ void CCircularCache::Close()
   delete[] m_buf;
 #endif
   m_buf = NULL;
+  Clear();
 }
 
 size_t CCircularCache::GetMaxWriteSize(const size_t& iRequestSize)
 {
   CSingleLock lock(m_sync);
 
-  size_t back  = (size_t)(m_cur - m_beg); // Backbuffer size
-  size_t front = (size_t)(m_end - m_cur); // Frontbuffer size
-  size_t limit = m_size - std::min(back, m_size_back) - front;
-
   // Never return more than limit and size requested by caller
-  return std::min(iRequestSize, limit);
+  return std::min(iRequestSize, GetWritableSize());
 }
 
 /**
- * Function will write to m_buf at m_end % m_size location
- * it will write at maximum m_size, but it will only write
- * as much it can without wrapping around in the buffer
+ * Function will write to the block of m_end, it will
+ * only write as much it can without crossing the end
+ * of the block
  *
  * It will always leave m_size_back of the backbuffer intact
  * but if the back buffer is less than that, that space is
- * usable to write.
- *
- * If back buffer is filled to an larger extent than
- * m_size_back, it will allow it to be overwritten
- * until only m_size_back data remains.
+ * usable to write. Blocks of other regions and of the
+ * backbuffer beyond m_size_back are reused, the one read
+ * least recently first.
  *
  * The following always apply:
- *  * m_end <= m_cur <= m_end
- *  * m_end - m_beg <= m_size
+ *  * m_beg <= m_cur <= m_end
+ *  * [m_beg, m_end] is held by contiguous blocks
+ *
+ * If the write reaches a region cached before, m_end
+ * continues at its end.
  *
  * Multiple calls may be needed to fill buffer completely.
  */
@@ -102,35 +111,41 @@ int CCircularCache::WriteToCache(const char *buf, size_t len)
 {
   CSingleLock lock(m_sync);
 
-  // where are we in the buffer
-  size_t pos   = m_end % m_size;
-  size_t back  = (size_t)(m_cur - m_beg);
-  size_t front = (size_t)(m_end - m_cur);
-
-  size_t limit = m_size - std::min(back, m_size_back) - front;
-  size_t wrap  = m_size - pos;
+  if (m_buf == NULL)
+    return 0;
 
   // limit by max forward size
-  if(len > limit)
-    len = limit;
-
-  // limit to wrap point
-  if(len > wrap)
-    len = wrap;
-
+  len = std::min(len, GetWritableSize());
   if(len == 0)
     return 0;
 
-  if (m_buf == NULL)
-    return 0;
+  const int64_t index = m_end / m_blockSize;
+  const size_t pos = (size_t)(m_end % m_blockSize);
 
-  // write the data
-  memcpy(m_buf + pos, buf, len);
-  m_end += len;
+  auto it = m_blocks.find(index);
+  if (it == m_blocks.end())
+  {
+    size_t slot;
+    if (!AllocateSlot(slot))
+      return 0;
+    it = m_blocks.emplace(index, SBlock{slot, pos, pos, 0}).first;
+  }
+  else if (it->second.end != pos)
+  {
+    // the block holds data of another region that doesn't continue ours
+    it->second.beg = pos;
+    it->second.end = pos;
+  }
 
-  // drop history that was overwritten
-  if(m_end - m_beg > (int64_t)m_size)
-    m_beg = m_end - m_size;
+  // limit to end of block
+  SBlock& block = it->second;
+  len = std::min(len, m_blockSize - pos);
+
+  // write the data
+  memcpy(m_buf + block.slot * m_blockSize + pos, buf, len);
+  block.end += len;
+  block.lastUse = ++m_useCount;
+  m_end = ContiguousEnd(m_end + len);
 
   m_written.Set();
 
@@ -139,16 +154,17 @@ int CCircularCache::WriteToCache(const char *buf, size_t len)
 
 /**
  * Reads data from cache. Will only read up till
- * the buffer wrap point. So multiple calls
+ * the end of a block. So multiple calls
  * may be needed to empty the whole cache
  */
 int CCircularCache::ReadFromCache(char *buf, size_t len)
 {
   CSingleLock lock(m_sync);
 
-  size_t pos   = m_cur % m_size;
   size_t front = (size_t)(m_end - m_cur);
-  size_t avail = std::min(m_size - pos, front);
+  auto it = m_blocks.find(m_cur / m_blockSize);
+  size_t pos = (size_t)(m_cur % m_blockSize);
+  size_t avail = front > 0 && it != m_blocks.end() ? std::min(it->second.end - pos, front) : 0;
 
   if(avail == 0)
   {
@@ -167,7 +183,9 @@ int CCircularCache::ReadFromCache(char *buf, size_t len)
   if (m_buf == NULL)
     return 0;
 
-  memcpy(buf, m_buf + pos, len);
+  SBlock& block = it->second;
+  memcpy(buf, m_buf + block.slot * m_blockSize + pos, len);
+  block.lastUse = ++m_useCount;
   m_cur += len;
 
   m_space.Set();
@@ -187,8 +205,11 @@ int64_t CCircularCache::WaitForData(unsigned int minimum, unsigned int millis)
   if(millis == 0 || IsEndOfInput())
     return avail;
 
-  if(minimum > m_size - m_size_back)
-    minimum = m_size - m_size_back;
+  // the front buffer can't use the blocks of the backbuffer and the partial ones at its ends
+  const size_t capacity = m_size / m_blockSize * m_blockSize;
+  const size_t reserved = m_size_back + 2 * m_blockSize;
+  if(minimum > capacity - std::min(capacity - m_blockSize, reserved))
+    minimum = capacity - std::min(capacity - m_blockSize, reserved);
 
   XbmcThreads::EndTime endtime(millis);
   while (!IsEndOfInput() && avail < minimum && !endtime.IsTimePast() )
@@ -234,9 +255,20 @@ bool CCircularCache::Reset(int64_t pos, bool clearAnyway)
   CSingleLock lock(m_sync);
   if (!clearAnyway && IsCachedPosition(pos))
   {
+    // continue in the region holding pos, which may be another one than read so far
     m_cur = pos;
+    if (pos < m_beg || pos > m_end)
+    {
+      m_beg = ContiguousBegin(pos);
+      m_end = ContiguousEnd(pos);
+    }
     return false;
   }
+
+  // regions cached so far are kept unless asked to clear
+  if (clearAnyway)
+    Clear();
+
   m_end = pos;
   m_beg = pos;
   m_cur = pos;
@@ -246,9 +278,10 @@ bool CCircularCache::Reset(int64_t pos, bool clearAnyway)
 
 int64_t CCircularCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
 {
-  if (IsCachedPosition(iFilePosition))
+  CSingleLock lock(m_sync);
+  if (iFilePosition >= m_beg && iFilePosition <= m_end)
     return m_end;
-  return iFilePosition;
+  return ContiguousEnd(iFilePosition);
 }
 
 int64_t CCircularCache::CachedDataEndPos()
@@ -258,7 +291,9 @@ int64_t CCircularCache::CachedDataEndPos()
 
 bool CCircularCache::IsCachedPosition(int64_t iFilePosition)
 {
-  return iFilePosition >= m_beg && iFilePosition <= m_end;
+  CSingleLock lock(m_sync);
+  return (iFilePosition >= m_beg && iFilePosition <= m_end) || Contains(iFilePosition) ||
+         (iFilePosition > 0 && Contains(iFilePosition - 1));
 }
 
 CCacheStrategy *CCircularCache::CreateNew()
@@ -266,3 +301,100 @@ CCacheStrategy *CCircularCache::CreateNew()
   return new CCircularCache(m_size - m_size_back, m_size_back);
 }
 
+
+bool CCircularCache::Contains(int64_t pos) const
+{
+  auto it = m_blocks.find(pos / m_blockSize);
+  if (it == m_blocks.end())
+    return false;
+
+  const size_t offset = (size_t)(pos % m_blockSize);
+  return offset >= it->second.beg && offset < it->second.end;
+}
+
+int64_t CCircularCache::ContiguousBegin(int64_t pos) const
+{
+  while (pos > 0 && Contains(pos - 1))
+  {
+    const int64_t index = (pos - 1) / m_blockSize;
+    pos = index * m_blockSize + m_blocks.find(index)->second.beg;
+  }
+  return pos;
+}
+
+int64_t CCircularCache::ContiguousEnd(int64_t pos) const
+{
+  while (Contains(pos))
+  {
+    const int64_t index = pos / m_blockSize;
+    pos = index * m_blockSize + m_blocks.find(index)->second.end;
+  }
+  return pos;
+}
+
+/**
+ * Bytes that can be written at m_end without touching the
+ * guaranteed backbuffer and the front buffer: the rest of
+ * the block of m_end and every block not part of them
+ */
+size_t CCircularCache::GetWritableSize() const
+{
+  const int64_t first = std::max(m_beg, m_cur - (int64_t)m_size_back) / m_blockSize;
+  const int64_t last = m_end / m_blockSize;
+
+  size_t available = m_free.size();
+  for (const auto& block : m_blocks)
+  {
+    if (block.first < first || block.first > last)
+      available++;
+  }
+
+  const size_t rest = m_blockSize - (size_t)(m_end % m_blockSize);
+  if (m_blocks.find(last) != m_blocks.end())
+    return rest + available * m_blockSize;
+  if (available == 0)
+    return 0;
+  return rest + (available - 1) * m_blockSize;
+}
+
+bool CCircularCache::AllocateSlot(size_t& slot)
+{
+  if (!m_free.empty())
+  {
+    slot = m_free.back();
+    m_free.pop_back();
+    return true;
+  }
+
+  // reuse the block read least recently that isn't needed for the backbuffer or front buffer
+  const int64_t first = std::max(m_beg, m_cur - (int64_t)m_size_back) / m_blockSize;
+  const int64_t last = m_end / m_blockSize;
+
+  auto oldest = m_blocks.end();
+  for (auto it = m_blocks.begin(); it != m_blocks.end(); ++it)
+  {
+    if (it->first >= first && it->first <= last)
+      continue;
+    if (oldest == m_blocks.end() || it->second.lastUse < oldest->second.lastUse)
+      oldest = it;
+  }
+
+  if (oldest == m_blocks.end())
+    return false;
+
+  // the backbuffer starts behind a block taken from it
+  const int64_t index = oldest->first;
+  if (index * (int64_t)m_blockSize < m_end && (index + 1) * (int64_t)m_blockSize > m_beg)
+    m_beg = (index + 1) * m_blockSize;
+
+  slot = oldest->second.slot;
+  m_blocks.erase(oldest);
+  return true;
+}
+
+void CCircularCache::Clear()
+{
+  for (const auto& block : m_blocks)
+    m_free.push_back(block.second.slot);
+  m_blocks.clear();
+}
@@ -12,8 +12,20 @@
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
+#include <map>
+#include <vector>
+
 namespace XFILE {
 
+/*!
+ * \brief Memory cache that keeps several regions of the file
+ *
+ * The buffer is split into blocks that map to aligned ranges of the file.
+ * Data around the read position is cached like in a ring buffer, after a
+ * seek the regions read before stay in memory until their blocks are
+ * needed. The blocks the demuxer read least recently are reused first, so
+ * seeking back to a position just left is served without the source.
+ */
 class CCircularCache : public CCacheStrategy
 {
 public:
@@ -37,12 +49,32 @@ public:
 
     CCacheStrategy *CreateNew() override;
 protected:
-    int64_t           m_beg;       /**< index in file (not buffer) of beginning of valid data */
-    int64_t           m_end;       /**< index in file (not buffer) of end of valid data */
+    struct SBlock
+    {
+      size_t   slot;    /**< index of the block in m_buf */
+      size_t   beg;     /**< offset in block of beginning of valid data */
+      size_t   end;     /**< offset in block of end of valid data */
+      uint64_t lastUse; /**< value of m_useCount when the block was last read or written */
+    };
+    typedef std::map<int64_t, SBlock> BlockMap; /**< index of block in file -> block */
+
+    bool Contains(int64_t pos) const;
+    int64_t ContiguousBegin(int64_t pos) const;
+    int64_t ContiguousEnd(int64_t pos) const;
+    size_t GetWritableSize() const;
+    bool AllocateSlot(size_t& slot);
+    void Clear();
+
+    int64_t           m_beg;       /**< index in file (not buffer) of beginning of valid data read from */
+    int64_t           m_end;       /**< index in file (not buffer) of end of valid data read from */
     int64_t           m_cur;       /**< current reading index in file */
     uint8_t          *m_buf;       /**< buffer holding data */
     size_t            m_size;      /**< size of data buffer used (m_buf) */
     size_t            m_size_back; /**< guaranteed size of back buffer (actual size can be smaller, or larger if front buffer doesn't need it) */
+    size_t            m_blockSize; /**< size of a block, a multiple of it is used of m_buf */
+    BlockMap          m_blocks;    /**< blocks holding data, including regions other than [m_beg, m_end] */
+    std::vector<size_t> m_free;    /**< slots of m_buf not holding data */
+    uint64_t          m_useCount;
     CCriticalSection  m_sync;
     CEvent            m_written;
 #ifdef TARGET_WINDOWS
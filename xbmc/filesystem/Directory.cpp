@@ -325,7 +325,10 @@ bool CDirectory::Create(const CURL& url)
     std::unique_ptr<IDirectory> pDirectory(CDirectoryFactory::Create(realURL));
     if (pDirectory)
       if(pDirectory->Create(realURL))
+      {
+        g_directoryCache.ClearFile(realURL.Get());
         return true;
+      }
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (...)
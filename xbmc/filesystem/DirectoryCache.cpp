@@ -18,19 +18,70 @@
 
 #include <algorithm>
 #include <climits>
-
-// Maximum number of directories to keep in our cache
-#define MAX_CACHED_DIRS 50
+#include <functional>
 
 using namespace XFILE;
 
-CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
+namespace
+{
+// milliseconds results are trusted without asking the source again, local
+// files can be changed by others at any time, listing a share is expensive
+const struct
+{
+  const char* protocol;
+  unsigned int timeToLive;
+} TimeToLive[] = {
+  {"", 10 * 1000},
+  {"file", 10 * 1000},
+  {"smb", 120 * 1000},
+  {"nfs", 120 * 1000},
+  {"ftp", 120 * 1000},
+  {"ftps", 120 * 1000},
+  {"sftp", 120 * 1000},
+  {"dav", 120 * 1000},
+  {"davs", 120 * 1000},
+  {"upnp", 120 * 1000},
+};
+
+// everything else, e.g. addon or http listings
+const unsigned int DefaultTimeToLive = 30 * 1000;
+
+// estimate of what a missing file costs beyond its path
+const size_t MissingFileSize = 64;
+
+size_t EstimateSize(const CFileItem& item)
+{
+  return sizeof(CFileItem) + item.GetPath().size() + item.GetLabel().size();
+}
+
+size_t EstimateSize(const CFileItemList& items)
+{
+  size_t size = sizeof(CFileItemList);
+  for (int i = 0; i < items.Size(); i++)
+    size += EstimateSize(*items[i]);
+  return size;
+}
+
+// the path as it is stored, URL options would break the compare
+std::string GetStoredPath(const std::string& strPath)
+{
+  std::string storedPath = CURL(strPath).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(storedPath);
+  return storedPath;
+}
+} // namespace
+
+CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType, unsigned int timeToLive)
 {
   m_cacheType = cacheType;
   m_lastAccess = 0;
   m_Items = new CFileItemList;
   m_Items->SetIgnoreURLOptions(true);
   m_Items->SetFastLookup(true);
+  if (cacheType == DIR_CACHE_ALWAYS || timeToLive == 0)
+    m_expires.SetInfinite();
+  else
+    m_expires.Set(timeToLive);
 }
 
 CDirectoryCache::CDir::~CDir()
@@ -38,13 +89,20 @@ CDirectoryCache::CDir::~CDir()
   delete m_Items;
 }
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
+void CDirectoryCache::CDir::SetLastAccess(std::atomic<unsigned int>& accessCounter)
 {
   m_lastAccess = accessCounter++;
 }
 
-CDirectoryCache::CDirectoryCache(void)
+bool CDirectoryCache::CDir::IsExpired() const
+{
+  return m_expires.IsTimePast();
+}
+
+CDirectoryCache::CDirectoryCache(size_t maxSize /* = 16 MiB */)
+  : m_maxSize(maxSize)
 {
+  m_size = 0;
   m_accessCounter = 0;
 #ifdef _DEBUG
   m_cacheHits = 0;
@@ -52,20 +110,42 @@ CDirectoryCache::CDirectoryCache(void)
 #endif
 }
 
-CDirectoryCache::~CDirectoryCache(void) = default;
+CDirectoryCache::~CDirectoryCache(void)
+{
+  Clear();
+}
 
-bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+unsigned int CDirectoryCache::GetTimeToLive(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
+  const std::string protocol = CURL(strPath).GetProtocol();
+  for (const auto& entry : TimeToLive)
+  {
+    if (StringUtils::EqualsNoCase(protocol, entry.protocol))
+      return entry.timeToLive;
+  }
+  return DefaultTimeToLive;
+}
 
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
+CDirectoryCache::SShard& CDirectoryCache::GetShard(const std::string& storedPath)
+{
+  return m_shards[std::hash<std::string>()(storedPath) % SHARDS];
+}
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+{
+  const std::string storedPath = GetStoredPath(strPath);
+  SShard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
+
+  iCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
   {
     CDir* dir = i->second;
+    if (dir->IsExpired())
+    {
+      Delete(shard, i);
+      return false;
+    }
     if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
        (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
     {
@@ -96,20 +176,29 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  CSingleLock lock (m_cs);
+  const std::string storedPath = GetStoredPath(strPath);
 
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
+  // copied before taking the lock, lookups of the shard don't wait for it
+  CDir* dir = new CDir(cacheType, GetTimeToLive(storedPath));
+  dir->m_Items->Copy(items);
+  dir->m_size = storedPath.size() + EstimateSize(items);
 
-  ClearDirectory(storedPath);
+  {
+    SShard& shard = GetShard(storedPath);
+    CSingleLock lock(shard.m_cs);
 
-  CheckIfFull();
+    iCache i = shard.m_cache.find(storedPath);
+    if (i != shard.m_cache.end())
+      Delete(shard, i);
+    // the listing knows better
+    DeleteMissing(shard, storedPath);
 
-  CDir* dir = new CDir(cacheType);
-  dir->m_Items->Copy(items);
-  dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+    dir->SetLastAccess(m_accessCounter);
+    shard.m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+    m_size += dir->m_size;
+  }
+
+  CheckIfFull();
 }
 
 void CDirectoryCache::ClearFile(const std::string& strFile)
@@ -122,55 +211,106 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
-
-  iCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
-    Delete(i);
+  const std::string storedPath = GetStoredPath(strPath);
+  SShard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
+
+  iCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
+    Delete(shard, i);
+  DeleteMissing(shard, storedPath);
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (SShard& shard : m_shards)
   {
-    if (URIUtils::PathHasParent(i->first, storedPath))
-      Delete(i++);
-    else
-      i++;
+    CSingleLock lock(shard.m_cs);
+
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end())
+    {
+      if (URIUtils::PathHasParent(i->first, storedPath))
+        Delete(shard, i++);
+      else
+        i++;
+    }
+
+    auto missing = shard.m_missing.begin();
+    while (missing != shard.m_missing.end())
+    {
+      if (URIUtils::PathHasParent(missing->first, storedPath))
+        DeleteMissing(shard, (missing++)->first);
+      else
+        missing++;
+    }
   }
 }
 
 void CDirectoryCache::AddFile(const std::string& strFile)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
-  std::string strPath = URIUtils::GetDirectory(CURL(strFile).GetWithoutOptions());
+  std::string strFile2 = CURL(strFile).GetWithoutOptions();
+  std::string strPath = URIUtils::GetDirectory(strFile2);
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
+  SShard& shard = GetShard(strPath);
+  CSingleLock lock(shard.m_cs);
+
+  auto missing = shard.m_missing.find(strPath);
+  if (missing != shard.m_missing.end() && missing->second.erase(strFile2) > 0)
+  {
+    m_size -= strFile2.size() + MissingFileSize;
+    if (missing->second.empty())
+      shard.m_missing.erase(missing);
+  }
+
+  ciCache i = shard.m_cache.find(strPath);
+  if (i != shard.m_cache.end())
   {
     CDir *dir = i->second;
     CFileItemPtr item(new CFileItem(strFile, false));
     dir->m_Items->Add(item);
     dir->SetLastAccess(m_accessCounter);
+    dir->m_size += EstimateSize(*item);
+    m_size += EstimateSize(*item);
+  }
+}
+
+void CDirectoryCache::AddMissingFile(const std::string& strFile)
+{
+  std::string strFile2 = CURL(strFile).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(strFile2);
+  std::string strPath = URIUtils::GetDirectory(strFile2);
+  URIUtils::RemoveSlashAtEnd(strPath);
+
+  const unsigned int timeToLive = GetTimeToLive(strPath);
+  if (timeToLive == 0)
+    return;
+
+  {
+    SShard& shard = GetShard(strPath);
+    CSingleLock lock(shard.m_cs);
+
+    // a listing of the directory already answers it
+    if (shard.m_cache.find(strPath) != shard.m_cache.end())
+      return;
+
+    MissingFiles& missing = shard.m_missing[strPath];
+    if (missing.insert(std::make_pair(strFile2, XbmcThreads::EndTime(timeToLive))).second)
+      m_size += strFile2.size() + MissingFileSize;
+    else
+      missing[strFile2].Set(timeToLive);
   }
+
+  CheckIfFull();
 }
 
 bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 {
-  CSingleLock lock (m_cs);
   bInCache = false;
 
   // Get rid of any URL options, else the compare may be wrong
@@ -179,8 +319,13 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
   std::string storedPath = URIUtils::GetDirectory(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  SShard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
+
+  iCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end() && i->second->IsExpired())
+    Delete(shard, i);
+  else if (i != shard.m_cache.end())
   {
     bInCache = true;
     CDir *dir = i->second;
@@ -190,6 +335,27 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 #endif
     return (URIUtils::PathEquals(strPath, storedPath) || dir->m_Items->Contains(strFile));
   }
+
+  auto missing = shard.m_missing.find(storedPath);
+  if (missing != shard.m_missing.end())
+  {
+    auto file = missing->second.find(strPath);
+    if (file != missing->second.end())
+    {
+      if (!file->second.IsTimePast())
+      {
+        bInCache = true;
+#ifdef _DEBUG
+        m_cacheHits++;
+#endif
+        return false;
+      }
+      m_size -= file->first.size() + MissingFileSize;
+      missing->second.erase(file);
+      if (missing->second.empty())
+        shard.m_missing.erase(missing);
+    }
+  }
 #ifdef _DEBUG
   m_cacheMisses++;
 #endif
@@ -199,11 +365,16 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
-  CSingleLock lock (m_cs);
+  for (SShard& shard : m_shards)
+  {
+    CSingleLock lock(shard.m_cs);
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end() )
-    Delete(i++);
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end() )
+      Delete(shard, i++);
+    while (!shard.m_missing.empty())
+      DeleteMissing(shard, shard.m_missing.begin()->first);
+  }
 }
 
 void CDirectoryCache::InitCache(std::set<std::string>& dirs)
@@ -218,60 +389,127 @@ void CDirectoryCache::InitCache(std::set<std::string>& dirs)
 
 void CDirectoryCache::ClearCache(std::set<std::string>& dirs)
 {
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
-  {
-    if (dirs.find(i->first) != dirs.end())
-      Delete(i++);
-    else
-      i++;
-  }
+  for (const std::string& dir : dirs)
+    ClearDirectory(dir);
 }
 
 void CDirectoryCache::CheckIfFull()
 {
-  CSingleLock lock (m_cs);
-
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  while (m_size > m_maxSize)
   {
-    // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    // find the last accessed folder over all shards, dropping what expired on the way
+    SShard* lastAccessedShard = nullptr;
+    std::string lastAccessedPath;
+    unsigned int lastAccess = 0;
+    for (SShard& shard : m_shards)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      CSingleLock lock(shard.m_cs);
+
+      iCache i = shard.m_cache.begin();
+      while (i != shard.m_cache.end())
+      {
+        CDir* dir = i->second;
+        if (dir->IsExpired())
+          Delete(shard, i++);
+        // ensure dirs that are always cached aren't cleared
+        else if (dir->m_cacheType != DIR_CACHE_ALWAYS &&
+                 (!lastAccessedShard || m_accessCounter - dir->GetLastAccess() > m_accessCounter - lastAccess))
+        {
+          lastAccessedShard = &shard;
+          lastAccessedPath = i->first;
+          lastAccess = dir->GetLastAccess();
+          i++;
+        }
+        else
+          i++;
+      }
+
+      for (auto missing = shard.m_missing.begin(); missing != shard.m_missing.end();)
+      {
+        MissingFiles& files = missing->second;
+        for (auto file = files.begin(); file != files.end();)
+        {
+          if (file->second.IsTimePast())
+          {
+            m_size -= file->first.size() + MissingFileSize;
+            file = files.erase(file);
+          }
+          else
+            file++;
+        }
+        if (files.empty())
+          missing = shard.m_missing.erase(missing);
+        else
+          missing++;
+      }
     }
+
+    if (m_size <= m_maxSize)
+      break;
+
+    if (!lastAccessedShard)
+    {
+      // only files known to be missing are left to give up
+      for (SShard& shard : m_shards)
+      {
+        CSingleLock lock(shard.m_cs);
+        while (!shard.m_missing.empty())
+          DeleteMissing(shard, shard.m_missing.begin()->first);
+      }
+      break;
+    }
+
+    CSingleLock lock(lastAccessedShard->m_cs);
+    iCache i = lastAccessedShard->m_cache.find(lastAccessedPath);
+    if (i != lastAccessedShard->m_cache.end() && i->second->GetLastAccess() == lastAccess)
+      Delete(*lastAccessedShard, i);
   }
-  if (lastAccessed != m_cache.end() && numCached >= MAX_CACHED_DIRS)
-    Delete(lastAccessed);
 }
 
-void CDirectoryCache::Delete(iCache it)
+void CDirectoryCache::Delete(SShard& shard, iCache it)
 {
   CDir* dir = it->second;
+  m_size -= dir->m_size;
   delete dir;
-  m_cache.erase(it);
+  shard.m_cache.erase(it);
+}
+
+void CDirectoryCache::DeleteMissing(SShard& shard, const std::string& storedPath)
+{
+  auto missing = shard.m_missing.find(storedPath);
+  if (missing == shard.m_missing.end())
+    return;
+
+  for (const auto& file : missing->second)
+    m_size -= file.first.size() + MissingFileSize;
+  shard.m_missing.erase(missing);
 }
 
 #ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
-  CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
+  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__,
+            static_cast<unsigned int>(m_cacheHits), static_cast<unsigned int>(m_cacheMisses));
   // run through and find the oldest and the number of items cached
   unsigned int oldest = UINT_MAX;
   unsigned int numItems = 0;
   unsigned int numDirs = 0;
-  for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
+  unsigned int numMissing = 0;
+  for (const SShard& shard : m_shards)
   {
-    CDir *dir = i->second;
-    oldest = std::min(oldest, dir->GetLastAccess());
-    numItems += dir->m_Items->Size();
-    numDirs++;
+    CSingleLock lock(shard.m_cs);
+    for (ciCache i = shard.m_cache.begin(); i != shard.m_cache.end(); i++)
+    {
+      CDir *dir = i->second;
+      oldest = std::min(oldest, dir->GetLastAccess());
+      numItems += dir->m_Items->Size();
+      numDirs++;
+    }
+    for (const auto& missing : shard.m_missing)
+      numMissing += missing.second.size();
   }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, static_cast<unsigned int>(m_accessCounter));
+  CLog::Log(LOGDEBUG, "%s - %u missing files cached, %zu of %zu bytes used", __FUNCTION__, numMissing,
+            static_cast<size_t>(m_size), m_maxSize);
 }
 #endif
@@ -10,34 +10,60 @@
 
 #include "IDirectory.h"
 #include "threads/CriticalSection.h"
+#include "threads/SystemClock.h"
 
+#include <atomic>
 #include <map>
 #include <set>
+#include <string>
 
 class CFileItem;
 
 namespace XFILE
 {
+  /*!
+   \brief Cache of directory listings and of files known not to exist
+
+   The cache is split into shards by directory, each with its own lock, so
+   lookups of different directories don't wait for each other. Entries expire
+   after a time depending on the protocol, listings of DIR_CACHE_ALWAYS
+   directories are kept until they are cleared. The least recently used
+   listings are dropped once the cache grows beyond its size budget.
+   */
   class CDirectoryCache
   {
     class CDir
     {
     public:
-      explicit CDir(DIR_CACHE_TYPE cacheType);
+      CDir(DIR_CACHE_TYPE cacheType, unsigned int timeToLive);
       virtual ~CDir();
 
-      void SetLastAccess(unsigned int &accessCounter);
+      void SetLastAccess(std::atomic<unsigned int>& accessCounter);
       unsigned int GetLastAccess() const { return m_lastAccess; };
+      bool IsExpired() const;
 
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
+      size_t m_size = 0; //!< estimated memory used by the listing
     private:
       CDir(const CDir&) = delete;
       CDir& operator=(const CDir&) = delete;
       unsigned int m_lastAccess;
+      XbmcThreads::EndTime m_expires;
+    };
+
+    //! files of a directory known not to exist, until their time is past
+    typedef std::map<std::string, XbmcThreads::EndTime> MissingFiles;
+
+    struct SShard
+    {
+      mutable CCriticalSection m_cs;
+      std::map<std::string, CDir*> m_cache;
+      std::map<std::string, MissingFiles> m_missing;
     };
+
   public:
-    CDirectoryCache(void);
+    explicit CDirectoryCache(size_t maxSize = 16 * 1024 * 1024);
     virtual ~CDirectoryCache(void);
     bool GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll = false);
     void SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType);
@@ -46,27 +72,43 @@ namespace XFILE
     void ClearSubPaths(const std::string& strPath);
     void Clear();
     void AddFile(const std::string& strFile);
+    /*!
+     \brief Remember that a file doesn't exist, FileExists() returns it as
+     cached until it is added or its directory changes
+     */
+    void AddMissingFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
+    //! estimated memory used by all entries
+    size_t GetSize() const { return m_size; }
+    /*!
+     \brief Milliseconds a cached result for the path is used
+     \return 0 if it doesn't expire
+     */
+    static unsigned int GetTimeToLive(const std::string& strPath);
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
   protected:
+    static const unsigned int SHARDS = 16;
+
     void InitCache(std::set<std::string>& dirs);
     void ClearCache(std::set<std::string>& dirs);
     void CheckIfFull();
 
-    std::map<std::string, CDir*> m_cache;
+    SShard& GetShard(const std::string& storedPath);
     typedef std::map<std::string, CDir*>::iterator iCache;
     typedef std::map<std::string, CDir*>::const_iterator ciCache;
-    void Delete(iCache i);
-
-    mutable CCriticalSection m_cs;
+    void Delete(SShard& shard, iCache i);
+    void DeleteMissing(SShard& shard, const std::string& storedPath);
 
-    unsigned int m_accessCounter;
+    SShard m_shards[SHARDS];
+    const size_t m_maxSize;
+    std::atomic<size_t> m_size;
+    std::atomic<unsigned int> m_accessCounter;
 
 #ifdef _DEBUG
-    unsigned int m_cacheHits;
-    unsigned int m_cacheMisses;
+    std::atomic<unsigned int> m_cacheHits;
+    std::atomic<unsigned int> m_cacheMisses;
 #endif
   };
 }
@@ -0,0 +1,314 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DirectoryWalker.h"
+
+#include "Directory.h"
+#include "FileItem.h"
+#include "URL.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+
+using namespace XFILE;
+
+namespace
+{
+// listings done but not returned yet, bounds the memory used when the
+// caller is slower than the listings
+const unsigned int MAX_BUFFERED = 256;
+} // namespace
+
+struct CDirectoryWalker::SNode
+{
+  enum STATE
+  {
+    QUEUED,
+    SUBMITTED, //!< a job is queued for it, it is still listed by the caller if needed first
+    LISTING,
+    DONE
+  };
+
+  explicit SNode(const std::string& strPath) : path(strPath), host(CURL(strPath).GetHostName()) {}
+
+  std::string path;
+  std::string host;
+  STATE state = QUEUED;
+  bool skipped = false; //!< won't be returned
+  CFileItemList items;
+  std::vector<std::shared_ptr<SNode>> children; //!< folders to walk into, in listing order
+};
+
+struct CDirectoryWalker::SState
+{
+  CCriticalSection section;
+  CEvent changed;
+  XbmcThreads::ConditionVariable callbacksDone;
+  unsigned int callbacks = 0; //!< prepare or filter calls in progress
+  std::string mask;
+  unsigned int flags;
+  unsigned int maxPerHost;
+  Filter filter;
+  Prepare prepare;
+  std::map<std::string, std::deque<std::shared_ptr<SNode>>> queues; //!< per host, breadth-first
+  std::map<std::string, unsigned int> listing; //!< listings in flight per host
+  unsigned int inFlight = 0;
+  unsigned int buffered = 0;
+  bool cancelled = false;
+};
+
+CDirectoryWalker::CDirectoryWalker(const std::string& strPath, const std::string& strMask,
+                                   unsigned int flags /* = DIR_FLAG_DEFAULTS */,
+                                   unsigned int maxPerHost /* = 4 */)
+  : m_state(std::make_shared<SState>()), m_root(std::make_shared<SNode>(strPath))
+{
+  m_state->mask = strMask;
+  m_state->flags = flags;
+  m_state->maxPerHost = std::max(maxPerHost, 1u);
+  m_state->filter = [](const CFileItem& item) { return item.m_bIsFolder; };
+}
+
+CDirectoryWalker::~CDirectoryWalker()
+{
+  // jobs in flight keep the state until they are done
+  Cancel();
+}
+
+void CDirectoryWalker::SetFilter(Filter filter)
+{
+  m_state->filter = std::move(filter);
+}
+
+void CDirectoryWalker::SetPrepare(Prepare prepare)
+{
+  m_state->prepare = std::move(prepare);
+}
+
+bool CDirectoryWalker::Next(CFileItemList& items)
+{
+  items.Clear();
+
+  if (!m_started)
+  {
+    m_started = true;
+    m_stack.push_back(m_root);
+    m_root.reset();
+  }
+
+  if (m_last)
+  {
+    if (!m_last->skipped)
+      m_stack.insert(m_stack.end(), m_last->children.rbegin(), m_last->children.rend());
+    m_last->children.clear();
+    m_last.reset();
+  }
+
+  if (m_stack.empty())
+    return false;
+
+  std::shared_ptr<SNode> node = m_stack.back();
+  m_stack.pop_back();
+
+  CSingleLock lock(m_state->section);
+  while (node->state != SNode::DONE)
+  {
+    if (m_state->cancelled)
+      return false;
+
+    if (node->state == SNode::QUEUED || node->state == SNode::SUBMITTED)
+    {
+      // needed now, don't wait for a job to pick it up
+      if (node->state == SNode::QUEUED)
+        StartListing(*m_state, *node);
+      node->state = SNode::LISTING;
+      CSingleExit exit(m_state->section);
+      List(m_state, node);
+    }
+    else
+    {
+      CSingleExit exit(m_state->section);
+      m_state->changed.Wait();
+    }
+  }
+
+  if (m_state->cancelled)
+    return false;
+
+  m_state->buffered--;
+  items.Append(node->items);
+  items.SetPath(node->items.GetPath());
+  node->items.Clear();
+  m_last = node;
+
+  Dispatch(m_state);
+  return true;
+}
+
+void CDirectoryWalker::SkipChildren()
+{
+  if (!m_last)
+    return;
+
+  CSingleLock lock(m_state->section);
+  for (const auto& child : m_last->children)
+    Skip(*m_state, *child);
+  m_last->children.clear();
+}
+
+void CDirectoryWalker::Cancel()
+{
+  CSingleLock lock(m_state->section);
+  m_state->cancelled = true;
+  m_state->queues.clear();
+  m_state->changed.Set();
+
+  // the callbacks may use objects of the caller, which can go once this returns
+  while (m_state->callbacks > 0)
+    m_state->callbacksDone.wait(lock);
+}
+
+void CDirectoryWalker::StartListing(SState& state, SNode& node)
+{
+  node.state = SNode::SUBMITTED;
+  state.listing[node.host]++;
+  state.inFlight++;
+}
+
+void CDirectoryWalker::Skip(SState& state, SNode& node)
+{
+  if (node.skipped)
+    return;
+
+  node.skipped = true;
+  if (node.state == SNode::DONE)
+  {
+    state.buffered--;
+    node.items.Clear();
+  }
+  for (const auto& child : node.children)
+    Skip(state, *child);
+  node.children.clear();
+}
+
+void CDirectoryWalker::List(const std::shared_ptr<SState>& state, const std::shared_ptr<SNode>& node)
+{
+  CFileItemList items;
+  std::vector<std::shared_ptr<SNode>> children;
+  bool cancelled;
+  {
+    CSingleLock lock(state->section);
+    cancelled = state->cancelled || node->skipped;
+  }
+
+  if (!cancelled)
+  {
+    CDirectory::GetDirectory(node->path, items, state->mask, state->flags);
+    items.SetPath(node->path);
+
+    {
+      CSingleLock lock(state->section);
+      cancelled = state->cancelled || node->skipped;
+      if (!cancelled)
+        state->callbacks++;
+    }
+  }
+
+  if (!cancelled)
+  {
+    if (state->prepare)
+      state->prepare(items);
+
+    for (const auto& item : items)
+    {
+      if (state->filter(*item))
+        children.push_back(std::make_shared<SNode>(item->GetPath()));
+    }
+
+    CSingleLock lock(state->section);
+    state->callbacks--;
+    state->callbacksDone.notifyAll();
+  }
+
+  CSingleLock lock(state->section);
+  state->listing[node->host]--;
+  state->inFlight--;
+  node->state = SNode::DONE;
+  if (!node->skipped && !state->cancelled)
+  {
+    node->items.Append(items);
+    node->items.SetPath(items.GetPath());
+    node->children = children;
+    state->buffered++;
+    for (const auto& child : children)
+      state->queues[child->host].push_back(child);
+    Dispatch(state);
+  }
+  state->changed.Set();
+}
+
+void CDirectoryWalker::Dispatch(const std::shared_ptr<SState>& state)
+{
+  // called with the section held
+  for (auto& queue : state->queues)
+  {
+    std::deque<std::shared_ptr<SNode>>& nodes = queue.second;
+    while (!nodes.empty() && !state->cancelled &&
+           state->listing[queue.first] < state->maxPerHost &&
+           state->buffered + state->inFlight < MAX_BUFFERED)
+    {
+      std::shared_ptr<SNode> node = nodes.front();
+      nodes.pop_front();
+      // listed by the caller or not needed anymore
+      if (node->state != SNode::QUEUED || node->skipped)
+        continue;
+
+      StartListing(*state, *node);
+      CJobManager::GetInstance().Submit([state, node]() {
+        {
+          // listed by the caller meanwhile
+          CSingleLock lock(state->section);
+          if (node->state != SNode::SUBMITTED)
+            return;
+          node->state = SNode::LISTING;
+        }
+        List(state, node);
+      }, CJob::PRIORITY_NORMAL);
+    }
+  }
+}
+
+void CDirectoryWalker::AddListing(CDirectoryWalker& walker, const CFileItemList& listing, CFileItemList& items)
+{
+  for (const auto& item : listing)
+  {
+    if (item->m_bIsFolder)
+    {
+      CFileItemList subListing;
+      if (walker.Next(subListing))
+        AddListing(walker, subListing, items);
+    }
+    else
+      items.Add(item);
+  }
+}
+
+void CDirectoryWalker::GetRecursiveListing(const std::string& strPath, CFileItemList& items,
+                                           const std::string& strMask,
+                                           unsigned int flags /* = DIR_FLAG_DEFAULTS */)
+{
+  CDirectoryWalker walker(strPath, strMask, flags);
+  CFileItemList listing;
+  if (walker.Next(listing))
+    AddListing(walker, listing, items);
+}
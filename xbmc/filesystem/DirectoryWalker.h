@@ -0,0 +1,81 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "IDirectory.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CFileItem;
+class CFileItemList;
+
+namespace XFILE
+{
+  /*!
+   \brief Walks a directory tree with several listings in flight
+
+   Directories are listed breadth-first on the job manager, at most
+   maxPerHost at a time for each host, and returned depth-first in the order
+   of their parent's listing, like a recursive walk visits them. A directory
+   that is needed before a job got to it is listed by the caller itself.
+   */
+  class CDirectoryWalker
+  {
+  public:
+    //! whether to walk into a folder of a listing, called on any thread until Cancel() returns
+    typedef std::function<bool(const CFileItem& item)> Filter;
+    //! prepares a listing before its folders are walked into, called on any thread until Cancel() returns
+    typedef std::function<void(CFileItemList& items)> Prepare;
+
+    CDirectoryWalker(const std::string& strPath, const std::string& strMask,
+                     unsigned int flags = DIR_FLAG_DEFAULTS, unsigned int maxPerHost = 4);
+    ~CDirectoryWalker();
+
+    //! default walks into every folder, set before the first Next()
+    void SetFilter(Filter filter);
+    void SetPrepare(Prepare prepare);
+
+    /*!
+     \brief Wait for the next directory of the walk
+     \param items listing of the directory, its path is the directory
+     \return false once all directories were returned or the walk was cancelled
+     */
+    bool Next(CFileItemList& items);
+    //! don't walk into the folders of the directory last returned by Next()
+    void SkipChildren();
+    //! stop listing directories, Next() returns false from now on
+    void Cancel();
+
+    /*!
+     \brief Like CUtil::GetRecursiveListing(), with the directories listed in parallel
+     */
+    static void GetRecursiveListing(const std::string& strPath, CFileItemList& items,
+                                    const std::string& strMask,
+                                    unsigned int flags = DIR_FLAG_DEFAULTS);
+
+  private:
+    struct SNode;
+    struct SState;
+
+    static void List(const std::shared_ptr<SState>& state, const std::shared_ptr<SNode>& node);
+    static void Dispatch(const std::shared_ptr<SState>& state);
+    static void StartListing(SState& state, SNode& node);
+    static void Skip(SState& state, SNode& node);
+    static void AddListing(CDirectoryWalker& walker, const CFileItemList& listing, CFileItemList& items);
+
+    std::shared_ptr<SState> m_state;
+    std::shared_ptr<SNode> m_root;
+    std::vector<std::shared_ptr<SNode>> m_stack; //!< to return, next one last
+    std::shared_ptr<SNode> m_last; //!< returned by Next(), its folders not yet on the stack
+    bool m_started = false;
+  };
+}
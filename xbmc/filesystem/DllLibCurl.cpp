@@ -8,11 +8,16 @@
 
 #include "DllLibCurl.h"
 
+#include "ServiceBroker.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <cinttypes>
 
 namespace XCURL
 {
@@ -97,6 +102,16 @@ CURLMcode DllLibCurl::multi_cleanup(CURLM* handle)
   return curl_multi_cleanup(handle);
 }
 
+CURLSH* DllLibCurl::share_init()
+{
+  return curl_share_init();
+}
+
+CURLSHcode DllLibCurl::share_cleanup(CURLSH* share_handle)
+{
+  return curl_share_cleanup(share_handle);
+}
+
 curl_slist* DllLibCurl::slist_append(curl_slist* list, const char* to_append)
 {
   return curl_slist_append(list, to_append);
@@ -130,10 +145,30 @@ DllLibCurlGlobal::DllLibCurlGlobal()
   {
     CLog::Log(LOGERROR, "Error initializing libcurl");
   }
+
+  /* a new session resolves hosts and resumes tls sessions from the others. connections stay
+   * with their session, libcurl doesn't support sharing them between threads */
+  m_share = share_init();
+  if (m_share)
+  {
+    share_setopt(m_share, CURLSHOPT_LOCKFUNC, LockShare);
+    share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, UnlockShare);
+    share_setopt(m_share, CURLSHOPT_USERDATA, this);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  }
 }
 
 DllLibCurlGlobal::~DllLibCurlGlobal()
 {
+  // the share can't be cleaned up while handles use it
+  for (auto& it : m_sessions)
+    CloseSession(it);
+  m_sessions.clear();
+
+  if (m_share)
+    share_cleanup(m_share);
+
   // close libcurl
   curl_global_cleanup();
 }
@@ -153,20 +188,75 @@ void DllLibCurlGlobal::CheckIdle()
                 it->m_protocol.c_str(), it->m_hostname.c_str(), static_cast<void*>(it->m_easy),
                 static_cast<void*>(it->m_multi));
 
-      if (it->m_multi && it->m_easy)
-        multi_remove_handle(it->m_multi, it->m_easy);
-      if (it->m_easy)
-        easy_cleanup(it->m_easy);
-      if (it->m_multi)
-        multi_cleanup(it->m_multi);
-
+      CloseSession(*it);
       it = m_sessions.erase(it);
+
+      if (m_poolStats.m_transfers > 0)
+        CLog::Log(LOGDEBUG, "%s - %" PRIu64 " of %" PRIu64 " transfers reused a connection, %" PRIu64 " ms connecting", __FUNCTION__,
+                  m_poolStats.m_reused, m_poolStats.m_transfers, m_poolStats.m_connectMs);
       continue;
     }
     ++it;
   }
 }
 
+DllLibCurlGlobal::SPoolStats DllLibCurlGlobal::GetPoolStats()
+{
+  CSingleLock lock(m_critSection);
+  return m_poolStats;
+}
+
+void DllLibCurlGlobal::CloseSession(SSession& session)
+{
+  if (session.m_multi && session.m_easy)
+    multi_remove_handle(session.m_multi, session.m_easy);
+  if (session.m_easy)
+    easy_cleanup(session.m_easy);
+  if (session.m_multi)
+    multi_cleanup(session.m_multi);
+  session.m_easy = nullptr;
+  session.m_multi = nullptr;
+}
+
+void DllLibCurlGlobal::AddToPool(CURL_HANDLE* easy_handle)
+{
+  if (m_share)
+    easy_setopt(easy_handle, CURLOPT_SHARE, m_share);
+}
+
+void DllLibCurlGlobal::UpdatePoolStats(CURL_HANDLE* easy_handle)
+{
+  long code = 0;
+  if (easy_getinfo(easy_handle, CURLINFO_RESPONSE_CODE, &code) != CURLE_OK || code == 0)
+    return;
+
+  long connects = 0;
+  double connect = 0.0;
+  double appconnect = 0.0;
+  easy_getinfo(easy_handle, CURLINFO_NUM_CONNECTS, &connects);
+  easy_getinfo(easy_handle, CURLINFO_CONNECT_TIME, &connect);
+  easy_getinfo(easy_handle, CURLINFO_APPCONNECT_TIME, &appconnect);
+
+  m_poolStats.m_transfers++;
+  if (connects == 0)
+    m_poolStats.m_reused++;
+  else
+    m_poolStats.m_connectMs += static_cast<uint64_t>(std::max(connect, appconnect) * 1000);
+}
+
+void DllLibCurlGlobal::LockShare(CURL_HANDLE* easy_handle,
+                                 curl_lock_data data,
+                                 curl_lock_access access,
+                                 void* userptr)
+{
+  static_cast<DllLibCurlGlobal*>(userptr)->m_shareLocks[data].lock();
+}
+
+void DllLibCurlGlobal::UnlockShare(CURL_HANDLE* easy_handle, curl_lock_data data, void* userptr)
+{
+  static_cast<DllLibCurlGlobal*>(userptr)->m_shareLocks[data].unlock();
+}
+
 void DllLibCurlGlobal::easy_acquire(const char* protocol,
                                     const char* hostname,
                                     CURL_HANDLE** easy_handle,
@@ -188,7 +278,10 @@ void DllLibCurlGlobal::easy_acquire(const char* protocol,
         if (easy_handle)
         {
           if (!it.m_easy)
+          {
             it.m_easy = easy_init();
+            AddToPool(it.m_easy);
+          }
 
           *easy_handle = it.m_easy;
         }
@@ -196,7 +289,10 @@ void DllLibCurlGlobal::easy_acquire(const char* protocol,
         if (multi_handle)
         {
           if (!it.m_multi)
+          {
             it.m_multi = multi_init();
+            multi_setopt(it.m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+          }
 
           *multi_handle = it.m_multi;
         }
@@ -214,12 +310,14 @@ void DllLibCurlGlobal::easy_acquire(const char* protocol,
   if (easy_handle)
   {
     session.m_easy = easy_init();
+    AddToPool(session.m_easy);
     *easy_handle = session.m_easy;
   }
 
   if (multi_handle)
   {
     session.m_multi = multi_init();
+    multi_setopt(session.m_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
     *multi_handle = session.m_multi;
   }
 
@@ -251,16 +349,60 @@ void DllLibCurlGlobal::easy_release(CURL_HANDLE** easy_handle, CURLM** multi_han
   {
     if (it.m_easy == easy && (multi == nullptr || it.m_multi == multi))
     {
+      UpdatePoolStats(easy);
+
       /* reset session so next caller doesn't reuse options, only connections */
       /* will reset verbose too so it won't print that it closed connections on cleanup*/
       easy_reset(easy);
       it.m_busy = false;
       it.m_idletimestamp = XbmcThreads::SystemClockMillis();
+
+      /* keep alive a few connections per host only */
+      const std::string protocol = it.m_protocol;
+      const std::string hostname = it.m_hostname;
+      LimitIdleSessions(protocol, hostname);
       return;
     }
   }
 }
 
+void DllLibCurlGlobal::LimitIdleSessions(const std::string& protocol, const std::string& hostname)
+{
+  const auto settings = CServiceBroker::GetSettingsComponent();
+  if (!settings)
+    return;
+
+  const unsigned int limit = settings->GetAdvancedSettings()->m_curlKeepAlivePerHost;
+  while (true)
+  {
+    unsigned int idle = 0;
+    auto oldest = m_sessions.end();
+    for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it)
+    {
+      if (it->m_busy || it->m_protocol != protocol || it->m_hostname != hostname)
+        continue;
+
+      idle++;
+      if (oldest == m_sessions.end() || it->m_idletimestamp < oldest->m_idletimestamp)
+        oldest = it;
+    }
+
+    if (idle <= limit)
+      return;
+
+    CloseSession(*oldest);
+    m_sessions.erase(oldest);
+  }
+}
+
+void DllLibCurlGlobal::easy_reset(CURL_HANDLE* easy_handle)
+{
+  DllLibCurl::easy_reset(easy_handle);
+
+  /* stay in the pool after options were reset */
+  AddToPool(easy_handle);
+}
+
 CURL_HANDLE* DllLibCurlGlobal::easy_duphandle(CURL_HANDLE* easy_handle)
 {
   CSingleLock lock(m_critSection);
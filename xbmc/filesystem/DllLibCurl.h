@@ -37,7 +37,7 @@ public:
   }
   CURLcode easy_perform(CURL_HANDLE* handle);
   CURLcode easy_pause(CURL_HANDLE* handle, int bitmask);
-  void easy_reset(CURL_HANDLE* handle);
+  virtual void easy_reset(CURL_HANDLE* handle);
   template<typename... Args>
   CURLcode easy_getinfo(CURL_HANDLE* curl, CURLINFO info, Args... args)
   {
@@ -46,6 +46,11 @@ public:
   void easy_cleanup(CURL_HANDLE* handle);
   virtual CURL_HANDLE* easy_duphandle(CURL_HANDLE* handle);
   CURLM* multi_init(void);
+  template<typename... Args>
+  CURLMcode multi_setopt(CURLM* multi_handle, CURLMoption option, Args... args)
+  {
+    return curl_multi_setopt(multi_handle, option, std::forward<Args>(args)...);
+  }
   CURLMcode multi_add_handle(CURLM* multi_handle, CURL_HANDLE* easy_handle);
   CURLMcode multi_perform(CURLM* multi_handle, int* running_handles);
   CURLMcode multi_remove_handle(CURLM* multi_handle, CURL_HANDLE* easy_handle);
@@ -57,6 +62,13 @@ public:
   CURLMcode multi_timeout(CURLM* multi_handle, long* timeout);
   CURLMsg* multi_info_read(CURLM* multi_handle, int* msgs_in_queue);
   CURLMcode multi_cleanup(CURLM* handle);
+  CURLSH* share_init();
+  template<typename... Args>
+  CURLSHcode share_setopt(CURLSH* share_handle, CURLSHoption option, Args... args)
+  {
+    return curl_share_setopt(share_handle, option, std::forward<Args>(args)...);
+  }
+  CURLSHcode share_cleanup(CURLSH* share_handle);
   curl_slist* slist_append(curl_slist* list, const char* to_append);
   void slist_free_all(curl_slist* list);
   const char* easy_strerror(CURLcode code);
@@ -75,8 +87,19 @@ public:
   void easy_release(CURL_HANDLE** easy_handle, CURLM** multi_handle);
   void easy_duplicate(CURL_HANDLE* easy, CURLM* multi, CURL_HANDLE** easy_out, CURLM** multi_out);
   CURL_HANDLE* easy_duphandle(CURL_HANDLE* easy_handle) override;
+  void easy_reset(CURL_HANDLE* easy_handle) override;
   void CheckIdle();
 
+  /* statistics of the transfers of released sessions */
+  typedef struct SPoolStats
+  {
+    uint64_t m_transfers; // transfers that got a response
+    uint64_t m_reused; // transfers that didn't open a new connection
+    uint64_t m_connectMs; // time spent on connecting and TLS handshakes
+  } SPoolStats;
+
+  SPoolStats GetPoolStats();
+
   /* overloaded load and unload with reference counter */
 
   /* structure holding a session info */
@@ -94,6 +117,22 @@ public:
 
   VEC_CURLSESSIONS m_sessions;
   CCriticalSection m_critSection;
+
+private:
+  void AddToPool(CURL_HANDLE* easy_handle);
+  void UpdatePoolStats(CURL_HANDLE* easy_handle);
+  void CloseSession(SSession& session);
+  void LimitIdleSessions(const std::string& protocol, const std::string& hostname);
+  static void LockShare(CURL_HANDLE* easy_handle,
+                        curl_lock_data data,
+                        curl_lock_access access,
+                        void* userptr);
+  static void UnlockShare(CURL_HANDLE* easy_handle, curl_lock_data data, void* userptr);
+
+  /* dns cache and tls sessions shared by all sessions */
+  CURLSH* m_share = nullptr;
+  CCriticalSection m_shareLocks[CURL_LOCK_DATA_LAST];
+  SPoolStats m_poolStats = {};
 };
 } // namespace XCURL
 
@@ -19,6 +19,9 @@
 #include "PasswordManager.h"
 #include "Util.h"
 #include "commons/Exception.h"
+#include "threads/Condition.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
 #include "utils/BitstreamStats.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -26,8 +29,99 @@
 
 #include "system.h"
 
+#include <algorithm>
+#include <deque>
+#include <memory>
+
 using namespace XFILE;
 
+namespace
+{
+/*!
+ * Threads running the reads of CFile::ReadAsync(). Jobs wait for these reads,
+ * on the job workers they could be queued behind the very jobs waiting.
+ */
+class CReadWorkers
+{
+public:
+  static CReadWorkers& GetInstance()
+  {
+    static CReadWorkers workers;
+    return workers;
+  }
+
+  ~CReadWorkers()
+  {
+    {
+      CSingleLock lock(m_section);
+      m_stopping = true;
+      m_queued.notifyAll();
+    }
+    for (auto& worker : m_workers)
+      worker->StopThread(false);
+    m_workers.clear();
+  }
+
+  void Submit(std::function<void()> read)
+  {
+    CSingleLock lock(m_section);
+    m_reads.push_back(std::move(read));
+    if (m_idle == 0 && m_workers.size() < MAX_WORKERS)
+    {
+      m_workers.emplace_back(new CWorker(*this));
+      m_workers.back()->Create();
+    }
+    else
+      m_queued.notify();
+  }
+
+private:
+  static const size_t MAX_WORKERS = 4;
+
+  class CWorker : public CThread
+  {
+  public:
+    explicit CWorker(CReadWorkers& workers) : CThread("FileRead"), m_workers(workers) {}
+    ~CWorker() override { StopThread(); }
+
+  protected:
+    void Process() override { m_workers.Work(); }
+
+  private:
+    CReadWorkers& m_workers;
+  };
+
+  CReadWorkers() = default;
+
+  void Work()
+  {
+    CSingleLock lock(m_section);
+    while (!m_stopping)
+    {
+      if (m_reads.empty())
+      {
+        m_idle++;
+        m_queued.wait(lock);
+        m_idle--;
+        continue;
+      }
+
+      std::function<void()> read = std::move(m_reads.front());
+      m_reads.pop_front();
+      CSingleExit exit(m_section);
+      read();
+    }
+  }
+
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_queued;
+  std::deque<std::function<void()>> m_reads;
+  std::vector<std::unique_ptr<CWorker>> m_workers;
+  size_t m_idle = 0;
+  bool m_stopping = false;
+};
+} // namespace
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -442,7 +536,16 @@ bool CFile::Exists(const CURL& file, bool bUseCache /* = true */)
     if (!pFile)
       return false;
 
-    return pFile->Exists(authUrl);
+    if (pFile->Exists(authUrl))
+      return true;
+
+    // the next lookups of a file on a network share are answered by the cache until the
+    // file is created, local files are often created right after they were found missing
+    const std::string path = url.Get();
+    if (URIUtils::IsSmb(path) || URIUtils::IsNfs(path) || URIUtils::IsFTP(path) ||
+        URIUtils::IsDAV(path) || URIUtils::IsUPnP(path) || url.IsProtocol("sftp"))
+      g_directoryCache.AddMissingFile(path);
+    return false;
   }
   XBMCCOMMONS_HANDLE_UNCHECKED
   catch (CRedirectException *pRedirectEx)
@@ -652,6 +755,16 @@ void CFile::Close()
 {
   try
   {
+    // queued reads use the file
+    std::vector<std::shared_ptr<CFileReadRequest>> requests;
+    {
+      CSingleLock lock(m_requestSection);
+      requests.swap(m_requests);
+    }
+    for (const auto& request : requests)
+      request->Wait();
+    m_readAtFile.reset();
+
     if (m_pFile)
       m_pFile->Close();
 
@@ -665,6 +778,107 @@ void CFile::Close()
   }
 }
 
+ssize_t CFile::ReadAt(int64_t position, const SReadBuffer* buffers, size_t count)
+{
+  if (!m_pFile)
+    return -1;
+
+  try
+  {
+    if (m_pFile->CanReadAt())
+      return m_pFile->ReadAt(position, buffers, count);
+
+    // a handle of our own, reads of the caller continue where they were
+    CSingleLock lock(m_readAtSection);
+    if (!m_readAtFile)
+    {
+      std::unique_ptr<CFile> file(new CFile()); // C++14 - Replace with std::make_unique
+      if (!file->Open(m_curl, (m_flags & ~READ_CACHED) | READ_NO_CACHE))
+        return -1;
+      m_readAtFile = std::move(file);
+    }
+
+    if (m_readAtFile->Seek(position, SEEK_SET) != position)
+      return -1;
+
+    ssize_t total = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+      size_t done = 0;
+      while (done < buffers[i].size)
+      {
+        const ssize_t read = m_readAtFile->Read(static_cast<char*>(buffers[i].data) + done,
+                                                buffers[i].size - done);
+        if (read < 0)
+          return -1;
+        if (read == 0)
+          return total + done;
+        done += read;
+      }
+      total += done;
+    }
+    return total;
+  }
+  XBMCCOMMONS_HANDLE_UNCHECKED
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
+  }
+  return -1;
+}
+
+ssize_t CFile::ReadAt(int64_t position, void* bufPtr, size_t bufSize)
+{
+  const SReadBuffer buffer = {bufPtr, bufSize};
+  return ReadAt(position, &buffer, 1);
+}
+
+std::unique_ptr<IFileView> CFile::Map(int64_t position, size_t size)
+{
+  try
+  {
+    if (m_pFile)
+      return m_pFile->Map(position, size);
+  }
+  XBMCCOMMONS_HANDLE_UNCHECKED
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
+  }
+  return nullptr;
+}
+
+std::shared_ptr<CFileReadRequest> CFile::ReadAsync(int64_t position, std::vector<SReadBuffer> buffers,
+                                                   std::function<void(ssize_t)> callback /* = nullptr */)
+{
+  std::shared_ptr<CFileReadRequest> request = std::make_shared<CFileReadRequest>();
+  {
+    CSingleLock lock(m_requestSection);
+    m_requests.erase(std::remove_if(m_requests.begin(), m_requests.end(),
+                                    [](const std::shared_ptr<CFileReadRequest>& pending) {
+                                      return pending->IsDone();
+                                    }),
+                     m_requests.end());
+    m_requests.push_back(request);
+  }
+
+  CReadWorkers::GetInstance().Submit([this, request, position, buffers, callback]() {
+    const ssize_t result = ReadAt(position, buffers.data(), buffers.size());
+    request->m_result = result;
+    if (callback)
+      callback(result);
+    request->m_done.Set();
+  });
+
+  return request;
+}
+
+std::shared_ptr<CFileReadRequest> CFile::ReadAsync(int64_t position, void* bufPtr, size_t bufSize,
+                                                   std::function<void(ssize_t)> callback /* = nullptr */)
+{
+  return ReadAsync(position, std::vector<SReadBuffer>{{bufPtr, bufSize}}, std::move(callback));
+}
+
 void CFile::Flush()
 {
   try
@@ -1068,6 +1282,36 @@ ssize_t CFile::LoadFile(const CURL& file, auto_buffer& outputBuffer)
   return total_read;
 }
 
+bool CFile::CanMap(const std::string& filename)
+{
+  for (const char* parent : {"special://xbmc/", "special://home/addons/", "special://temp/"})
+  {
+    if (URIUtils::PathHasParent(filename, parent, true))
+      return true;
+  }
+  return false;
+}
+
+std::unique_ptr<IFileView> CFile::MapFile(const std::string& filename)
+{
+  static const int64_t max_file_size = 0x7FFFFFFF;
+
+  // other files are read anyway, don't open them twice
+  if (!URIUtils::IsHD(filename) || !CanMap(filename))
+    return nullptr;
+
+  if (!Open(filename, READ_TRUNCATED | READ_NO_CACHE))
+    return nullptr;
+
+  std::unique_ptr<IFileView> view;
+  const int64_t filesize = GetLength();
+  if (filesize > 0 && filesize <= max_file_size)
+    view = Map(0, static_cast<size_t>(filesize));
+
+  Close();
+  return view;
+}
+
 double CFile::GetDownloadSpeed()
 {
   if (m_pFile)
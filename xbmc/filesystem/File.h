@@ -16,9 +16,14 @@
 
 #include "IFileTypes.h"
 #include "URL.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "utils/auto_buffer.h"
 
+#include <atomic>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <stdio.h>
 #include <string>
 #include <vector>
@@ -32,6 +37,7 @@ namespace XFILE
 
 using ::XUTILS::auto_buffer;
 class IFile;
+class IFileView;
 
 class IFileCallback
 {
@@ -42,6 +48,34 @@ public:
 
 class CFileStreamBuffer;
 
+/*!
+ * \brief Read queued by CFile::ReadAsync()
+ */
+class CFileReadRequest
+{
+public:
+  CFileReadRequest() : m_done(true) {}
+
+  /*!
+   \brief wait for the read to complete
+   \return true if it completed within milliSeconds
+   */
+  bool Wait(unsigned int milliSeconds) { return m_done.WaitMSec(milliSeconds); }
+  void Wait() { m_done.Wait(); }
+  bool IsDone() { return m_done.WaitMSec(0); }
+
+  /*!
+   \brief result like CFile::ReadAt(), valid once the read completed
+   */
+  ssize_t GetResult() const { return m_result; }
+
+private:
+  friend class CFile;
+
+  CEvent m_done;
+  std::atomic<ssize_t> m_result{-1};
+};
+
 class CFile
 {
 public:
@@ -70,6 +104,18 @@ public:
   bool OpenForWrite(const std::string& strFileName, bool bOverWrite = false);
 
   ssize_t LoadFile(const CURL &file, auto_buffer& outputBuffer);
+  /**
+   * Map a whole local file instead of reading it with LoadFile(). The file is
+   * closed again, the view stays valid.
+   * @return the view, nullptr if the file isn't local, isn't one of Kodi's own
+   *         files (see CanMap()) or can't be mapped
+   */
+  std::unique_ptr<IFileView> MapFile(const std::string& filename);
+  /**
+   * Whether a file is one of Kodi's own and may be mapped, see IFileView. These
+   * are installed with Kodi or an add-on or written to the temp folder.
+   */
+  static bool CanMap(const std::string& filename);
 
   /**
    * Attempt to read bufSize bytes from currently opened file into buffer bufPtr.
@@ -80,6 +126,32 @@ public:
    *         or undetectable error occur, -1 in case of any explicit error
    */
   ssize_t Read(void* bufPtr, size_t bufSize);
+  /**
+   * Attempt to fill several buffers one after another with the data at position.
+   * Doesn't change the position of the file and may be called from other threads
+   * while the file is read. Implementations that can't do that natively read
+   * through a second handle of the file.
+   * @return number of bytes read into all buffers, less than their size at end of
+   *         file, -1 in case of any explicit error
+   */
+  ssize_t ReadAt(int64_t position, const SReadBuffer* buffers, size_t count);
+  ssize_t ReadAt(int64_t position, void* bufPtr, size_t bufSize);
+  /**
+   * Queue ReadAt() on a read thread. The buffers must stay valid until the
+   * request completed, Close() waits for all requests of the file. Reads run on
+   * threads of their own rather than the job workers, so a job may wait for them.
+   * @param callback called on the read thread with the result before the
+   *                 request completes, it must not wait for other reads
+   */
+  std::shared_ptr<CFileReadRequest> ReadAsync(int64_t position, std::vector<SReadBuffer> buffers,
+                                              std::function<void(ssize_t)> callback = nullptr);
+  std::shared_ptr<CFileReadRequest> ReadAsync(int64_t position, void* bufPtr, size_t bufSize,
+                                              std::function<void(ssize_t)> callback = nullptr);
+  /**
+   * Borrow size bytes at position without copying them, see IFile::Map().
+   * @return the view, nullptr if the file can't be mapped
+   */
+  std::unique_ptr<IFileView> Map(int64_t position, size_t size);
   bool ReadString(char *szLine, int iLineLength);
   /**
    * Attempt to write bufSize bytes from buffer bufPtr into currently opened file.
@@ -177,6 +249,11 @@ private:
   IFile*              m_pFile;
   CFileStreamBuffer*  m_pBuffer;
   BitstreamStats*     m_bitStreamStats;
+
+  CCriticalSection    m_readAtSection;
+  std::unique_ptr<CFile> m_readAtFile; // second handle for ReadAt() if the implementation can't
+  CCriticalSection    m_requestSection;
+  std::vector<std::shared_ptr<CFileReadRequest>> m_requests; // of ReadAsync() not known to have completed
 };
 
 // streambuf for file io, only supports buffered input currently
@@ -14,8 +14,11 @@
 #include "ServiceBroker.h"
 
 #include "CircularCache.h"
+#include "ParallelRangeReader.h"
+#include "PersistentFileCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "utils/URIUtils.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 
@@ -35,6 +38,9 @@ using namespace XFILE;
 
 #define READ_CACHE_CHUNK_SIZE (128*1024)
 
+// bytes per request of parallel reads, large enough to hide the latency of a request
+#define PARALLEL_READ_SEGMENT_SIZE (1024*1024)
+
 class CWriteRate
 {
 public:
@@ -95,6 +101,9 @@ CFileCache::CFileCache(const unsigned int flags)
   , m_forward(0)
   , m_bFilling(false)
   , m_bLowSpeedDetected(false)
+  , m_seekCached(false)
+  , m_seeks(0)
+  , m_seekHits(0)
   , m_fileSize(0)
   , m_flags(flags)
 {
@@ -138,6 +147,26 @@ bool CFileCache::Open(const CURL& url)
   m_chunkSize = CFile::GetChunkSize(m_source.GetChunkSize(), READ_CACHE_CHUNK_SIZE);
   m_fileSize = m_source.GetLength();
 
+  const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+  bool cacheOpen = false;
+  if (!m_pCache && advancedSettings->m_cachePersistentSize > 0 && (m_flags & READ_AUDIO_VIDEO) &&
+      !(m_flags & READ_MULTI_STREAM) && m_seekPossible > 0 && m_fileSize > 0 &&
+      URIUtils::IsRemote(m_sourcePath))
+  {
+    // keep what was read for the next session, only the gaps are fetched then
+    struct __stat64 st = {};
+    int64_t modified = m_source.Stat(&st) == 0 ? static_cast<int64_t>(st.st_mtime) : 0;
+    const std::string path = URIUtils::AddFileToFolder(advancedSettings->m_cachePath, "streamcache");
+    const uint64_t budget = static_cast<uint64_t>(advancedSettings->m_cachePersistentSize) * 1024 * 1024;
+    std::unique_ptr<CPersistentFileCache> cache(new CPersistentFileCache(path, m_sourcePath, m_fileSize, modified, budget)); // C++14 - Replace with std::make_unique
+    if (cache->Open() == CACHE_RC_OK)
+    {
+      m_pCache = std::move(cache);
+      m_forwardCacheSize = 0;
+      cacheOpen = true;
+    }
+  }
+
   if (!m_pCache)
   {
     if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
@@ -180,15 +209,36 @@ bool CFileCache::Open(const CURL& url)
   }
 
   // open cache strategy
-  if (!m_pCache || m_pCache->Open() != CACHE_RC_OK)
+  if (!m_pCache || (!cacheOpen && m_pCache->Open() != CACHE_RC_OK))
   {
     CLog::Log(LOGERROR,"CFileCache::Open - failed to open cache");
     Close();
     return false;
   }
 
+  // several connections at once for links where one can't use the bandwidth
+  if (advancedSettings->m_cacheParallelReads > 1 && m_seekPossible > 0 && m_fileSize > 0 &&
+      URIUtils::IsInternetStream(m_sourcePath))
+  {
+    m_parallelReader.reset(new CParallelRangeReader(m_sourcePath, READ_NO_CACHE | READ_TRUNCATED | READ_CHUNKED,
+                                                    advancedSettings->m_cacheParallelReads,
+                                                    std::max<size_t>(m_chunkSize, PARALLEL_READ_SEGMENT_SIZE))); // C++14 - Replace with std::make_unique
+    m_parallelReader->Open(m_fileSize);
+  }
+
   m_readPos = 0;
-  m_writePos = 0;
+  m_seeks = 0;
+  m_seekHits = 0;
+  m_writePos = m_pCache->CachedDataEndPos();
+
+  // don't fetch what the cache already holds
+  if (m_writePos > 0 && m_writePos < m_fileSize && SeekSource(m_writePos) != m_writePos)
+  {
+    CLog::Log(LOGWARNING, "CFileCache::Open - unable to skip %" PRId64 " cached bytes", m_writePos);
+    m_pCache->Reset(0);
+    SeekSource(0);
+    m_writePos = 0;
+  }
   m_writeRate = 1024 * 1024;
   m_writeRateActual = 0;
   m_forward = 0;
@@ -220,7 +270,9 @@ void CFileCache::Process()
 
   CWriteRate limiter;
   CWriteRate average;
-  bool cacheReachEOF = false;
+  limiter.Reset(m_writePos);
+  average.Reset(m_writePos);
+  bool cacheReachEOF = m_fileSize > 0 && m_writePos >= m_fileSize;
 
   while (!m_bStop)
   {
@@ -236,7 +288,7 @@ void CFileCache::Process()
       bool sourceSeekFailed = false;
       if (!cacheReachEOF)
       {
-        m_nSeekResult = m_source.Seek(cacheMaxPos, SEEK_SET);
+        m_nSeekResult = SeekSource(cacheMaxPos);
         if (m_nSeekResult != cacheMaxPos)
         {
           CLog::Log(LOGERROR,"CFileCache::Process - Error %d seeking. Seek returned %" PRId64, (int)GetLastError(), m_nSeekResult);
@@ -253,6 +305,7 @@ void CFileCache::Process()
         average.Reset(m_writePos, bCompleteReset); // Can only recalculate new average from scratch after a full reset (empty cache)
         limiter.Reset(m_writePos);
         m_nSeekResult = m_seekPos;
+        m_seekCached = !bCompleteReset;
         if (bCompleteReset)
         {
           m_forward = 0;
@@ -296,7 +349,7 @@ void CFileCache::Process()
 
     ssize_t iRead = 0;
     if (!cacheReachEOF)
-      iRead = m_source.Read(buffer.get(), maxWrite);
+      iRead = ReadSource(buffer.get(), maxWrite);
     if (iRead == 0)
     {
       // Check for actual EOF and retry as long as we still have data in our cache
@@ -367,6 +420,10 @@ void CFileCache::Process()
 
       iTotalWrite += iWrite;
 
+      // the write joined data cached before, the rest of the chunk is part of it
+      if (m_pCache->CachedDataEndPos() != m_writePos + iTotalWrite)
+        break;
+
       // check if seek was asked. otherwise if cache is full we'll freeze.
       if (m_seekEvent.WaitMSec(0))
       {
@@ -378,6 +435,21 @@ void CFileCache::Process()
 
     m_writePos += iTotalWrite;
 
+    // the cache may already hold the data that follows, continue after it
+    const int64_t cachedEnd = m_pCache->CachedDataEndPos();
+    if (cachedEnd > m_writePos)
+    {
+      if (cachedEnd < m_fileSize && SeekSource(cachedEnd) != cachedEnd)
+      {
+        CLog::Log(LOGERROR, "CFileCache::Process - Error seeking source past cached data to %" PRId64, cachedEnd);
+        break;
+      }
+      cacheReachEOF = cachedEnd >= m_fileSize;
+      m_writePos = cachedEnd;
+      average.Reset(m_writePos, false);
+      limiter.Reset(m_writePos);
+    }
+
     // under estimate write rate by a second, to
     // avoid uncertainty at start of caching
     m_writeRateActual = average.Rate(m_writePos, 1000);
@@ -406,6 +478,22 @@ void CFileCache::Process()
   }
 }
 
+int64_t CFileCache::SeekSource(int64_t iFilePosition)
+{
+  if (m_parallelReader)
+    return m_parallelReader->Seek(iFilePosition);
+
+  return m_source.Seek(iFilePosition, SEEK_SET);
+}
+
+ssize_t CFileCache::ReadSource(void* lpBuf, size_t uiBufSize)
+{
+  if (m_parallelReader)
+    return m_parallelReader->Read(lpBuf, uiBufSize);
+
+  return m_source.Read(lpBuf, uiBufSize);
+}
+
 void CFileCache::OnExit()
 {
   m_bStop = true;
@@ -494,11 +582,14 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
   if (iTarget == m_readPos)
     return m_readPos;
 
+  m_seeks++;
   if ((m_nSeekResult = m_pCache->Seek(iTarget)) != iTarget)
   {
     if (m_seekPossible == 0)
       return m_nSeekResult;
 
+    m_seekCached = false;
+
     /* never request closer to end than 2k, speeds up tag reading */
     m_seekPos = std::min(iTarget, std::max((int64_t)0, m_fileSize - m_chunkSize));
 
@@ -520,11 +611,16 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
       }
       m_pCache->Seek(iTarget);
     }
+    else if (m_seekCached)
+      m_seekHits++;
     m_readPos = iTarget;
     m_seekEvent.Reset();
   }
   else
+  {
+    m_seekHits++;
     m_readPos = iTarget;
+  }
 
   return iTarget;
 }
@@ -533,10 +629,23 @@ void CFileCache::Close()
 {
   StopThread();
 
+  if (m_seeks > 0)
+  {
+    CLog::Log(LOGDEBUG, "CFileCache::Close - %u of %u seeks served from cache", m_seekHits, m_seeks);
+    m_seeks = 0;
+  }
+
   CSingleLock lock(m_sync);
   if (m_pCache)
+  {
     m_pCache->Close();
 
+    // bound to its source, the next Open() chooses again
+    if (dynamic_cast<CPersistentFileCache*>(m_pCache.get()))
+      m_pCache.reset();
+  }
+
+  m_parallelReader.reset();
   m_source.Close();
 }
 
@@ -555,6 +664,9 @@ void CFileCache::StopThread(bool bWait /*= true*/)
   m_bStop = true;
   //Process could be waiting for seekEvent
   m_seekEvent.Set();
+  //or for the next segment of parallel reads
+  if (m_parallelReader)
+    m_parallelReader->Close();
   CThread::StopThread(bWait);
 }
 
@@ -575,6 +687,8 @@ int CFileCache::IoControl(EIoControl request, void* param)
     status->maxrate = m_writeRate;
     status->currate = m_writeRateActual;
     status->lowspeed = m_bLowSpeedDetected;
+    status->seeks = m_seeks;
+    status->seekhits = m_seekHits;
     m_bLowSpeedDetected = false; // Reset flag
     return 0;
   }
@@ -19,6 +19,7 @@
 
 namespace XFILE
 {
+  class CParallelRangeReader;
 
   class CFileCache : public IFile, public CThread
   {
@@ -55,7 +56,11 @@ namespace XFILE
     }
 
   private:
+    int64_t SeekSource(int64_t iFilePosition);
+    ssize_t ReadSource(void* lpBuf, size_t uiBufSize);
+
     std::unique_ptr<CCacheStrategy> m_pCache;
+    std::unique_ptr<CParallelRangeReader> m_parallelReader;
     int m_seekPossible;
     CFile m_source;
     std::string m_sourcePath;
@@ -72,6 +77,9 @@ namespace XFILE
     int64_t m_forward;
     bool m_bFilling;
     bool m_bLowSpeedDetected;
+    bool m_seekCached; // last seek handled by Process() continued in cached data
+    unsigned m_seeks;
+    unsigned m_seekHits;
     std::atomic<int64_t> m_fileSize;
     unsigned int m_flags;
     CCriticalSection m_sync;
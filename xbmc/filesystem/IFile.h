@@ -19,6 +19,7 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <sys/stat.h>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -39,6 +40,22 @@ class CURL;
 namespace XFILE
 {
 
+/**
+ * \brief Read-only view of file data borrowed through IFile::Map()
+ *
+ * The data stays valid for the lifetime of the view, also after the file
+ * was closed. An I/O error or a truncation of the file while it is mapped
+ * raises SIGBUS on access, so only small files owned by Kodi are mapped,
+ * never media played from removable or failing disks.
+ */
+class IFileView
+{
+public:
+  virtual ~IFileView() = default;
+  virtual const uint8_t* GetData() const = 0;
+  virtual size_t GetSize() const = 0;
+};
+
 class IFile
 {
 public:
@@ -83,6 +100,24 @@ public:
    *         or undetectable error occur, -1 in case of any explicit error
    */
   virtual ssize_t Read(void* bufPtr, size_t bufSize) = 0;
+  /**
+   * Attempt to fill several buffers one after another with the data at position.
+   * Doesn't change the position of the file and may be called from other threads
+   * while the file is read. Only supported if CanReadAt() returns true.
+   * @param position offset in file of the data for the first buffer
+   * @param buffers  buffers to fill
+   * @param count    number of buffers
+   * @return number of bytes read into all buffers, less than their size at end of
+   *         file, -1 in case of any explicit error
+   */
+  virtual ssize_t ReadAt(int64_t position, const SReadBuffer* buffers, size_t count) { return -1; }
+  virtual bool CanReadAt() { return false; }
+  /**
+   * Map size bytes at position into memory without copying them.
+   * @return the view, nullptr if the file can't be mapped, callers then fall
+   *         back to Read()
+   */
+  virtual std::unique_ptr<IFileView> Map(int64_t position, size_t size) { return nullptr; }
   /**
    * Attempt to write bufSize bytes from buffer bufPtr into currently opened file.
    * @param bufPtr  pointer to buffer
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 namespace XFILE
@@ -52,6 +53,14 @@ struct SCacheStatus
   unsigned maxrate;  /**< maximum number of bytes per second cache is allowed to fill */
   unsigned currate;  /**< average read rate from source file since last position change */
   bool     lowspeed; /**< cache low speed condition detected? */
+  unsigned seeks;    /**< number of seeks since the file was opened */
+  unsigned seekhits; /**< number of seeks served from cached data */
+};
+
+struct SReadBuffer
+{
+  void*  data; /**< buffer to fill */
+  size_t size; /**< number of bytes to read into it */
 };
 
 typedef enum {
@@ -0,0 +1,228 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ParallelRangeReader.h"
+
+#include "File.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace XFILE;
+
+namespace
+{
+// segments a worker fetches in a row on its connection
+const unsigned int SPAN_SEGMENTS = 4;
+}
+
+class CParallelRangeReader::CWorker : public CThread
+{
+public:
+  explicit CWorker(CParallelRangeReader& reader) : CThread("RangeReader"), m_reader(reader) {}
+  ~CWorker() override
+  {
+    // the thread uses m_file until it ends
+    StopThread();
+  }
+
+protected:
+  void Process() override
+  {
+    m_reader.Work(m_file, m_bStop);
+    m_file.Close();
+  }
+
+private:
+  CParallelRangeReader& m_reader;
+  CFile m_file;
+};
+
+CParallelRangeReader::CParallelRangeReader(const std::string& path, unsigned int flags,
+                                           unsigned int connections, size_t segmentSize)
+  : m_path(path), m_flags(flags), m_connections(connections), m_segmentSize(segmentSize)
+{
+}
+
+CParallelRangeReader::~CParallelRangeReader()
+{
+  Close();
+}
+
+void CParallelRangeReader::Open(int64_t fileSize)
+{
+  Close();
+
+  {
+    CSingleLock lock(m_section);
+    m_fileSize = fileSize;
+    m_nextOffset = 0;
+    m_closing = false;
+  }
+
+  for (unsigned int i = 0; i < m_connections; i++)
+  {
+    m_workers.emplace_back(new CWorker(*this));
+    m_workers.back()->Create();
+  }
+}
+
+void CParallelRangeReader::Close()
+{
+  {
+    CSingleLock lock(m_section);
+    m_closing = true;
+    m_segmentFree.notifyAll();
+    m_segmentDone.notifyAll();
+  }
+
+  // a worker in the middle of a request finishes it first, all are signalled before
+  // joining them on destruction
+  for (auto& worker : m_workers)
+    worker->StopThread(false);
+  m_workers.clear();
+
+  CSingleLock lock(m_section);
+  m_segments.clear();
+}
+
+int64_t CParallelRangeReader::Seek(int64_t position)
+{
+  CSingleLock lock(m_section);
+  m_segments.clear();
+  m_nextOffset = position;
+  m_generation++;
+  m_segmentFree.notifyAll();
+
+  return position;
+}
+
+ssize_t CParallelRangeReader::Read(void* buffer, size_t size)
+{
+  CSingleLock lock(m_section);
+
+  while (!m_closing)
+  {
+    if (m_segments.empty())
+    {
+      if (m_nextOffset >= m_fileSize)
+        return 0;
+
+      m_segmentDone.wait(lock);
+      continue;
+    }
+
+    SSegment& segment = *m_segments.front();
+    if (!segment.done)
+    {
+      m_segmentDone.wait(lock);
+      continue;
+    }
+
+    if (segment.failed)
+      return -1;
+
+    const size_t read = std::min(size, segment.data.size() - segment.consumed);
+    memcpy(buffer, segment.data.data() + segment.consumed, read);
+    segment.consumed += read;
+    if (segment.consumed == segment.data.size())
+    {
+      m_segments.pop_front();
+      m_segmentFree.notifyAll();
+    }
+    return read;
+  }
+
+  return -1;
+}
+
+void CParallelRangeReader::Work(CFile& file, const std::atomic<bool>& stop)
+{
+  CSingleLock lock(m_section);
+
+  while (!stop && !m_closing)
+  {
+    // stay a span per connection ahead of the reader only
+    if (m_segments.size() + SPAN_SEGMENTS > m_connections * SPAN_SEGMENTS || m_nextOffset >= m_fileSize)
+    {
+      m_segmentFree.wait(lock);
+      continue;
+    }
+
+    const unsigned int generation = m_generation;
+    std::vector<std::shared_ptr<SSegment>> span;
+    for (unsigned int i = 0; i < SPAN_SEGMENTS && m_nextOffset < m_fileSize; i++)
+    {
+      std::shared_ptr<SSegment> segment = std::make_shared<SSegment>();
+      segment->offset = m_nextOffset;
+      segment->size = static_cast<size_t>(std::min<int64_t>(m_segmentSize, m_fileSize - m_nextOffset));
+      m_nextOffset += segment->size;
+      m_segments.push_back(segment);
+      span.push_back(segment);
+    }
+
+    for (const auto& segment : span)
+    {
+      // a seek dropped the rest of the span
+      if (stop || m_closing || generation != m_generation)
+        break;
+
+      bool result;
+      {
+        CSingleExit exit(m_section);
+        result = Fetch(file, *segment);
+      }
+
+      segment->done = true;
+      segment->failed = !result;
+      m_segmentDone.notifyAll();
+    }
+  }
+}
+
+bool CParallelRangeReader::Fetch(CFile& file, SSegment& segment)
+{
+  const size_t size = segment.size;
+  segment.data.resize(size);
+  size_t done = 0;
+
+  // one more connection if the current one breaks
+  for (int attempt = 0; attempt < 2 && done < size; attempt++)
+  {
+    if (attempt > 0)
+      file.Close();
+
+    const int64_t position = segment.offset + done;
+    if (!file.GetImplementation() && !file.Open(m_path, m_flags))
+    {
+      CLog::Log(LOGERROR, "CParallelRangeReader::Fetch - failed to open <%s>", CURL::GetRedacted(m_path).c_str());
+      continue;
+    }
+
+    // the segments of a span continue on the same request
+    if (file.GetPosition() != position && file.Seek(position, SEEK_SET) != position)
+    {
+      CLog::Log(LOGERROR, "CParallelRangeReader::Fetch - failed to seek to %" PRId64, position);
+      continue;
+    }
+
+    while (done < size)
+    {
+      const ssize_t read = file.Read(segment.data.data() + done, size - done);
+      if (read <= 0)
+        break;
+      done += read;
+    }
+  }
+
+  return done == size;
+}
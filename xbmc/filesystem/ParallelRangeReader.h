@@ -0,0 +1,102 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifdef TARGET_POSIX
+#include "PlatformDefs.h"
+#endif
+
+namespace XFILE
+{
+
+class CFile;
+
+/*!
+ * \brief Reads a file through several connections at once
+ *
+ * Worker threads claim spans of consecutive segments and fetch them
+ * concurrently, each span in order on the worker's own connection so a new
+ * request is only made per span. Segments may complete in any order, Read()
+ * returns them in file order. Meant for high latency links where a single
+ * connection can't use the available bandwidth.
+ */
+class CParallelRangeReader
+{
+public:
+  /*!
+   \param path file to read
+   \param flags open flags of the worker handles
+   \param connections number of concurrent segment reads
+   \param segmentSize bytes fetched per request
+   */
+  CParallelRangeReader(const std::string& path, unsigned int flags, unsigned int connections,
+                       size_t segmentSize);
+  ~CParallelRangeReader();
+
+  /*!
+   \brief start reading at position 0
+   \param fileSize size of the file, segments aren't requested beyond it
+   */
+  void Open(int64_t fileSize);
+  void Close();
+
+  /*!
+   \brief continue at position, segments fetched so far are dropped
+   */
+  int64_t Seek(int64_t position);
+
+  /*!
+   \brief read the next bytes, blocks until the next segment arrived
+   \return bytes read, 0 at end of file and -1 if a segment could not be read
+   */
+  ssize_t Read(void* buffer, size_t size);
+
+private:
+  class CWorker;
+
+  struct SSegment
+  {
+    int64_t offset = 0;
+    size_t size = 0;
+    std::vector<char> data;
+    size_t consumed = 0;
+    bool done = false;
+    bool failed = false;
+  };
+
+  void Work(CFile& file, const std::atomic<bool>& stop);
+  bool Fetch(CFile& file, SSegment& segment);
+
+  std::string m_path;
+  unsigned int m_flags;
+  unsigned int m_connections;
+  size_t m_segmentSize;
+  std::vector<std::unique_ptr<CWorker>> m_workers;
+
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_segmentDone;
+  XbmcThreads::ConditionVariable m_segmentFree;
+  std::deque<std::shared_ptr<SSegment>> m_segments; // in file order, workers keep a reference while fetching
+  int64_t m_fileSize = 0;
+  int64_t m_nextOffset = 0;
+  unsigned int m_generation = 0; // changes on seeks, spans claimed before are dropped
+  bool m_closing = false;
+};
+
+}
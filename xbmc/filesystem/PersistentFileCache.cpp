@@ -0,0 +1,565 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PersistentFileCache.h"
+
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "SpecialProtocol.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/auto_buffer.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#ifdef TARGET_POSIX
+#include "PlatformDefs.h"
+#include "platform/posix/ConvUtils.h"
+#endif
+#if defined(TARGET_POSIX)
+#include "platform/posix/filesystem/PosixFile.h"
+#define CacheLocalFile CPosixFile
+#elif defined(TARGET_WINDOWS)
+#include "platform/win32/filesystem/Win32File.h"
+#define CacheLocalFile CWin32File
+#endif // TARGET_WINDOWS
+
+#include <algorithm>
+#include <inttypes.h>
+#include <iterator>
+#include <set>
+#include <vector>
+
+using namespace XFILE;
+
+namespace
+{
+// what is kept of an entry that alone exceeds the budget: the head holding the
+// index of most containers, the tail for those that put it there and the data
+// around the position reading stopped at
+const int64_t KEEP_HEAD = 16 * 1024 * 1024;
+const int64_t KEEP_TAIL = 16 * 1024 * 1024;
+const int64_t KEEP_BEFORE_RESUME = 8 * 1024 * 1024;
+const int64_t KEEP_AFTER_RESUME = 32 * 1024 * 1024;
+
+// entries opened by a cache, each one is written by a single cache
+CCriticalSection entriesSection;
+std::set<std::string> entriesOpen;
+}
+
+CPersistentFileCache::CPersistentFileCache(const std::string& path, const std::string& url,
+                                           int64_t fileSize, int64_t modified, uint64_t budget)
+  : m_path(path)
+  , m_url(url)
+  , m_fileSize(fileSize)
+  , m_modified(modified)
+  , m_budget(budget)
+  , m_cacheFileRead(new CacheLocalFile())
+  , m_cacheFileWrite(new CacheLocalFile())
+{
+  URIUtils::AddSlashAtEnd(m_path);
+  m_name = StringUtils::Format("%08x_%" PRIx64, static_cast<uint32_t>(Crc32::Compute(url)),
+                               static_cast<uint64_t>(fileSize));
+}
+
+CPersistentFileCache::~CPersistentFileCache()
+{
+  Close();
+  delete m_cacheFileRead;
+  delete m_cacheFileWrite;
+}
+
+int CPersistentFileCache::Open()
+{
+  Close();
+
+  {
+    CSingleLock lock(entriesSection);
+    if (!entriesOpen.insert(m_name).second)
+    {
+      CLog::Log(LOGDEBUG, "CPersistentFileCache::Open - entry %s is in use", m_name.c_str());
+      return CACHE_RC_ERROR;
+    }
+  }
+  m_open = true;
+  m_ranges.clear();
+
+  if (!CDirectory::Exists(m_path) && !CDirectory::Create(m_path))
+  {
+    CLog::Log(LOGERROR, "CPersistentFileCache::Open - unable to create %s", m_path.c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  // the entry is only reused for the same version of the source
+  const std::string indexFile = m_path + m_name + ".idx";
+  SIndex index;
+  const bool valid = LoadIndex(indexFile, index) && index.url == m_url &&
+                     index.fileSize == m_fileSize && index.modified == m_modified;
+
+  CURL fileURL(CSpecialProtocol::TranslatePath(m_path + m_name + ".cache"));
+  if (!m_cacheFileWrite->OpenForWrite(fileURL, !valid))
+  {
+    CLog::LogF(LOGERROR, "failed to create file \"%s\" for writing", fileURL.Get().c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  if (!m_cacheFileRead->Open(fileURL))
+  {
+    CLog::LogF(LOGERROR, "failed to open file \"%s\" for reading", fileURL.Get().c_str());
+    Close();
+    return CACHE_RC_ERROR;
+  }
+
+  // written again on close, data without an index is removed by Trim()
+  CFile::Delete(indexFile);
+
+  CSingleLock lock(m_sync);
+  if (valid)
+  {
+    m_ranges = index.ranges;
+    CLog::Log(LOGDEBUG, "CPersistentFileCache::Open - %" PRId64 " bytes of <%s> cached",
+              GetBytes(m_ranges), CURL::GetRedacted(m_url).c_str());
+  }
+  m_readPos = 0;
+  m_writeStart = 0;
+  m_writePos = ContiguousEnd(0);
+  m_bEndOfInput = false;
+  m_dataAvail.Reset();
+
+  return CACHE_RC_OK;
+}
+
+void CPersistentFileCache::Close()
+{
+  if (!m_open)
+    return;
+
+  m_cacheFileWrite->Close();
+  m_cacheFileRead->Close();
+
+  if (GetCachedBytes() > static_cast<int64_t>(m_budget))
+    Shrink();
+
+  if (m_ranges.empty() || !SaveIndex())
+  {
+    CFile::Delete(m_path + m_name + ".idx");
+    CFile::Delete(m_path + m_name + ".cache");
+  }
+
+  // still open, the entry itself is kept
+  Trim(m_path, m_budget);
+
+  CSingleLock lock(entriesSection);
+  entriesOpen.erase(m_name);
+  m_open = false;
+}
+
+size_t CPersistentFileCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  return iRequestSize; // Can always write since it's on disk
+}
+
+int CPersistentFileCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  int64_t pos;
+  {
+    CSingleLock lock(m_sync);
+    pos = m_writePos;
+  }
+
+  if (m_cacheFileWrite->Seek(pos, SEEK_SET) != pos)
+  {
+    CLog::LogF(LOGERROR, "can't seek file");
+    return CACHE_RC_ERROR;
+  }
+
+  size_t written = 0;
+  while (written < iSize)
+  {
+    const size_t toWrite = std::min(iSize - written, static_cast<size_t>(SSIZE_MAX));
+    const ssize_t lastWritten = m_cacheFileWrite->Write(pBuffer + written, toWrite);
+    if (lastWritten <= 0)
+    {
+      CLog::LogF(LOGERROR, "failed to write to file");
+      return CACHE_RC_ERROR;
+    }
+    written += lastWritten;
+  }
+
+  CSingleLock lock(m_sync);
+  // joins the data cached behind it, CFileCache continues after that
+  auto range = AddRange(m_ranges, pos, pos + written);
+  m_writeStart = range->first;
+  m_writePos = range->second;
+  m_dataAvail.Set();
+
+  return written;
+}
+
+int CPersistentFileCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  int64_t pos;
+  int64_t available;
+  {
+    CSingleLock lock(m_sync);
+    pos = m_readPos;
+    available = m_writePos - m_readPos;
+  }
+
+  if (available <= 0)
+    return m_bEndOfInput ? 0 : CACHE_RC_WOULD_BLOCK;
+
+  if (m_cacheFileRead->Seek(pos, SEEK_SET) != pos)
+  {
+    CLog::LogF(LOGERROR, "can't seek file");
+    return CACHE_RC_ERROR;
+  }
+
+  size_t toRead = std::min(static_cast<int64_t>(iMaxSize), available);
+  size_t readBytes = 0;
+  while (toRead > 0)
+  {
+    const ssize_t lastRead = m_cacheFileRead->Read(pBuffer + readBytes, std::min(toRead, static_cast<size_t>(SSIZE_MAX)));
+    if (lastRead == 0)
+      break;
+    if (lastRead < 0)
+    {
+      CLog::LogF(LOGERROR, "failed to read from file");
+      return CACHE_RC_ERROR;
+    }
+    toRead -= lastRead;
+    readBytes += lastRead;
+  }
+
+  if (readBytes > 0)
+  {
+    CSingleLock lock(m_sync);
+    m_readPos += readBytes;
+    m_space.Set();
+  }
+
+  return readBytes;
+}
+
+int64_t CPersistentFileCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  XbmcThreads::EndTime endTime(iMillis);
+  while (true)
+  {
+    int64_t available;
+    {
+      CSingleLock lock(m_sync);
+      available = m_writePos - m_readPos;
+    }
+
+    if (iMillis == 0 || IsEndOfInput() || available >= iMinAvail)
+      return available;
+
+    if (!m_dataAvail.WaitMSec(endTime.MillisLeft()))
+      return CACHE_RC_TIMEOUT;
+  }
+}
+
+int64_t CPersistentFileCache::Seek(int64_t iFilePosition)
+{
+  int64_t ahead;
+  int64_t needed;
+  {
+    CSingleLock lock(m_sync);
+    if (iFilePosition < m_writeStart)
+      return CACHE_RC_ERROR;
+
+    ahead = iFilePosition - m_writePos;
+    needed = iFilePosition - m_readPos;
+  }
+
+  // a short way ahead of the cached data is cheaper to wait for than to seek the source
+  if (ahead > 500000 || (ahead > 0 && WaitForData(static_cast<unsigned int>(needed), 5000) < needed))
+  {
+    CLog::Log(LOGDEBUG, "CPersistentFileCache::Seek - Attempt to seek past cached data");
+    return CACHE_RC_ERROR;
+  }
+
+  CSingleLock lock(m_sync);
+  m_readPos = iFilePosition;
+  m_space.Set();
+
+  return iFilePosition;
+}
+
+bool CPersistentFileCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  CSingleLock lock(m_sync);
+
+  auto range = clearAnyway ? m_ranges.end() : FindRange(iSourcePosition);
+  m_readPos = iSourcePosition;
+  if (range != m_ranges.end())
+  {
+    m_writeStart = range->first;
+    m_writePos = range->second;
+  }
+  else
+  {
+    m_writeStart = iSourcePosition;
+    m_writePos = iSourcePosition;
+  }
+
+  return m_writePos == iSourcePosition;
+}
+
+void CPersistentFileCache::EndOfInput()
+{
+  CCacheStrategy::EndOfInput();
+  m_dataAvail.Set();
+}
+
+int64_t CPersistentFileCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return ContiguousEnd(iFilePosition);
+}
+
+int64_t CPersistentFileCache::CachedDataEndPos()
+{
+  CSingleLock lock(m_sync);
+  return m_writePos;
+}
+
+bool CPersistentFileCache::IsCachedPosition(int64_t iFilePosition)
+{
+  CSingleLock lock(m_sync);
+  return (iFilePosition >= m_writeStart && iFilePosition <= m_writePos) ||
+         FindRange(iFilePosition) != m_ranges.end();
+}
+
+CCacheStrategy *CPersistentFileCache::CreateNew()
+{
+  // fails to open while this one is open, an entry has a single writer
+  return new CPersistentFileCache(m_path, m_url, m_fileSize, m_modified, m_budget);
+}
+
+int64_t CPersistentFileCache::GetCachedBytes()
+{
+  CSingleLock lock(m_sync);
+  return GetBytes(m_ranges);
+}
+
+void CPersistentFileCache::Trim(const std::string& path, uint64_t budget)
+{
+  CFileItemList items;
+  if (!CDirectory::GetDirectory(path, items, "", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE))
+    return;
+
+  struct SEntry
+  {
+    std::string name;
+    CDateTime used;
+    int64_t bytes;
+  };
+  std::vector<SEntry> entries;
+  std::set<std::string> indexed;
+  uint64_t total = 0;
+
+  for (const auto& item : items)
+  {
+    if (item->m_bIsFolder || URIUtils::GetExtension(item->GetPath()) != ".idx")
+      continue;
+
+    std::string name = URIUtils::GetFileName(item->GetPath());
+    URIUtils::RemoveExtension(name);
+    SIndex index;
+    const int64_t bytes = LoadIndex(item->GetPath(), index) ? GetBytes(index.ranges) : 0;
+    entries.push_back({name, item->m_dateTime, bytes});
+    indexed.insert(name);
+    total += bytes;
+  }
+
+  CSingleLock lock(entriesSection);
+
+  // data without an index was left by a crash or an interrupted Shrink()
+  for (const auto& item : items)
+  {
+    std::string name = URIUtils::GetFileName(item->GetPath());
+    URIUtils::RemoveExtension(name);
+    if (!item->m_bIsFolder && URIUtils::GetExtension(item->GetPath()) != ".idx" &&
+        indexed.find(name) == indexed.end() && entriesOpen.find(name) == entriesOpen.end())
+      CFile::Delete(item->GetPath());
+  }
+
+  // index files are written on close, their date is the last use
+  std::sort(entries.begin(), entries.end(),
+            [](const SEntry& a, const SEntry& b) { return a.used < b.used; });
+
+  for (const auto& entry : entries)
+  {
+    if (total <= budget)
+      break;
+    if (entriesOpen.find(entry.name) != entriesOpen.end())
+      continue;
+
+    CLog::Log(LOGDEBUG, "CPersistentFileCache::Trim - evicting %s, %" PRId64 " bytes",
+              entry.name.c_str(), entry.bytes);
+    CFile::Delete(URIUtils::AddFileToFolder(path, entry.name + ".idx"));
+    CFile::Delete(URIUtils::AddFileToFolder(path, entry.name + ".cache"));
+    total -= entry.bytes;
+  }
+}
+
+bool CPersistentFileCache::LoadIndex(const std::string& filename, SIndex& index)
+{
+  CFile file;
+  auto_buffer buffer;
+  if (file.LoadFile(filename, buffer) <= 0)
+    return false;
+
+  // url, size and modification time, then one line per range
+  std::vector<std::string> lines = StringUtils::Split(std::string(buffer.get(), buffer.size()), '\n');
+  if (lines.size() < 2)
+    return false;
+
+  index.url = lines[0];
+  if (sscanf(lines[1].c_str(), "%" SCNd64 " %" SCNd64, &index.fileSize, &index.modified) != 2)
+    return false;
+
+  for (size_t i = 2; i < lines.size(); i++)
+  {
+    if (lines[i].empty())
+      continue;
+
+    int64_t start;
+    int64_t end;
+    if (sscanf(lines[i].c_str(), "%" SCNd64 " %" SCNd64, &start, &end) != 2 || start < 0 ||
+        start >= end || end > index.fileSize)
+      return false;
+    AddRange(index.ranges, start, end);
+  }
+
+  return true;
+}
+
+bool CPersistentFileCache::SaveIndex()
+{
+  std::string data = m_url + "\n";
+  data += StringUtils::Format("%" PRId64 " %" PRId64 "\n", m_fileSize, m_modified);
+  for (const auto& range : m_ranges)
+    data += StringUtils::Format("%" PRId64 " %" PRId64 "\n", range.first, range.second);
+
+  CFile file;
+  if (!file.OpenForWrite(m_path + m_name + ".idx", true) ||
+      file.Write(data.c_str(), data.size()) != static_cast<ssize_t>(data.size()))
+  {
+    CLog::LogF(LOGERROR, "failed to write index of %s", m_name.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+void CPersistentFileCache::Shrink()
+{
+  const std::pair<int64_t, int64_t> windows[] = {
+      {0, KEEP_HEAD},
+      {m_fileSize - KEEP_TAIL, m_fileSize},
+      {m_readPos - KEEP_BEFORE_RESUME, m_readPos + KEEP_AFTER_RESUME}};
+
+  RangeMap kept;
+  for (const auto& range : m_ranges)
+  {
+    for (const auto& window : windows)
+    {
+      const int64_t start = std::max(range.first, window.first);
+      const int64_t end = std::min(range.second, window.second);
+      if (start < end)
+        AddRange(kept, start, end);
+    }
+  }
+
+  if (GetBytes(kept) == GetBytes(m_ranges))
+    return;
+
+  CLog::Log(LOGDEBUG, "CPersistentFileCache::Shrink - %s from %" PRId64 " to %" PRId64 " bytes",
+            m_name.c_str(), GetBytes(m_ranges), GetBytes(kept));
+
+  // the data file is sparse, copying what is kept is the portable way to free the rest
+  const CURL fileURL(CSpecialProtocol::TranslatePath(m_path + m_name + ".cache"));
+  const CURL shrunkURL(CSpecialProtocol::TranslatePath(m_path + m_name + ".tmp"));
+  CacheLocalFile in;
+  CacheLocalFile out;
+  bool result = in.Open(fileURL) && out.OpenForWrite(shrunkURL, true);
+
+  std::vector<char> buffer(1024 * 1024);
+  for (auto range = kept.begin(); result && range != kept.end(); ++range)
+  {
+    result = in.Seek(range->first, SEEK_SET) == range->first &&
+             out.Seek(range->first, SEEK_SET) == range->first;
+    for (int64_t pos = range->first; result && pos < range->second;)
+    {
+      const size_t size = static_cast<size_t>(std::min<int64_t>(buffer.size(), range->second - pos));
+      const ssize_t read = in.Read(buffer.data(), size);
+      result = read > 0 && out.Write(buffer.data(), read) == read;
+      pos += read;
+    }
+  }
+  in.Close();
+  out.Close();
+
+  if (result && in.Delete(fileURL) && out.Rename(shrunkURL, fileURL))
+    m_ranges = kept;
+  else
+  {
+    CLog::LogF(LOGERROR, "failed to shrink %s", m_name.c_str());
+    out.Delete(shrunkURL);
+    m_ranges.clear();
+  }
+}
+
+CPersistentFileCache::RangeMap::const_iterator CPersistentFileCache::FindRange(int64_t iFilePosition) const
+{
+  // the end of a range counts as cached like with the other strategies
+  auto range = m_ranges.upper_bound(iFilePosition);
+  if (range == m_ranges.begin())
+    return m_ranges.end();
+
+  --range;
+  return range->second >= iFilePosition ? range : m_ranges.end();
+}
+
+int64_t CPersistentFileCache::ContiguousEnd(int64_t iFilePosition) const
+{
+  auto range = FindRange(iFilePosition);
+  return range != m_ranges.end() ? range->second : iFilePosition;
+}
+
+CPersistentFileCache::RangeMap::iterator CPersistentFileCache::AddRange(RangeMap& ranges, int64_t start, int64_t end)
+{
+  // merge with all ranges overlapping or touching [start, end)
+  auto range = ranges.upper_bound(start);
+  if (range != ranges.begin() && std::prev(range)->second >= start)
+    --range;
+
+  while (range != ranges.end() && range->first <= end)
+  {
+    start = std::min(start, range->first);
+    end = std::max(end, range->second);
+    range = ranges.erase(range);
+  }
+  return ranges.emplace(start, end).first;
+}
+
+int64_t CPersistentFileCache::GetBytes(const RangeMap& ranges)
+{
+  int64_t bytes = 0;
+  for (const auto& range : ranges)
+    bytes += range.second - range.first;
+  return bytes;
+}
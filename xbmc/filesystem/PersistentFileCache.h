@@ -0,0 +1,110 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <map>
+#include <string>
+
+namespace XFILE {
+
+/*!
+ * \brief Disk cache of a network file that is kept after Close()
+ *
+ * Data is stored at its offset in a sparse file per source, keyed by URL,
+ * size and modification time. An index records the ranges present, a later
+ * Open() of the same file serves them without touching the source and
+ * CFileCache only fetches the gaps. Once the cache directory exceeds its
+ * budget the least recently used entries are evicted.
+ */
+class CPersistentFileCache : public CCacheStrategy
+{
+public:
+  /*!
+   \param path directory of the cache entries
+   \param url source the entry belongs to
+   \param fileSize size of the source
+   \param modified modification time of the source, 0 if unknown
+   \param budget bytes all entries together may use
+   */
+  CPersistentFileCache(const std::string& path, const std::string& url, int64_t fileSize,
+                       int64_t modified, uint64_t budget);
+  ~CPersistentFileCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *pBuffer, size_t iSize) override;
+  int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
+  int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+
+  int64_t Seek(int64_t iFilePosition) override;
+  bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
+  void EndOfInput() override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy *CreateNew() override;
+
+  /*!
+   \brief bytes of the source held by this entry
+   */
+  int64_t GetCachedBytes();
+
+  /*!
+   \brief evict least recently used entries until all of them fit into budget
+   Entries that are open are kept.
+   */
+  static void Trim(const std::string& path, uint64_t budget);
+
+private:
+  typedef std::map<int64_t, int64_t> RangeMap; // start -> end of cached data
+
+  struct SIndex
+  {
+    std::string url;
+    int64_t fileSize = 0;
+    int64_t modified = 0;
+    RangeMap ranges;
+  };
+
+  static bool LoadIndex(const std::string& filename, SIndex& index);
+  bool SaveIndex();
+  void Shrink();
+  RangeMap::const_iterator FindRange(int64_t iFilePosition) const;
+  int64_t ContiguousEnd(int64_t iFilePosition) const;
+  static RangeMap::iterator AddRange(RangeMap& ranges, int64_t start, int64_t end);
+  static int64_t GetBytes(const RangeMap& ranges);
+
+  std::string m_path;
+  std::string m_name;
+  std::string m_url;
+  int64_t m_fileSize;
+  int64_t m_modified;
+  uint64_t m_budget;
+
+  IFile* m_cacheFileRead;
+  IFile* m_cacheFileWrite;
+  bool m_open = false;
+  CEvent m_dataAvail;
+
+  CCriticalSection m_sync;
+  RangeMap m_ranges;
+  int64_t m_writeStart = 0; // start of the range being written
+  int64_t m_writePos = 0;
+  int64_t m_readPos = 0;
+};
+
+}
@@ -11,6 +11,7 @@
 #include "URL.h"
 #include "guilib/XBTF.h"
 #include "guilib/XBTFReader.h"
+#include "threads/SingleLock.h"
 
 #include <utility>
 
@@ -29,11 +30,13 @@ CXbtManager& CXbtManager::GetInstance()
 
 bool CXbtManager::HasFiles(const CURL& path) const
 {
+  CSingleLock lock(m_critSection);
   return ProcessFile(path) != m_readers.end();
 }
 
 bool CXbtManager::GetFiles(const CURL& path, std::vector<CXBTFFile>& files) const
 {
+  CSingleLock lock(m_critSection);
   const auto& reader = ProcessFile(path);
   if (reader == m_readers.end())
     return false;
@@ -44,6 +47,7 @@ bool CXbtManager::GetFiles(const CURL& path, std::vector<CXBTFFile>& files) cons
 
 bool CXbtManager::GetReader(const CURL& path, CXBTFReaderPtr& reader) const
 {
+  CSingleLock lock(m_critSection);
   const auto& it = ProcessFile(path);
   if (it == m_readers.end())
     return false;
@@ -54,6 +58,7 @@ bool CXbtManager::GetReader(const CURL& path, CXBTFReaderPtr& reader) const
 
 void CXbtManager::Release(const CURL& path)
 {
+  CSingleLock lock(m_critSection);
   const auto& it = GetReader(path);
   if (it == m_readers.end())
     return;
@@ -13,6 +13,8 @@
 #include "utils/auto_buffer.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
 #include <sys/stat.h>
 
 #define ZIP_CACHE_LIMIT 4*1024*1024
@@ -72,6 +74,10 @@ bool CZipFile::Open(const CURL&url)
     CLog::Log(LOGERROR,"FileZip: unable to open zip file %s!",url.GetHostName().c_str());
     return false;
   }
+  // Kodi's own zip files are inflated straight from memory instead of reading
+  // 64k at a time, those of the user may be on a disk that fails
+  if (mZipItem.csize > 0 && CFile::CanMap(url.GetHostName()))
+    m_view = mFile.Map(mZipItem.offset, mZipItem.csize);
   mFile.Seek(mZipItem.offset,SEEK_SET);
   return InitDecompress();
 }
@@ -101,6 +107,33 @@ bool CZipFile::InitDecompress()
   return true;
 }
 
+void CZipFile::RestartDecompress()
+{
+  m_iFilePos = 0;
+  m_iZipFilePos = 0;
+  m_bFlush = false;
+  inflateEnd(&m_ZStream);
+  inflateInit2(&m_ZStream,-MAX_WBITS); // simply restart zlib
+  mFile.Seek(mZipItem.offset,SEEK_SET);
+  m_ZStream.next_in = (Bytef*)m_szBuffer;
+  m_ZStream.avail_in = 0;
+  m_ZStream.total_out = 0;
+}
+
+bool CZipFile::Unpack()
+{
+  // seeking back means inflating from the start again. Small entries, like
+  // the images of a skin or a comic, are inflated once and kept instead.
+  std::vector<char> unpacked(mZipItem.usize);
+  RestartDecompress();
+  if (Read(unpacked.data(), unpacked.size()) != static_cast<ssize_t>(unpacked.size()))
+    return false;
+
+  m_unpacked.swap(unpacked);
+  m_bUnpacked = true;
+  return true;
+}
+
 int64_t CZipFile::GetLength()
 {
   return mZipItem.usize;
@@ -118,41 +151,33 @@ int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
 {
   if (m_bCached)
     return mFile.Seek(iFilePosition,iWhence);
-  if (mZipItem.method == 0) // this is easy
+  if (m_bUnpacked || mZipItem.method == 0) // this is easy
   {
-    int64_t iResult;
+    int64_t iPosition;
     switch (iWhence)
     {
     case SEEK_SET:
-      if (iFilePosition > mZipItem.usize)
-        return -1;
-      m_iFilePos = iFilePosition;
-      m_iZipFilePos = m_iFilePos;
-      iResult = mFile.Seek(iFilePosition+mZipItem.offset,SEEK_SET)-mZipItem.offset;
-      return iResult;
+      iPosition = iFilePosition;
       break;
-
     case SEEK_CUR:
-      if (m_iFilePos+iFilePosition > mZipItem.usize)
-        return -1;
-      m_iFilePos += iFilePosition;
-      m_iZipFilePos = m_iFilePos;
-      iResult = mFile.Seek(iFilePosition,SEEK_CUR)-mZipItem.offset;
-      return iResult;
+      iPosition = m_iFilePos + iFilePosition;
       break;
-
     case SEEK_END:
-      if (iFilePosition > mZipItem.usize)
-        return -1;
-      m_iFilePos = mZipItem.usize+iFilePosition;
-      m_iZipFilePos = m_iFilePos;
-      iResult = mFile.Seek(mZipItem.offset+mZipItem.usize+iFilePosition,SEEK_SET)-mZipItem.offset;
-      return iResult;
+      iPosition = mZipItem.usize + iFilePosition;
       break;
     default:
       return -1;
-
     }
+    if (iPosition < 0 || iPosition > mZipItem.usize)
+      return -1;
+    m_iFilePos = iPosition;
+    if (m_bUnpacked)
+      return m_iFilePos;
+
+    m_iZipFilePos = m_iFilePos;
+    if (m_view) // read from memory, the file isn't moved
+      return m_iFilePos;
+    return mFile.Seek(mZipItem.offset + m_iFilePos, SEEK_SET) - mZipItem.offset;
   }
   // here goes the stupid part..
   if (mZipItem.method == 8)
@@ -171,14 +196,12 @@ int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
       // we are in uncompressed data..
       if (iFilePosition < m_iFilePos)
       {
-        m_iFilePos = 0;
-        m_iZipFilePos = 0;
-        inflateEnd(&m_ZStream);
-        inflateInit2(&m_ZStream,-MAX_WBITS); // simply restart zlib
-        mFile.Seek(mZipItem.offset,SEEK_SET);
-        m_ZStream.next_in = (Bytef*)m_szBuffer;
-        m_ZStream.avail_in = 0;
-        m_ZStream.total_out = 0;
+        if (mZipItem.usize <= ZIP_CACHE_LIMIT && Unpack())
+        {
+          m_iFilePos = iFilePosition;
+          return m_iFilePos;
+        }
+        RestartDecompress();
         while (m_iFilePos < iFilePosition)
         {
           ssize_t iToRead = (iFilePosition - m_iFilePos) > blockSize ? blockSize : iFilePosition - m_iFilePos;
@@ -282,6 +305,14 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
   if (m_bCached)
     return mFile.Read(lpBuf,uiBufSize);
 
+  if (m_bUnpacked)
+  {
+    size_t iMax = std::min(uiBufSize, static_cast<size_t>(mZipItem.usize - m_iFilePos));
+    memcpy(lpBuf, m_unpacked.data() + m_iFilePos, iMax);
+    m_iFilePos += iMax;
+    return iMax;
+  }
+
   // flush what might be left in the string buffer
   if (m_iDataInStringBuffer > 0)
   {
@@ -340,7 +371,14 @@ ssize_t CZipFile::Read(void* lpBuf, size_t uiBufSize)
     if (uiBufSize == 0)
       return 0; // we are past eof, this shouldn't happen but test anyway
 
-    ssize_t iResult = mFile.Read(lpBuf,uiBufSize);
+    ssize_t iResult;
+    if (m_view)
+    {
+      memcpy(lpBuf, m_view->GetData() + m_iFilePos, uiBufSize);
+      iResult = uiBufSize;
+    }
+    else
+      iResult = mFile.Read(lpBuf,uiBufSize);
     if (iResult < 0)
       return -1;
     m_iZipFilePos += iResult;
@@ -356,11 +394,26 @@ void CZipFile::Close()
   if (mZipItem.method == 8 && !m_bCached && m_iRead != -1)
     inflateEnd(&m_ZStream);
 
+  m_view.reset();
+  m_unpacked.clear();
+  m_bUnpacked = false;
   mFile.Close();
 }
 
 bool CZipFile::FillBuffer()
 {
+  if (m_view)
+  {
+    // all that is left at once, it's in memory already
+    if (m_iZipFilePos >= mZipItem.csize)
+      return false; // eof!
+
+    m_ZStream.avail_in = static_cast<unsigned int>(mZipItem.csize - m_iZipFilePos);
+    m_ZStream.next_in = const_cast<Bytef*>(m_view->GetData()) + m_iZipFilePos;
+    m_iZipFilePos = mZipItem.csize;
+    return true;
+  }
+
   ssize_t sToRead = 65535;
   if (m_iZipFilePos+65535 > mZipItem.csize)
     sToRead = mZipItem.csize-m_iZipFilePos;
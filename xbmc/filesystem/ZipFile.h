@@ -12,6 +12,9 @@
 #include "IFile.h"
 #include "ZipManager.h"
 
+#include <memory>
+#include <vector>
+
 #include <zlib.h>
 
 namespace XFILE
@@ -41,10 +44,15 @@ namespace XFILE
 
   private:
     bool InitDecompress();
+    void RestartDecompress();
     bool FillBuffer();
+    bool Unpack();
     void DestroyBuffer(void* lpBuffer, int iBufSize);
     CFile mFile;
     SZipEntry mZipItem;
+    std::unique_ptr<IFileView> m_view; // compressed data of the entry, if the zip file could be mapped
+    std::vector<char> m_unpacked; // whole uncompressed entry, once it was sought backwards
+    bool m_bUnpacked = false;
     int64_t m_iFilePos = 0; // position in _uncompressed_ data read
     int64_t m_iZipFilePos = 0; // position in _compressed_ data
     int m_iAvailBuffer = 0;
@@ -0,0 +1,206 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/*!
+ * Serves a generated file over HTTP with range support like a remote server
+ * behind a slow link: every request is answered after a delay and each
+ * connection is limited to a fixed rate.
+ */
+class CHttpTestServer
+{
+public:
+  static char PatternByte(int64_t pos) { return static_cast<char>((pos * 7) >> 3); }
+
+  CHttpTestServer(int64_t size, unsigned int latencyMs, unsigned int bytesPerSecond)
+    : m_size(size), m_latency(latencyMs), m_rate(bytesPerSecond)
+  {
+  }
+
+  ~CHttpTestServer() { Stop(); }
+
+  bool Start()
+  {
+    m_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_socket < 0)
+      return false;
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(addr);
+    if (bind(m_socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(m_socket, 16) < 0 ||
+        getsockname(m_socket, reinterpret_cast<sockaddr*>(&addr), &length) < 0)
+      return false;
+
+    m_port = ntohs(addr.sin_port);
+    m_accept = std::thread([this]() { Accept(); });
+    return true;
+  }
+
+  void Stop()
+  {
+    m_stop = true;
+    if (m_socket >= 0)
+    {
+      shutdown(m_socket, SHUT_RDWR);
+      close(m_socket);
+      m_socket = -1;
+    }
+    if (m_accept.joinable())
+      m_accept.join();
+
+    std::vector<std::thread> connections;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      for (int client : m_clients)
+        shutdown(client, SHUT_RDWR);
+      connections.swap(m_connections);
+    }
+    for (auto& connection : connections)
+      connection.join();
+  }
+
+  std::string GetUrl() const
+  {
+    return StringUtils::Format("http://127.0.0.1:%u/stream.bin", m_port);
+  }
+
+  unsigned int GetRequests() const { return m_requests; }
+  unsigned int GetConnections() const { return m_accepted; }
+
+private:
+  void Accept()
+  {
+    while (!m_stop)
+    {
+      int client = accept(m_socket, nullptr, nullptr);
+      if (client < 0)
+        break;
+      m_accepted++;
+
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_clients.push_back(client);
+      m_connections.emplace_back([this, client]() {
+        Serve(client);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_clients.erase(std::find(m_clients.begin(), m_clients.end(), client));
+        close(client);
+      });
+    }
+  }
+
+  void Serve(int client)
+  {
+    std::string request;
+    char buffer[4096];
+    while (!m_stop)
+    {
+      size_t end;
+      while ((end = request.find("\r\n\r\n")) == std::string::npos)
+      {
+        ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+          return;
+        request.append(buffer, received);
+      }
+      std::string header = request.substr(0, end);
+      request.erase(0, end + 4);
+      m_requests++;
+
+      // open ended ranges only, that is what CCurlFile asks for
+      int64_t start = 0;
+      StringUtils::ToLower(header);
+      const size_t range = header.find("range: bytes=");
+      const bool partial = range != std::string::npos;
+      if (partial)
+        start = std::min<int64_t>(std::stoll(header.substr(range + 13)), m_size);
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(m_latency));
+
+      std::string response;
+      if (partial)
+        response = StringUtils::Format("HTTP/1.1 206 Partial Content\r\n"
+                                       "Content-Range: bytes %lld-%lld/%lld\r\n",
+                                       static_cast<long long>(start), static_cast<long long>(m_size - 1),
+                                       static_cast<long long>(m_size));
+      else
+        response = "HTTP/1.1 200 OK\r\n";
+      response += StringUtils::Format("Accept-Ranges: bytes\r\n"
+                                      "Content-Length: %lld\r\n"
+                                      "Content-Type: application/octet-stream\r\n\r\n",
+                                      static_cast<long long>(m_size - start));
+      if (!Send(client, response.data(), response.size()))
+        return;
+
+      if (StringUtils::StartsWith(header, "head"))
+        continue;
+
+      // the rate of a single connection is what a high latency link allows
+      const auto begin = std::chrono::steady_clock::now();
+      int64_t sent = 0;
+      for (int64_t pos = start; pos < m_size && !m_stop;)
+      {
+        const size_t size = static_cast<size_t>(std::min<int64_t>(sizeof(buffer), m_size - pos));
+        for (size_t i = 0; i < size; i++)
+          buffer[i] = PatternByte(pos + i);
+        if (!Send(client, buffer, size))
+          return;
+        pos += size;
+        sent += size;
+
+        const auto due = begin + std::chrono::microseconds(sent * 1000000 / m_rate);
+        std::this_thread::sleep_until(due);
+      }
+    }
+  }
+
+  bool Send(int client, const char* data, size_t size)
+  {
+    while (size > 0)
+    {
+      ssize_t result = send(client, data, size, MSG_NOSIGNAL);
+      if (result <= 0)
+        return false;
+      data += result;
+      size -= result;
+    }
+    return true;
+  }
+
+  int64_t m_size;
+  unsigned int m_latency;
+  int64_t m_rate;
+  int m_socket = -1;
+  uint16_t m_port = 0;
+  std::atomic<bool> m_stop{false};
+  std::atomic<unsigned int> m_requests{0};
+  std::atomic<unsigned int> m_accepted{0};
+  std::thread m_accept;
+  std::mutex m_mutex;
+  std::vector<int> m_clients;
+  std::vector<std::thread> m_connections;
+};
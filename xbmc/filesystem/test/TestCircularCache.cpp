@@ -0,0 +1,127 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/CircularCache.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+// 32 blocks of 2 KiB, a quarter of them backbuffer
+const size_t FRONT_SIZE = 48 * 1024;
+const size_t BACK_SIZE = 16 * 1024;
+const size_t BLOCK_SIZE = 2048;
+
+char PatternByte(int64_t pos)
+{
+  return static_cast<char>((pos * 7) >> 3);
+}
+
+class TestCircularCache : public testing::Test
+{
+protected:
+  TestCircularCache() : m_cache(FRONT_SIZE, BACK_SIZE) {}
+
+  void SetUp() override { ASSERT_EQ(CACHE_RC_OK, m_cache.Open()); }
+
+  // writes like CFileCache after a seek and reads along like the demuxer
+  void Stream(int64_t pos, size_t size)
+  {
+    m_cache.Reset(pos, false);
+
+    std::vector<char> data(BLOCK_SIZE);
+    for (size_t done = 0; done < size; done += BLOCK_SIZE)
+    {
+      for (size_t i = 0; i < BLOCK_SIZE; i++)
+        data[i] = PatternByte(pos + done + i);
+      ASSERT_EQ(static_cast<int>(BLOCK_SIZE), m_cache.WriteToCache(data.data(), BLOCK_SIZE));
+      ASSERT_EQ(static_cast<int>(BLOCK_SIZE), m_cache.ReadFromCache(data.data(), BLOCK_SIZE));
+    }
+  }
+
+  void ExpectRead(int64_t pos, size_t size)
+  {
+    std::vector<char> data(size);
+    size_t done = 0;
+    while (done < size)
+    {
+      int result = m_cache.ReadFromCache(data.data() + done, size - done);
+      ASSERT_GT(result, 0);
+      done += result;
+    }
+
+    for (size_t i = 0; i < size; i++)
+      ASSERT_EQ(PatternByte(pos + i), data[i]) << "at " << pos + i;
+  }
+
+  CCircularCache m_cache;
+};
+} // namespace
+
+TEST_F(TestCircularCache, BackBuffer)
+{
+  Stream(0, 40 * BLOCK_SIZE);
+
+  // the backbuffer is kept while the front buffer fills
+  EXPECT_EQ(static_cast<int64_t>(30 * BLOCK_SIZE), m_cache.Seek(30 * BLOCK_SIZE));
+  ExpectRead(30 * BLOCK_SIZE, 10 * BLOCK_SIZE);
+  EXPECT_FALSE(m_cache.IsCachedPosition(BLOCK_SIZE));
+}
+
+TEST_F(TestCircularCache, KeepRegionAfterSeek)
+{
+  Stream(0, 8 * BLOCK_SIZE);
+  Stream(50 * BLOCK_SIZE, 4 * BLOCK_SIZE);
+
+  // the region left is still cached but has to be continued through Reset()
+  EXPECT_TRUE(m_cache.IsCachedPosition(1000));
+  EXPECT_EQ(static_cast<int64_t>(8 * BLOCK_SIZE), m_cache.CachedDataEndPosIfSeekTo(1000));
+  EXPECT_EQ(CACHE_RC_ERROR, m_cache.Seek(1000));
+
+  EXPECT_FALSE(m_cache.Reset(1000, false));
+  EXPECT_EQ(static_cast<int64_t>(8 * BLOCK_SIZE), m_cache.CachedDataEndPos());
+  ExpectRead(1000, 8 * BLOCK_SIZE - 1000);
+
+  // and so is the one seeked away from
+  EXPECT_EQ(static_cast<int64_t>(54 * BLOCK_SIZE), m_cache.CachedDataEndPosIfSeekTo(51 * BLOCK_SIZE));
+}
+
+TEST_F(TestCircularCache, JoinRegions)
+{
+  Stream(4 * BLOCK_SIZE, 4 * BLOCK_SIZE);
+  EXPECT_TRUE(m_cache.Reset(0, false));
+
+  // writing up to the region cached before continues at its end
+  Stream(0, 3 * BLOCK_SIZE);
+  EXPECT_EQ(static_cast<int64_t>(3 * BLOCK_SIZE), m_cache.CachedDataEndPos());
+  Stream(3 * BLOCK_SIZE, BLOCK_SIZE);
+  EXPECT_EQ(static_cast<int64_t>(8 * BLOCK_SIZE), m_cache.CachedDataEndPos());
+  ExpectRead(4 * BLOCK_SIZE, 4 * BLOCK_SIZE);
+}
+
+TEST_F(TestCircularCache, EvictLeastRecentlyUsed)
+{
+  Stream(0, 4 * BLOCK_SIZE);
+  Stream(50 * BLOCK_SIZE, 4 * BLOCK_SIZE);
+
+  // 24 free blocks, the next 4 are taken from the region read first
+  Stream(100 * BLOCK_SIZE, 28 * BLOCK_SIZE);
+  EXPECT_FALSE(m_cache.IsCachedPosition(BLOCK_SIZE));
+  EXPECT_EQ(static_cast<int64_t>(54 * BLOCK_SIZE), m_cache.CachedDataEndPosIfSeekTo(50 * BLOCK_SIZE));
+
+  // then from the one read next and the backbuffer beyond its guaranteed size
+  Stream(128 * BLOCK_SIZE, 8 * BLOCK_SIZE);
+  EXPECT_FALSE(m_cache.IsCachedPosition(50 * BLOCK_SIZE));
+  EXPECT_FALSE(m_cache.IsCachedPosition(100 * BLOCK_SIZE));
+  EXPECT_EQ(static_cast<int64_t>(136 * BLOCK_SIZE - BACK_SIZE),
+            m_cache.Seek(136 * BLOCK_SIZE - BACK_SIZE));
+}
@@ -0,0 +1,45 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "HttpTestServer.h"
+#include "URL.h"
+#include "filesystem/CurlFile.h"
+#include "filesystem/DllLibCurl.h"
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+TEST(TestCurlFile, ReuseConnections)
+{
+  const int64_t size = 1000;
+  CHttpTestServer server(size, 0, 1024 * 1024);
+  ASSERT_TRUE(server.Start());
+
+  const XCURL::DllLibCurlGlobal::SPoolStats before = g_curlInterface.GetPoolStats();
+
+  for (int i = 0; i < 5; i++)
+  {
+    CCurlFile file;
+    ASSERT_TRUE(file.Open(CURL(server.GetUrl())));
+
+    char buffer[size];
+    ssize_t done = 0;
+    ssize_t read;
+    while ((read = file.Read(buffer + done, sizeof(buffer) - done)) > 0)
+      done += read;
+    EXPECT_EQ(size, done);
+    file.Close();
+  }
+
+  // a session released to the pool keeps its connection for the next request to the host
+  const XCURL::DllLibCurlGlobal::SPoolStats after = g_curlInterface.GetPoolStats();
+  EXPECT_EQ(1u, server.GetConnections());
+  EXPECT_LE(5u, after.m_transfers - before.m_transfers);
+  EXPECT_LE(4u, after.m_reused - before.m_reused);
+}
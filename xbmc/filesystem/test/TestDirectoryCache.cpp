@@ -0,0 +1,283 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "filesystem/DirectoryCache.h"
+#include "utils/URIUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+void SetListing(CDirectoryCache& cache, const std::string& dir, int count, DIR_CACHE_TYPE cacheType)
+{
+  CFileItemList items;
+  for (int i = 0; i < count; i++)
+    items.Add(CFileItemPtr(new CFileItem(dir + "file" + std::to_string(i) + ".mkv", false)));
+  cache.SetDirectory(dir, items, cacheType);
+}
+
+struct SCall
+{
+  bool list; //!< GetDirectory() of path, else Exists()
+  std::string path;
+  bool exists; //!< result of Exists()
+};
+
+/*
+ * Calls of a movie scan of a share like CVideoInfoScanner does them: the nfo
+ * and disc structure probes, the listing and the artwork lookups. A rescan
+ * repeats them.
+ */
+std::vector<SCall> MakeScanTrace(int movies)
+{
+  std::vector<SCall> trace;
+  for (int pass = 0; pass < 2; pass++)
+  {
+    for (int i = 0; i < movies; i++)
+    {
+      const std::string title = "Movie " + std::to_string(i);
+      const std::string dir = "smb://nas/movies/" + title + "/";
+      const bool hasNfo = i % 3 == 0;
+      const bool hasFanart = i % 2 == 0;
+      trace.push_back({false, dir + "VIDEO_TS/VIDEO_TS.IFO", false});
+      trace.push_back({false, dir + "BDMV/index.bdmv", false});
+      trace.push_back({false, dir + title + ".nfo", hasNfo});
+      trace.push_back({false, dir + "movie.nfo", false});
+      trace.push_back({true, dir, false});
+      trace.push_back({false, dir + title + ".mkv", true});
+      trace.push_back({false, dir + "fanart.jpg", hasFanart});
+      trace.push_back({false, dir + "poster.jpg", hasFanart});
+      trace.push_back({false, dir + title + "-trailer.mkv", false});
+      trace.push_back({false, dir + title + ".srt", false});
+    }
+  }
+  return trace;
+}
+
+/*
+ * A trace recorded from a real scan, one call per line:
+ *
+ *   D <path>        GetDirectory()
+ *   E <0|1> <path>  Exists() and its result
+ */
+std::vector<SCall> LoadTrace(const char* file)
+{
+  std::vector<SCall> trace;
+  std::ifstream stream(file);
+  std::string line;
+  while (std::getline(stream, line))
+  {
+    if (line.size() > 2 && line[0] == 'D')
+      trace.push_back({true, line.substr(2), false});
+    else if (line.size() > 4 && line[0] == 'E')
+      trace.push_back({false, line.substr(4), line[2] == '1'});
+  }
+  return trace;
+}
+
+class CScanReplay
+{
+public:
+  explicit CScanReplay(const std::vector<SCall>& trace) : m_trace(trace)
+  {
+    for (const SCall& call : trace)
+    {
+      if (!call.list && call.exists)
+        m_files.insert(call.path);
+    }
+  }
+
+  //! replays the trace on threads, each one taking every threads-th directory
+  double Run(CDirectoryCache& cache, unsigned int threads)
+  {
+    const auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < threads; i++)
+      workers.emplace_back([this, &cache, i, threads]() { Replay(cache, i, threads); });
+    for (std::thread& worker : workers)
+      worker.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  }
+
+  std::atomic<unsigned int> m_sourceCalls{0};
+  std::atomic<unsigned int> m_wrong{0};
+
+private:
+  void Replay(CDirectoryCache& cache, unsigned int index, unsigned int threads)
+  {
+    std::hash<std::string> hash;
+    for (const SCall& call : m_trace)
+    {
+      const std::string dir = call.list ? call.path : URIUtils::GetDirectory(call.path);
+      if (hash(dir) % threads != index)
+        continue;
+
+      if (call.list)
+      {
+        CFileItemList items;
+        if (!cache.GetDirectory(call.path, items, true))
+        {
+          m_sourceCalls++;
+          for (const std::string& file : m_files)
+          {
+            if (URIUtils::GetDirectory(file) == call.path)
+              items.Add(CFileItemPtr(new CFileItem(file, false)));
+          }
+          cache.SetDirectory(call.path, items, DIR_CACHE_ONCE);
+        }
+      }
+      else
+      {
+        bool inCache;
+        bool exists = cache.FileExists(call.path, inCache);
+        if (!inCache)
+        {
+          m_sourceCalls++;
+          exists = m_files.find(call.path) != m_files.end();
+          if (!exists)
+            cache.AddMissingFile(call.path);
+        }
+        if (exists != call.exists)
+          m_wrong++;
+      }
+    }
+  }
+
+  const std::vector<SCall>& m_trace;
+  std::set<std::string> m_files;
+};
+} // namespace
+
+TEST(TestDirectoryCache, MissingFile)
+{
+  CDirectoryCache cache;
+  const std::string file = "smb://nas/movies/Movie/movie.nfo";
+  bool inCache;
+
+  EXPECT_FALSE(cache.FileExists(file, inCache));
+  EXPECT_FALSE(inCache);
+
+  cache.AddMissingFile(file);
+  EXPECT_FALSE(cache.FileExists(file, inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(cache.FileExists("smb://nas/movies/Movie/other.nfo", inCache));
+  EXPECT_FALSE(inCache);
+
+  // until it is created
+  cache.AddFile(file);
+  EXPECT_FALSE(cache.FileExists(file, inCache));
+  EXPECT_FALSE(inCache);
+
+  // or its directory changes
+  cache.AddMissingFile(file);
+  cache.ClearFile("smb://nas/movies/Movie/movie.mkv");
+  EXPECT_FALSE(cache.FileExists(file, inCache));
+  EXPECT_FALSE(inCache);
+
+  cache.AddMissingFile(file);
+  cache.ClearSubPaths("smb://nas/movies/");
+  EXPECT_FALSE(cache.FileExists(file, inCache));
+  EXPECT_FALSE(inCache);
+  EXPECT_EQ(0u, cache.GetSize());
+}
+
+TEST(TestDirectoryCache, ListingReplacesMissingFiles)
+{
+  CDirectoryCache cache;
+  const std::string dir = "smb://nas/movies/Movie/";
+  bool inCache;
+
+  cache.AddMissingFile(dir + "file1.mkv");
+  SetListing(cache, dir, 2, DIR_CACHE_ONCE);
+  EXPECT_TRUE(cache.FileExists(dir + "file1.mkv", inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(cache.FileExists(dir + "file2.mkv", inCache));
+  EXPECT_TRUE(inCache);
+
+  CFileItemList items;
+  EXPECT_FALSE(cache.GetDirectory(dir, items));
+  EXPECT_TRUE(cache.GetDirectory(dir, items, true));
+  EXPECT_EQ(2, items.Size());
+}
+
+TEST(TestDirectoryCache, SizeBudget)
+{
+  CDirectoryCache cache(64 * 1024);
+  for (int i = 0; i < 100; i++)
+  {
+    const std::string dir = "smb://nas/movies/" + std::to_string(i) + "/";
+    SetListing(cache, dir, 10, DIR_CACHE_ONCE);
+  }
+  EXPECT_LE(cache.GetSize(), 64u * 1024);
+
+  // the least recently used listings are gone
+  bool inCache;
+  cache.FileExists("smb://nas/movies/0/file0.mkv", inCache);
+  EXPECT_FALSE(inCache);
+  EXPECT_TRUE(cache.FileExists("smb://nas/movies/99/file0.mkv", inCache));
+  EXPECT_TRUE(inCache);
+
+  // unless they are always cached
+  SetListing(cache, "zip://archive/", 10, DIR_CACHE_ALWAYS);
+  for (int i = 0; i < 100; i++)
+  {
+    const std::string dir = "smb://nas/shows/" + std::to_string(i) + "/";
+    SetListing(cache, dir, 10, DIR_CACHE_ONCE);
+  }
+  EXPECT_TRUE(cache.FileExists("zip://archive/file0.mkv", inCache));
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.GetSize());
+}
+
+TEST(TestDirectoryCache, TimeToLive)
+{
+  EXPECT_LT(CDirectoryCache::GetTimeToLive("/home/user/movies/"),
+            CDirectoryCache::GetTimeToLive("smb://nas/movies/"));
+  EXPECT_EQ(CDirectoryCache::GetTimeToLive("NFS://nas/movies/"),
+            CDirectoryCache::GetTimeToLive("smb://nas/movies/"));
+}
+
+/*
+ * Replays the directory cache calls of a library scan of 2000 movies on one
+ * and on four threads and counts how often the source has to be asked.
+ * KODI_TEST_DIRCACHE_TRACE replays a recorded trace instead, see LoadTrace().
+ */
+TEST(TestDirectoryCache, ReplayScan)
+{
+  const char* file = std::getenv("KODI_TEST_DIRCACHE_TRACE");
+  const std::vector<SCall> trace = file ? LoadTrace(file) : MakeScanTrace(2000);
+  ASSERT_FALSE(trace.empty());
+
+  for (unsigned int threads : {1u, 4u})
+  {
+    CDirectoryCache cache;
+    CScanReplay replay(trace);
+    const double seconds = replay.Run(cache, threads);
+
+    EXPECT_EQ(0u, replay.m_wrong);
+    EXPECT_LT(replay.m_sourceCalls, trace.size() / 2);
+    const std::string name = "threads" + std::to_string(threads);
+    RecordProperty(name + "_source_calls", static_cast<int>(replay.m_sourceCalls));
+    RecordProperty(name + "_calls_per_second", static_cast<int>(trace.size() / std::max(seconds, 0.001)));
+  }
+}
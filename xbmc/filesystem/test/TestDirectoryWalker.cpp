@@ -0,0 +1,121 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "Util.h"
+#include "filesystem/Directory.h"
+#include "filesystem/DirectoryWalker.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+class TestDirectoryWalker : public testing::Test
+{
+protected:
+  TestDirectoryWalker()
+    : m_root(URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"),
+                                       "TestDirectoryWalker/"))
+  {
+  }
+
+  // 4 folders of 3 subfolders of 2 files each, and a file in each folder
+  void SetUp() override
+  {
+    for (int i = 0; i < 4; i++)
+    {
+      const std::string folder = URIUtils::AddFileToFolder(m_root, "folder" + std::to_string(i));
+      for (int j = 0; j < 3; j++)
+      {
+        const std::string subFolder = URIUtils::AddFileToFolder(folder, "sub" + std::to_string(j));
+        ASSERT_TRUE(CDirectory::Create(subFolder));
+        AddFile(URIUtils::AddFileToFolder(subFolder, "a.txt"));
+        AddFile(URIUtils::AddFileToFolder(subFolder, "b.txt"));
+      }
+      AddFile(URIUtils::AddFileToFolder(folder, "file.txt"));
+    }
+  }
+
+  void TearDown() override { EXPECT_TRUE(CDirectory::RemoveRecursive(m_root)); }
+
+  void AddFile(const std::string& path)
+  {
+    CFile file;
+    ASSERT_TRUE(file.OpenForWrite(path, true));
+    file.Close();
+  }
+
+  static std::vector<std::string> GetPaths(const CFileItemList& items)
+  {
+    std::vector<std::string> paths;
+    for (const auto& item : items)
+      paths.push_back(item->GetPath());
+    return paths;
+  }
+
+  std::string m_root;
+};
+} // namespace
+
+TEST_F(TestDirectoryWalker, RecursiveListing)
+{
+  CFileItemList expected;
+  CUtil::GetRecursiveListing(m_root, expected, "", DIR_FLAG_DEFAULTS);
+  ASSERT_EQ(28, expected.Size());
+
+  // in the same order as the sequential walk
+  CFileItemList items;
+  CDirectoryWalker::GetRecursiveListing(m_root, items, "", DIR_FLAG_DEFAULTS);
+  EXPECT_EQ(GetPaths(expected), GetPaths(items));
+}
+
+TEST_F(TestDirectoryWalker, SkipChildren)
+{
+  CDirectoryWalker walker(m_root, "", DIR_FLAG_DEFAULTS, 2);
+  walker.SetPrepare([](CFileItemList& items) { items.Sort(SortByPath, SortOrderAscending); });
+  walker.SetFilter([](const CFileItem& item) {
+    return item.m_bIsFolder && item.GetLabel() != "sub2";
+  });
+
+  std::vector<std::string> directories;
+  CFileItemList items;
+  while (walker.Next(items))
+  {
+    directories.push_back(items.GetPath());
+    if (items.GetPath() == URIUtils::AddFileToFolder(m_root, "folder1/"))
+      walker.SkipChildren();
+  }
+
+  // the root, 4 folders, sub0 and sub1 of all but folder1
+  ASSERT_EQ(11u, directories.size());
+  EXPECT_EQ(m_root, directories[0]);
+  EXPECT_EQ(URIUtils::AddFileToFolder(m_root, "folder0/"), directories[1]);
+  EXPECT_EQ(URIUtils::AddFileToFolder(m_root, "folder0/sub0/"), directories[2]);
+  EXPECT_EQ(URIUtils::AddFileToFolder(m_root, "folder1/"), directories[4]);
+  EXPECT_EQ(URIUtils::AddFileToFolder(m_root, "folder2/"), directories[5]);
+}
+
+TEST_F(TestDirectoryWalker, Cancel)
+{
+  CDirectoryWalker walker(m_root, "", DIR_FLAG_DEFAULTS);
+  CFileItemList items;
+  ASSERT_TRUE(walker.Next(items));
+  EXPECT_EQ(4, items.Size());
+
+  walker.Cancel();
+  EXPECT_FALSE(walker.Next(items));
+  EXPECT_EQ(0, items.Size());
+}
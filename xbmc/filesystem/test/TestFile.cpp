@@ -7,9 +7,11 @@
  */
 
 #include "filesystem/File.h"
+#include "filesystem/IFile.h"
 #include "test/TestUtils.h"
 
 #include <errno.h>
+#include <memory>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -85,6 +87,74 @@ TEST(TestFile, Read)
   file.Close();
 }
 
+TEST(TestFile, ReadAt)
+{
+  const std::string newLine = CXBMCTestUtils::Instance().getNewLineCharacters();
+  const std::string firstBuf = "About" + newLine;
+  const std::string secondBuf = "-----" + newLine;
+
+  XFILE::CFile file;
+  char buf1[20];
+  char buf2[20];
+  ASSERT_TRUE(file.Open(
+    XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt")));
+  ASSERT_EQ(5, file.Seek(5));
+
+  // vectored read from the start, the position of the file is left alone
+  const XFILE::SReadBuffer buffers[] = {{buf1, firstBuf.length()}, {buf2, secondBuf.length()}};
+  EXPECT_EQ(static_cast<ssize_t>(firstBuf.length() + secondBuf.length()),
+            file.ReadAt(0, buffers, 2));
+  EXPECT_EQ(0, memcmp(firstBuf.c_str(), buf1, firstBuf.length()));
+  EXPECT_EQ(0, memcmp(secondBuf.c_str(), buf2, secondBuf.length()));
+  EXPECT_EQ(5, file.GetPosition());
+
+  // short read at the end of the file
+  EXPECT_EQ(1, file.ReadAt(file.GetLength() - 1, buf1, sizeof(buf1)));
+  EXPECT_EQ(0, file.ReadAt(file.GetLength(), buf1, sizeof(buf1)));
+
+  ssize_t result = -1;
+  auto request = file.ReadAsync(firstBuf.length(), buf2, secondBuf.length(),
+                                [&result](ssize_t read) { result = read; });
+  ASSERT_TRUE(request->Wait(10000));
+  EXPECT_EQ(static_cast<ssize_t>(secondBuf.length()), request->GetResult());
+  EXPECT_EQ(request->GetResult(), result);
+  EXPECT_EQ(0, memcmp(secondBuf.c_str(), buf2, secondBuf.length()));
+  file.Close();
+}
+
+TEST(TestFile, Map)
+{
+  const std::string path = XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt");
+  XFILE::auto_buffer buf;
+  XFILE::CFile file;
+  ASSERT_LT(0, file.LoadFile(path, buf));
+  file.Close();
+
+  // only Kodi's own files are mapped
+  EXPECT_TRUE(XFILE::CFile::CanMap(path));
+  EXPECT_FALSE(XFILE::CFile::CanMap("/media/usb/reffile.txt"));
+  EXPECT_FALSE(XFILE::CFile::CanMap("smb://server/share/reffile.txt"));
+
+  std::unique_ptr<XFILE::IFileView> view = file.MapFile(path);
+#ifdef TARGET_POSIX
+  ASSERT_NE(nullptr, view);
+  ASSERT_EQ(buf.size(), view->GetSize());
+  EXPECT_EQ(0, memcmp(buf.get(), view->GetData(), buf.size()));
+
+  // a view at an unaligned position, also beyond the lifetime of the file
+  ASSERT_TRUE(file.Open(path));
+  view = file.Map(100, 20);
+  file.Close();
+  ASSERT_NE(nullptr, view);
+  EXPECT_EQ(0, memcmp(buf.get() + 100, view->GetData(), 20));
+
+  ASSERT_TRUE(file.Open(path));
+  EXPECT_EQ(nullptr, file.Map(0, buf.size() + 1));
+#else
+  EXPECT_EQ(nullptr, view);
+#endif
+}
+
 TEST(TestFile, Write)
 {
   XFILE::CFile *file;
@@ -123,6 +193,23 @@ TEST(TestFile, Exists)
   EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
 }
 
+TEST(TestFile, ExistsAfterCreate)
+{
+  XFILE::CFile *file;
+  std::string path;
+
+  // a local file found missing is seen once it is created
+  ASSERT_NE(nullptr, file = XBMC_CREATETEMPFILE(""));
+  file->Close();
+  path = XBMC_TEMPFILEPATH(file);
+  EXPECT_TRUE(XFILE::CFile::Delete(path));
+  EXPECT_FALSE(XFILE::CFile::Exists(path));
+  ASSERT_TRUE(file->OpenForWrite(path, true));
+  file->Close();
+  EXPECT_TRUE(XFILE::CFile::Exists(path));
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+}
+
 TEST(TestFile, Stat)
 {
   XFILE::CFile *file;
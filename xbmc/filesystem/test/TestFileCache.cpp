@@ -0,0 +1,120 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "HttpTestServer.h"
+#include "ServiceBroker.h"
+#include "URL.h"
+#include "filesystem/FileCache.h"
+#include "filesystem/IFileTypes.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+class TestFileCache : public testing::Test
+{
+protected:
+  TestFileCache()
+    : m_advancedSettings(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings())
+    , m_parallelReads(m_advancedSettings->m_cacheParallelReads)
+  {
+  }
+
+  ~TestFileCache() override { m_advancedSettings->m_cacheParallelReads = m_parallelReads; }
+
+  // reads the whole file through the cache, returns the rate in KiB/s
+  unsigned int ReadAll(const std::string& url, int64_t size)
+  {
+    CFileCache cache(READ_AUDIO_VIDEO);
+    EXPECT_TRUE(cache.Open(CURL(url)));
+    EXPECT_EQ(size, cache.GetLength());
+
+    const auto begin = std::chrono::steady_clock::now();
+    std::vector<char> buffer(64 * 1024);
+    int64_t pos = 0;
+    while (pos < size)
+    {
+      ssize_t read = cache.Read(buffer.data(), buffer.size());
+      if (read <= 0)
+        break;
+      for (ssize_t i = 0; i < read; i++)
+      {
+        if (buffer[i] != CHttpTestServer::PatternByte(pos + i))
+        {
+          ADD_FAILURE() << "wrong data at " << pos + i;
+          return 0;
+        }
+      }
+      pos += read;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - begin);
+    EXPECT_EQ(size, pos);
+
+    return static_cast<unsigned int>(pos * 1000 / 1024 / std::max<int64_t>(elapsed.count(), 1));
+  }
+
+  std::shared_ptr<CAdvancedSettings> m_advancedSettings;
+  unsigned int m_parallelReads;
+};
+} // namespace
+
+TEST_F(TestFileCache, ParallelReads)
+{
+  const int64_t size = 8 * 1024 * 1024;
+  CHttpTestServer server(size, 20, 4 * 1024 * 1024);
+  ASSERT_TRUE(server.Start());
+
+  m_advancedSettings->m_cacheParallelReads = 1;
+  const unsigned int sequential = ReadAll(server.GetUrl(), size);
+  const unsigned int sequentialRequests = server.GetRequests();
+
+  m_advancedSettings->m_cacheParallelReads = 4;
+  const unsigned int parallel = ReadAll(server.GetUrl(), size);
+
+  RecordProperty("sequential_kbps", sequential);
+  RecordProperty("parallel_kbps", parallel);
+  EXPECT_GT(server.GetRequests() - sequentialRequests, 4u);
+  EXPECT_GT(parallel, 0u);
+}
+
+TEST_F(TestFileCache, ParallelReadsSeek)
+{
+  const int64_t size = 4 * 1024 * 1024;
+  CHttpTestServer server(size, 5, 16 * 1024 * 1024);
+  ASSERT_TRUE(server.Start());
+  m_advancedSettings->m_cacheParallelReads = 3;
+
+  CFileCache cache(READ_AUDIO_VIDEO);
+  ASSERT_TRUE(cache.Open(CURL(server.GetUrl())));
+
+  const int64_t positions[] = {3 * 1024 * 1024 + 17, 100, size - 1000, 1024 * 1024};
+  for (int64_t position : positions)
+  {
+    ASSERT_EQ(position, cache.Seek(position, SEEK_SET));
+    char buffer[1000];
+    size_t done = 0;
+    while (done < sizeof(buffer))
+    {
+      ssize_t read = cache.Read(buffer + done, sizeof(buffer) - done);
+      ASSERT_GT(read, 0);
+      done += read;
+    }
+    for (size_t i = 0; i < sizeof(buffer); i++)
+      ASSERT_EQ(CHttpTestServer::PatternByte(position + i), buffer[i]) << "at " << position + i;
+  }
+}
@@ -0,0 +1,165 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/PersistentFileCache.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace XFILE;
+
+namespace
+{
+const std::string CACHE_PATH = "special://temp/persistentcache/";
+const std::string SOURCE = "smb://server/share/movie.mkv";
+const int64_t SOURCE_SIZE = 1024 * 1024 * 1024;
+
+char PatternByte(int64_t pos)
+{
+  return static_cast<char>((pos * 7) >> 3);
+}
+
+class TestPersistentFileCache : public testing::Test
+{
+protected:
+  ~TestPersistentFileCache() override { CDirectory::RemoveRecursive(CACHE_PATH); }
+
+  void Write(CPersistentFileCache& cache, int64_t pos, size_t size)
+  {
+    std::vector<char> data(size);
+    for (size_t i = 0; i < size; i++)
+      data[i] = PatternByte(pos + i);
+
+    cache.Reset(pos);
+    ASSERT_EQ(static_cast<int>(size), cache.WriteToCache(data.data(), size));
+  }
+
+  void ExpectRead(CPersistentFileCache& cache, int64_t pos, size_t size)
+  {
+    ASSERT_EQ(pos, cache.Seek(pos));
+
+    std::vector<char> data(size);
+    size_t done = 0;
+    while (done < size)
+    {
+      int result = cache.ReadFromCache(data.data() + done, size - done);
+      ASSERT_GT(result, 0);
+      done += result;
+    }
+
+    for (size_t i = 0; i < size; i++)
+      ASSERT_EQ(PatternByte(pos + i), data[i]) << "at " << pos + i;
+  }
+};
+} // namespace
+
+TEST_F(TestPersistentFileCache, Reopen)
+{
+  {
+    CPersistentFileCache cache(CACHE_PATH, SOURCE, SOURCE_SIZE, 1, 1024 * 1024);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    EXPECT_EQ(0, cache.CachedDataEndPos());
+    Write(cache, 0, 1000);
+    Write(cache, 5000, 500);
+  }
+
+  CPersistentFileCache cache(CACHE_PATH, SOURCE, SOURCE_SIZE, 1, 1024 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  EXPECT_EQ(1500, cache.GetCachedBytes());
+
+  // the head is served right away, the rest after a seek
+  EXPECT_EQ(1000, cache.CachedDataEndPos());
+  ExpectRead(cache, 0, 1000);
+  EXPECT_EQ(3000, cache.CachedDataEndPosIfSeekTo(3000));
+  EXPECT_EQ(5500, cache.CachedDataEndPosIfSeekTo(5200));
+  EXPECT_FALSE(cache.Reset(5200, false));
+  EXPECT_EQ(5500, cache.CachedDataEndPos());
+  ExpectRead(cache, 5200, 300);
+}
+
+TEST_F(TestPersistentFileCache, JoinCachedData)
+{
+  CPersistentFileCache cache(CACHE_PATH, SOURCE, SOURCE_SIZE, 1, 1024 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  Write(cache, 2000, 1000);
+  Write(cache, 0, 1000);
+
+  // filling the gap continues after the data behind it
+  Write(cache, 1000, 1000);
+  EXPECT_EQ(3000, cache.CachedDataEndPos());
+  EXPECT_EQ(3000, cache.GetCachedBytes());
+  ExpectRead(cache, 500, 2500);
+}
+
+TEST_F(TestPersistentFileCache, ChangedSource)
+{
+  {
+    CPersistentFileCache cache(CACHE_PATH, SOURCE, SOURCE_SIZE, 1, 1024 * 1024);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    Write(cache, 0, 1000);
+  }
+
+  CPersistentFileCache cache(CACHE_PATH, SOURCE, SOURCE_SIZE, 2, 1024 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  EXPECT_EQ(0, cache.GetCachedBytes());
+  EXPECT_EQ(0, cache.CachedDataEndPos());
+}
+
+TEST_F(TestPersistentFileCache, SingleWriter)
+{
+  CPersistentFileCache cache(CACHE_PATH, SOURCE, SOURCE_SIZE, 1, 1024 * 1024);
+  CPersistentFileCache other(CACHE_PATH, SOURCE, SOURCE_SIZE, 1, 1024 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  EXPECT_EQ(CACHE_RC_ERROR, other.Open());
+
+  cache.Close();
+  EXPECT_EQ(CACHE_RC_OK, other.Open());
+}
+
+TEST_F(TestPersistentFileCache, EvictLeastRecentlyUsed)
+{
+  {
+    CPersistentFileCache cache(CACHE_PATH, SOURCE + ".1", SOURCE_SIZE, 1, 1500);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    Write(cache, 0, 1000);
+  }
+  {
+    // the entry just closed is kept
+    CPersistentFileCache cache(CACHE_PATH, SOURCE + ".2", SOURCE_SIZE, 1, 1500);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    Write(cache, 0, 1000);
+  }
+
+  CPersistentFileCache first(CACHE_PATH, SOURCE + ".1", SOURCE_SIZE, 1, 1500);
+  CPersistentFileCache second(CACHE_PATH, SOURCE + ".2", SOURCE_SIZE, 1, 1500);
+  ASSERT_EQ(CACHE_RC_OK, first.Open());
+  ASSERT_EQ(CACHE_RC_OK, second.Open());
+  EXPECT_EQ(0, first.GetCachedBytes());
+  EXPECT_EQ(1000, second.GetCachedBytes());
+}
+
+TEST_F(TestPersistentFileCache, ShrinkLargeEntry)
+{
+  const int64_t middle = SOURCE_SIZE / 2;
+  {
+    CPersistentFileCache cache(CACHE_PATH, SOURCE, SOURCE_SIZE, 1, 1500);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    Write(cache, middle, 1000);
+    Write(cache, 0, 1000);
+  }
+
+  // over budget only the head and the data around the last read position are kept
+  CPersistentFileCache cache(CACHE_PATH, SOURCE, SOURCE_SIZE, 1, 1500);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  EXPECT_EQ(1000, cache.GetCachedBytes());
+  EXPECT_EQ(middle, cache.CachedDataEndPosIfSeekTo(middle));
+  ExpectRead(cache, 0, 1000);
+}
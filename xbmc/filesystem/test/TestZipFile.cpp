@@ -87,6 +87,68 @@ TEST_F(TestZipFile, Read)
   file.Close();
 }
 
+TEST_F(TestZipFile, SeekBackwards)
+{
+  XFILE::CFile file;
+  std::string reffile = XBMC_REF_FILE_PATH("xbmc/filesystem/test/reffile.txt.zip");
+  CURL zipUrl = URIUtils::CreateArchivePath("zip", CURL(reffile), "reffile.txt");
+  ASSERT_TRUE(file.Open(zipUrl.Get(), XFILE::READ_NO_CACHE));
+
+  char all[1616];
+  EXPECT_EQ(1616, file.Read(all, sizeof(all)));
+
+  // the entry is inflated once, later seeks don't start over
+  char buf[20];
+  for (int64_t position : {1000, 100, 1596, 0, 820})
+  {
+    EXPECT_EQ(position, file.Seek(position, SEEK_SET));
+    EXPECT_EQ(20, file.Read(buf, sizeof(buf)));
+    EXPECT_EQ(0, memcmp(all + position, buf, sizeof(buf)));
+  }
+  EXPECT_EQ(1606, file.Seek(-10, SEEK_END));
+  EXPECT_EQ(10, file.Read(buf, sizeof(buf)));
+  EXPECT_EQ(-1, file.Seek(-1, SEEK_SET));
+  file.Close();
+}
+
+TEST_F(TestZipFile, SeekStored)
+{
+  XFILE::CFile file;
+  std::string reffile = XBMC_REF_FILE_PATH("xbmc/filesystem/test/refZIPstored.zip");
+  CURL zipUrl = URIUtils::CreateArchivePath("zip", CURL(reffile), "reffile.txt");
+  ASSERT_TRUE(file.Open(zipUrl.Get(), XFILE::READ_NO_CACHE));
+  EXPECT_EQ(1616, file.GetLength());
+
+  char all[1616];
+  EXPECT_EQ(1616, file.Read(all, sizeof(all)));
+  EXPECT_EQ(0, memcmp("About\n-----\nXBMC is ", all, 19));
+
+  char buf[20];
+  EXPECT_EQ(0, file.Seek(0, SEEK_SET));
+  EXPECT_EQ(20, file.Read(buf, sizeof(buf)));
+  EXPECT_EQ(20, file.Seek(0, SEEK_CUR));
+  EXPECT_EQ(120, file.Seek(100, SEEK_CUR));
+  EXPECT_EQ(20, file.Read(buf, sizeof(buf)));
+  EXPECT_EQ(0, memcmp(all + 120, buf, sizeof(buf)));
+  EXPECT_EQ(40, file.Seek(-100, SEEK_CUR));
+  EXPECT_EQ(20, file.Read(buf, sizeof(buf)));
+  EXPECT_EQ(0, memcmp(all + 40, buf, sizeof(buf)));
+  EXPECT_EQ(60, file.GetPosition());
+
+  // nothing before the entry or after it is read
+  EXPECT_EQ(-1, file.Seek(-61, SEEK_CUR));
+  EXPECT_EQ(60, file.GetPosition());
+  EXPECT_EQ(-1, file.Seek(1557, SEEK_CUR));
+  EXPECT_EQ(-1, file.Seek(-1617, SEEK_END));
+  EXPECT_EQ(-1, file.Seek(1, SEEK_END));
+  EXPECT_EQ(60, file.GetPosition());
+  EXPECT_EQ(1606, file.Seek(-10, SEEK_END));
+  EXPECT_EQ(10, file.Read(buf, sizeof(buf)));
+  EXPECT_EQ(0, memcmp(all + 1606, buf, 10));
+  EXPECT_EQ(1616, file.Seek(0, SEEK_CUR));
+  file.Close();
+}
+
 TEST_F(TestZipFile, Exists)
 {
   std::string reffile, strpathinzip;
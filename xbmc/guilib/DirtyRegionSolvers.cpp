@@ -10,8 +10,16 @@
 
 #include "windowing/GraphicContext.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 #include <stdio.h>
 
+namespace
+{
+const size_t MAX_BATCHES = 64;
+}
+
 void CUnionDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
 {
   CDirtyRegion unifiedRegion;
@@ -71,3 +79,182 @@ void CGreedyDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegion
       output.push_back(currentRegion);
   }
 }
+
+CTileDirtyRegionSolver::CTileDirtyRegionSolver()
+{
+  m_tileSize       = 64.0f;
+  m_costNewRegion  = 10.0f;
+  m_costPerControl = 2.0f;
+  m_costPerArea    = 0.01f;
+}
+
+CTileDirtyRegionSolver::CTileDirtyRegionSolver(const CRect &viewport) : CTileDirtyRegionSolver()
+{
+  m_viewport = viewport;
+}
+
+float CTileDirtyRegionSolver::GetCost(const CRect &rect, size_t regions) const
+{
+  return m_costNewRegion + m_costPerControl * regions + m_costPerArea * rect.Area();
+}
+
+std::vector<unsigned int> CTileDirtyRegionSolver::MergeRegions(const std::vector<unsigned int> &a, const std::vector<unsigned int> &b)
+{
+  std::vector<unsigned int> merged;
+  merged.reserve(a.size() + b.size());
+  std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(merged));
+  return merged;
+}
+
+size_t CTileDirtyRegionSolver::CountMergedRegions(const std::vector<unsigned int> &a, const std::vector<unsigned int> &b)
+{
+  size_t count = a.size() + b.size();
+  auto itA = a.begin();
+  auto itB = b.begin();
+  while (itA != a.end() && itB != b.end())
+  {
+    if (*itA < *itB)
+      ++itA;
+    else if (*itB < *itA)
+      ++itB;
+    else
+    {
+      count--;
+      ++itA;
+      ++itB;
+    }
+  }
+  return count;
+}
+
+void CTileDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
+{
+  // off-screen animations would otherwise stretch the grid far beyond the screen
+  const CRect viewport = m_viewport.IsEmpty() ?
+      CServiceBroker::GetWinSystem()->GetGfxContext().GetViewWindow() : m_viewport;
+  std::vector<CRect> visible;
+  visible.reserve(input.size());
+  CRect bounds;
+  for (const auto& region : input)
+  {
+    visible.push_back(region);
+    visible.back().Intersect(viewport);
+    bounds.Union(visible.back());
+  }
+  if (bounds.IsEmpty())
+    return;
+
+  // dirty part of each tile of the grid covering the marked regions
+  const int firstColumn = static_cast<int>(std::floor(bounds.x1 / m_tileSize));
+  const int firstRow = static_cast<int>(std::floor(bounds.y1 / m_tileSize));
+  const int columns = static_cast<int>(std::ceil(bounds.x2 / m_tileSize)) - firstColumn;
+  const int rows = static_cast<int>(std::ceil(bounds.y2 / m_tileSize)) - firstRow;
+  std::vector<CRect> tiles(columns * rows);
+  std::vector<std::vector<unsigned int>> tileRegions(columns * rows);
+
+  for (unsigned int i = 0; i < visible.size(); i++)
+  {
+    const CRect &region = visible[i];
+    if (region.IsEmpty())
+      continue;
+
+    const int x1 = static_cast<int>(std::floor(region.x1 / m_tileSize)) - firstColumn;
+    const int y1 = static_cast<int>(std::floor(region.y1 / m_tileSize)) - firstRow;
+    const int x2 = std::max(x1 + 1, static_cast<int>(std::ceil(region.x2 / m_tileSize)) - firstColumn);
+    const int y2 = std::max(y1 + 1, static_cast<int>(std::ceil(region.y2 / m_tileSize)) - firstRow);
+    for (int y = y1; y < y2; y++)
+    {
+      for (int x = x1; x < x2; x++)
+      {
+        CRect tile((firstColumn + x) * m_tileSize, (firstRow + y) * m_tileSize,
+                   (firstColumn + x + 1) * m_tileSize, (firstRow + y + 1) * m_tileSize);
+        tile.Intersect(region);
+        if (tile.IsEmpty())
+          continue;
+
+        tiles[y * columns + x].Union(tile);
+        tileRegions[y * columns + x].push_back(i);
+      }
+    }
+  }
+
+  // join the runs of dirty tiles of a row, and a run with the one above it spanning the same columns
+  std::vector<SBatch> batches;
+  for (int y = 0; y < rows; y++)
+  {
+    int x = 0;
+    while (x < columns)
+    {
+      if (tiles[y * columns + x].IsEmpty())
+      {
+        x++;
+        continue;
+      }
+
+      SBatch run;
+      run.firstColumn = x;
+      run.lastRow = y;
+      for (; x < columns && !tiles[y * columns + x].IsEmpty(); x++)
+      {
+        run.rect.Union(tiles[y * columns + x]);
+        run.regions = MergeRegions(run.regions, tileRegions[y * columns + x]);
+      }
+      run.lastColumn = x - 1;
+
+      auto above = std::find_if(batches.begin(), batches.end(), [&run](const SBatch &batch) {
+        return batch.lastRow == run.lastRow - 1 && batch.firstColumn == run.firstColumn &&
+               batch.lastColumn == run.lastColumn;
+      });
+      if (above != batches.end())
+      {
+        above->rect.Union(run.rect);
+        above->regions = MergeRegions(above->regions, run.regions);
+        above->lastRow = run.lastRow;
+      }
+      else
+        batches.push_back(std::move(run));
+    }
+  }
+
+  // too scattered to pair up within a frame, a single pass is cheaper than many anyway
+  if (batches.size() > MAX_BATCHES)
+  {
+    output.emplace_back(bounds);
+    return;
+  }
+
+  // merge the pair saving the most until no merge is cheaper than separate passes
+  while (batches.size() > 1)
+  {
+    float bestSaving = 0.0f;
+    size_t bestA = 0;
+    size_t bestB = 0;
+    for (size_t a = 0; a < batches.size(); a++)
+    {
+      const float costA = GetCost(batches[a].rect, batches[a].regions.size());
+      for (size_t b = a + 1; b < batches.size(); b++)
+      {
+        CRect merged = batches[a].rect;
+        merged.Union(batches[b].rect);
+        const float saving = costA + GetCost(batches[b].rect, batches[b].regions.size()) -
+                             GetCost(merged, CountMergedRegions(batches[a].regions, batches[b].regions));
+        if (saving > bestSaving)
+        {
+          bestSaving = saving;
+          bestA = a;
+          bestB = b;
+        }
+      }
+    }
+
+    if (bestSaving <= 0.0f)
+      break;
+
+    batches[bestA].rect.Union(batches[bestB].rect);
+    batches[bestA].regions = MergeRegions(batches[bestA].regions, batches[bestB].regions);
+    batches.erase(batches.begin() + bestB);
+  }
+
+  for (const auto& batch : batches)
+    output.emplace_back(batch.rect);
+}
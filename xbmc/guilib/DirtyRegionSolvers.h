@@ -10,6 +10,8 @@
 
 #include "IDirtyRegionSolver.h"
 
+#include <vector>
+
 class CUnionDirtyRegionSolver : public IDirtyRegionSolver
 {
 public:
@@ -37,3 +39,44 @@ private:
   float m_costNewRegion;
   float m_costPerArea;
 };
+
+/*!
+ \brief Solver batching the dirty parts of screen tiles into scissor passes
+
+ The marked regions are cut along a grid of tiles, the dirty parts of
+ neighbouring tiles are joined into rectangles which are then merged
+ greedily while a merge costs less than rendering them in separate passes.
+ A pass renders every control below its scissor, so its cost grows with the
+ controls drawn in it, estimated from the marked regions it covers as each
+ changed control marks its own. Only the parts of the regions inside the
+ viewport are rendered.
+ */
+class CTileDirtyRegionSolver : public IDirtyRegionSolver
+{
+public:
+  //! solves for the view window of the graphic context
+  CTileDirtyRegionSolver();
+  //! solves for a fixed viewport
+  explicit CTileDirtyRegionSolver(const CRect &viewport);
+  void Solve(const CDirtyRegionList &input, CDirtyRegionList &output) override;
+
+private:
+  struct SBatch
+  {
+    CRect rect;                     //!< dirty bounds of the tiles in the batch
+    std::vector<unsigned int> regions; //!< sorted indices of the marked regions it covers
+    int firstColumn;
+    int lastColumn;
+    int lastRow;
+  };
+
+  float GetCost(const CRect &rect, size_t regions) const;
+  static std::vector<unsigned int> MergeRegions(const std::vector<unsigned int> &a, const std::vector<unsigned int> &b);
+  static size_t CountMergedRegions(const std::vector<unsigned int> &a, const std::vector<unsigned int> &b);
+
+  CRect m_viewport; //!< empty to use the view window
+  float m_tileSize;
+  float m_costNewRegion;
+  float m_costPerControl;
+  float m_costPerArea;
+};
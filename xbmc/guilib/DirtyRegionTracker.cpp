@@ -45,6 +45,10 @@ void CDirtyRegionTracker::SelectAlgorithm()
       m_solver = new CUnionDirtyRegionSolver();
       CLog::Log(LOGDEBUG, "guilib: Union as algorithm for solving rendering passes");
       break;
+    case DIRTYREGION_SOLVER_TILES:
+      CLog::Log(LOGDEBUG, "guilib: Tile batches as algorithm for solving rendering passes");
+      m_solver = new CTileDirtyRegionSolver();
+      break;
     case DIRTYREGION_SOLVER_FILL_VIEWPORT_ALWAYS:
     default:
       CLog::Log(LOGDEBUG, "guilib: Fill viewport always for solving rendering passes");
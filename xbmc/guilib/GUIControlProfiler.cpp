@@ -241,6 +241,7 @@ void CGUIControlProfiler::Start(void)
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
+  m_dirtyRegionFrames.clear();
 }
 
 void CGUIControlProfiler::BeginVisibility(CGUIControl *pControl)
@@ -267,6 +268,21 @@ void CGUIControlProfiler::EndRender(CGUIControl *pControl)
   item->EndRender();
 }
 
+void CGUIControlProfiler::AddDirtyRegions(const CDirtyRegionList &marked, const CDirtyRegionList &rendered)
+{
+  SDirtyRegionFrame frame = {0.0f, 0.0f, 0};
+  for (const auto& region : marked)
+    frame.markedArea += region.Area();
+  for (const auto& region : rendered)
+  {
+    if (region.IsEmpty())
+      continue;
+    frame.renderedArea += region.Area();
+    frame.passes++;
+  }
+  m_dirtyRegionFrames.push_back(frame);
+}
+
 CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pControl)
 {
   if (m_pLastItem)
@@ -330,5 +346,34 @@ bool CGUIControlProfiler::SaveResults(void)
   doc.LinkEndChild(root);
 
   m_ItemHead.SaveToXML(root);
+  SaveDirtyRegions(root);
   return doc.SaveFile(m_strOutputFile);
 }
+
+void CGUIControlProfiler::SaveDirtyRegions(TiXmlElement *parent) const
+{
+  if (m_dirtyRegionFrames.empty())
+    return;
+
+  // overdraw is the area rendered per area marked dirty, overlaps of marked regions count twice
+  TiXmlElement *xmlRegions = new TiXmlElement("dirtyregions");
+  parent->LinkEndChild(xmlRegions);
+  float markedArea = 0.0f;
+  float renderedArea = 0.0f;
+  for (const auto& frame : m_dirtyRegionFrames)
+  {
+    TiXmlElement *xmlFrame = new TiXmlElement("frame");
+    xmlRegions->LinkEndChild(xmlFrame);
+    xmlFrame->SetAttribute("passes", frame.passes);
+    xmlFrame->SetAttribute("markedarea", StringUtils::Format("%.0f", frame.markedArea).c_str());
+    xmlFrame->SetAttribute("renderedarea", StringUtils::Format("%.0f", frame.renderedArea).c_str());
+    if (frame.markedArea > 0.0f)
+      xmlFrame->SetAttribute("overdraw", StringUtils::Format("%.2f", frame.renderedArea / frame.markedArea).c_str());
+    markedArea += frame.markedArea;
+    renderedArea += frame.renderedArea;
+  }
+
+  xmlRegions->SetAttribute("framecount", static_cast<int>(m_dirtyRegionFrames.size()));
+  if (markedArea > 0.0f)
+    xmlRegions->SetAttribute("overdraw", StringUtils::Format("%.2f", renderedArea / markedArea).c_str());
+}
@@ -57,6 +57,10 @@ public:
   void EndVisibility(CGUIControl *pControl);
   void BeginRender(CGUIControl *pControl);
   void EndRender(CGUIControl *pControl);
+  /*!
+   \brief Record the area marked dirty and the area rendered by the passes of a frame
+   */
+  void AddDirtyRegions(const CDirtyRegionList &marked, const CDirtyRegionList &rendered);
   int GetMaxFrameCount(void) const { return m_iMaxFrameCount; };
   void SetMaxFrameCount(int iMaxFrameCount) { m_iMaxFrameCount = iMaxFrameCount; };
   void SetOutputFile(const std::string &strOutputFile) { m_strOutputFile = strOutputFile; };
@@ -74,6 +78,15 @@ private:
   CGUIControlProfilerItem m_ItemHead;
   CGUIControlProfilerItem *m_pLastItem;
   CGUIControlProfilerItem *FindOrAddControl(CGUIControl *pControl);
+  void SaveDirtyRegions(TiXmlElement *parent) const;
+
+  struct SDirtyRegionFrame
+  {
+    float markedArea;
+    float renderedArea;
+    unsigned int passes;
+  };
+  std::vector<SDirtyRegionFrame> m_dirtyRegionFrames;
 
   static bool m_bIsRunning;
   std::string m_strOutputFile;
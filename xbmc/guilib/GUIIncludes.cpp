@@ -93,6 +93,7 @@ void CGUIIncludes::Clear()
   m_constants.clear();
   m_skinvariables.clear();
   m_files.clear();
+  m_fileConditions.clear();
   m_expressions.clear();
 }
 
@@ -232,7 +233,9 @@ void CGUIIncludes::LoadIncludes(const TiXmlElement *node)
 
       if (condition)
       { // load include file if condition evals to true
-        if (CServiceBroker::GetGUI()->GetInfoManager().Register(condition)->Get())
+        bool value = CServiceBroker::GetGUI()->GetInfoManager().Register(condition)->Get();
+        m_fileConditions.push_back(std::make_pair(condition, value));
+        if (value)
           Load_Internal(file);
       }
       else
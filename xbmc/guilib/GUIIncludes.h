@@ -61,6 +61,11 @@ public:
    */
   const INFO::CSkinVariableString* CreateSkinVariable(const std::string& name, int context);
 
+  /*!
+   \brief The conditions of the include files loaded by Load(), with the values they had.
+  */
+  const std::vector<std::pair<std::string, bool>>& GetFileConditions() const { return m_fileConditions; }
+
 private:
   enum ResolveParamsResult
   {
@@ -119,6 +124,7 @@ private:
   std::string ResolveExpressions(const std::string &expression) const;
 
   std::vector<std::string> m_files;
+  std::vector<std::pair<std::string, bool>> m_fileConditions;
   std::map<std::string, std::pair<TiXmlElement, Params>> m_includes;
   std::map<std::string, TiXmlElement> m_defaults;
   std::map<std::string, TiXmlElement> m_skinvariables;
@@ -23,8 +23,10 @@
 #include "messaging/ApplicationMessenger.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
+#include "threads/Event.h"
 #include "threads/SingleLock.h"
 #include "utils/Color.h"
+#include "utils/JobManager.h"
 #include "utils/StringUtils.h"
 #include "utils/TimeUtils.h"
 #include "utils/Variant.h"
@@ -95,16 +97,7 @@ bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
   // Find appropriate skin folder + resolution to load from
   std::string strPath;
   std::string strLowerPath;
-  if (bContainsPath)
-    strPath = strFileName;
-  else
-  {
-    // FIXME: strLowerPath needs to eventually go since resToUse can get incorrectly overridden
-    std::string strFileNameLower = strFileName;
-    StringUtils::ToLower(strFileNameLower);
-    strLowerPath =  g_SkinInfo->GetSkinPath(strFileNameLower, &m_coordsRes);
-    strPath = g_SkinInfo->GetSkinPath(strFileName, &m_coordsRes);
-  }
+  GetXMLPaths(strFileName, bContainsPath, strPath, strLowerPath, &m_coordsRes);
 
   bool ret = LoadXML(strPath, strLowerPath);
   if (ret)
@@ -123,8 +116,98 @@ bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
   return ret;
 }
 
+struct CGUIWindow::SPreload
+{
+  std::string path;
+  std::string lowerPath;
+  CCriticalSection section;
+  CEvent done{true};
+  bool started = false;
+  std::unique_ptr<TiXmlElement> root;
+};
+
+void CGUIWindow::GetXMLPaths(const std::string& strFileName, bool bContainsPath, std::string& strPath, std::string& strLowerPath, RESOLUTION_INFO* res)
+{
+  if (bContainsPath)
+    strPath = strFileName;
+  else
+  {
+    // FIXME: strLowerPath needs to eventually go since resToUse can get incorrectly overridden
+    std::string strFileNameLower = strFileName;
+    StringUtils::ToLower(strFileNameLower);
+    strLowerPath =  g_SkinInfo->GetSkinPath(strFileNameLower, res);
+    strPath = g_SkinInfo->GetSkinPath(strFileName, res);
+  }
+}
+
+std::unique_ptr<TiXmlElement> CGUIWindow::ParseXML(const std::string& strPath, const std::string& strLowerPath)
+{
+  CXBMCTinyXML xmlDoc;
+  std::string strPathLower = strPath;
+  StringUtils::ToLower(strPathLower);
+  if (!xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(strPathLower) && !xmlDoc.LoadFile(strLowerPath))
+    return nullptr;
+
+  if (!StringUtils::EqualsNoCase(xmlDoc.RootElement()->Value(), "window"))
+    return nullptr;
+
+  return std::unique_ptr<TiXmlElement>(static_cast<TiXmlElement*>(xmlDoc.RootElement()->Clone()));
+}
+
+void CGUIWindow::RunPreload(SPreload& preload)
+{
+  {
+    CSingleLock lock(preload.section);
+    if (preload.started)
+      return;
+    preload.started = true;
+  }
+
+  preload.root = ParseXML(preload.path, preload.lowerPath);
+  preload.done.Set();
+}
+
+void CGUIWindow::PreloadXML()
+{
+  if (m_windowLoaded || m_windowXMLRootElement || !g_SkinInfo)
+    return;
+
+  std::string xmlFile = GetProperty("xmlfile").asString();
+  if (xmlFile.empty())
+    return;
+
+  bool bHasPath = xmlFile.find("\\") != std::string::npos || xmlFile.find("/") != std::string::npos;
+  auto preload = std::make_shared<SPreload>();
+  GetXMLPaths(xmlFile, bHasPath, preload->path, preload->lowerPath, nullptr);
+  // replaces one left from a previous load of the skin, the file may have changed since
+  m_preload = preload;
+  CJobManager::GetInstance().Submit([preload]() { RunPreload(*preload); }, CJob::PRIORITY_HIGH);
+}
+
 bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLowerPath)
 {
+  // a window resolved before with the same include conditions needs neither loading nor resolving
+  std::unique_ptr<TiXmlElement> cachedRoot = g_SkinInfo->GetResolvedWindow(strPath, m_xmlIncludeConditions);
+  if (cachedRoot)
+  {
+    CLog::Log(LOGDEBUG, "Using cached resolved xml for %s", strPath.c_str());
+    m_preload.reset();
+    return Load(cachedRoot.get());
+  }
+
+  // take the xml parsed by PreloadXML(), parse it here if no job got to it yet
+  if (!m_windowXMLRootElement && m_preload)
+  {
+    RunPreload(*m_preload);
+    m_preload->done.Wait();
+    if (m_preload->path == strPath && m_preload->root)
+    {
+      CLog::Log(LOGDEBUG, "Using preloaded xml for %s", strPath.c_str());
+      m_windowXMLRootElement = m_preload->root.release();
+    }
+    m_preload.reset();
+  }
+
   // load window xml if we don't have it stored yet
   if (!m_windowXMLRootElement)
   {
@@ -151,7 +234,11 @@ bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLower
   else
     CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-  return Load(Prepare(m_windowXMLRootElement).get());
+  std::unique_ptr<TiXmlElement> preparedRoot = Prepare(m_windowXMLRootElement);
+  if (preparedRoot)
+    g_SkinInfo->SetResolvedWindow(strPath, *preparedRoot, m_xmlIncludeConditions);
+
+  return Load(preparedRoot.get());
 }
 
 std::unique_ptr<TiXmlElement> CGUIWindow::Prepare(TiXmlElement *pRootElement)
@@ -66,6 +66,11 @@ public:
   bool Initialize();  // loads the window
   bool Load(const std::string& strFileName, bool bContainsPath = false);
 
+  /*!
+   \brief Parse the window XML on a job, a following load waits for it instead of parsing it again
+   */
+  void PreloadXML();
+
   void CenterWindow();
 
   void DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregions) override;
@@ -284,7 +289,14 @@ protected:
   bool m_custom;
 
 private:
+  struct SPreload;
+
+  static void GetXMLPaths(const std::string& strFileName, bool bContainsPath, std::string& strPath, std::string& strLowerPath, RESOLUTION_INFO* res);
+  static std::unique_ptr<TiXmlElement> ParseXML(const std::string& strPath, const std::string& strLowerPath);
+  static void RunPreload(SPreload& preload);
+
   std::map<std::string, CVariant, icompare> m_mapProperties;
   std::map<INFO::InfoPtr, bool> m_xmlIncludeConditions; ///< \brief used to store conditions used to resolve includes for this window
+  std::shared_ptr<SPreload> m_preload; ///< \brief window XML being parsed by PreloadXML()
 };
 
@@ -19,6 +19,7 @@
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 #include "addons/Skin.h"
+#include "GUIControlProfiler.h"
 #include "GUITexture.h"
 #include "utils/Variant.h"
 #include "input/Key.h"
@@ -168,6 +169,22 @@ void CGUIWindowManager::Initialize()
   CApplicationMessenger::GetInstance().RegisterReceiver(this);
 }
 
+void CGUIWindowManager::PreloadWindows(const std::vector<int>& windowIds)
+{
+  for (int id : windowIds)
+  {
+    CGUIWindow *pWindow = GetWindow(id);
+    if (pWindow)
+      pWindow->PreloadXML();
+  }
+
+  for (const auto& entry : m_mapWindows)
+  {
+    if (entry.second->GetLoadType() == CGUIWindow::LOAD_ON_GUI_INIT)
+      entry.second->PreloadXML();
+  }
+}
+
 void CGUIWindowManager::CreateWindows()
 {
   Add(new CGUIWindowHome);
@@ -1167,6 +1184,7 @@ bool CGUIWindowManager::Render()
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
 
   bool hasRendered = false;
+  bool hasScissors = false;
   // If we visualize the regions we will always render the entire viewport
   if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiVisualizeDirtyRegions || CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ALWAYS)
   {
@@ -1183,6 +1201,7 @@ bool CGUIWindowManager::Render()
   }
   else
   {
+    hasScissors = true;
     for (const auto& i : dirtyRegions)
     {
       if (i.IsEmpty())
@@ -1205,6 +1224,17 @@ bool CGUIWindowManager::Render()
       CGUITexture::DrawQuad(i, 0x4c00ff00);
   }
 
+  if (CGUIControlProfiler::IsRunning())
+  {
+    // the viewport is rendered whole unless the solved regions are passed as scissors
+    CDirtyRegionList renderedRegions;
+    if (hasScissors)
+      renderedRegions = dirtyRegions;
+    else if (hasRendered)
+      renderedRegions.emplace_back(CServiceBroker::GetWinSystem()->GetGfxContext().GetViewWindow());
+    CGUIControlProfiler::Instance().AddDirtyRegions(m_tracker.GetMarkedRegions(), renderedRegions);
+  }
+
   return hasRendered;
 }
 
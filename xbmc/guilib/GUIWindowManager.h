@@ -56,6 +56,10 @@ public:
   bool SendMessage(int message, int senderID, int destID, int param1 = 0, int param2 = 0);
   bool SendMessage(CGUIMessage& message, int window);
   void Initialize();
+  /*!
+   \brief Start parsing the XML of the given windows and of those loaded on init in the background
+   */
+  void PreloadWindows(const std::vector<int>& windowIds);
   void Add(CGUIWindow* pWindow);
   void AddUniqueInstance(CGUIWindow *window);
   void AddCustomWindow(CGUIWindow* pWindow);
@@ -0,0 +1,281 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIWindowXMLCache.h"
+
+#include "GUIComponent.h"
+#include "GUIInfoManager.h"
+#include "ServiceBroker.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/IFile.h"
+#include "utils/Crc32.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/log.h"
+
+#include <atomic>
+#include <cstring>
+
+using namespace XFILE;
+
+namespace
+{
+const char CACHE_MAGIC[4] = { 'K', 'X', 'M', 'L' };
+// bump whenever the format or the resolving of includes changes
+const uint32_t CACHE_VERSION = 1;
+const char* CACHE_PATH = "special://temp/skincache/";
+// numbers the temp files, a window may be written by two jobs at once
+std::atomic<unsigned int> tempFileCount(0);
+
+enum NodeType : uint8_t
+{
+  NODE_ELEMENT,
+  NODE_TEXT,
+  NODE_CDATA
+};
+
+void WriteUInt(std::string& data, uint32_t value)
+{
+  data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::string& data, const std::string& value)
+{
+  WriteUInt(data, static_cast<uint32_t>(value.size()));
+  data.append(value);
+}
+
+class CReader
+{
+public:
+  CReader(const uint8_t* data, size_t size) : m_pos(data), m_end(data + size) {}
+
+  bool ReadByte(uint8_t& value)
+  {
+    if (m_pos == m_end)
+      return false;
+    value = *m_pos++;
+    return true;
+  }
+
+  bool ReadUInt(uint32_t& value)
+  {
+    if (static_cast<size_t>(m_end - m_pos) < sizeof(value))
+      return false;
+    memcpy(&value, m_pos, sizeof(value));
+    m_pos += sizeof(value);
+    return true;
+  }
+
+  bool ReadString(std::string& value)
+  {
+    uint32_t size;
+    if (!ReadUInt(size) || static_cast<size_t>(m_end - m_pos) < size)
+      return false;
+    value.assign(reinterpret_cast<const char*>(m_pos), size);
+    m_pos += size;
+    return true;
+  }
+
+  bool ReadMagic()
+  {
+    if (static_cast<size_t>(m_end - m_pos) < sizeof(CACHE_MAGIC) ||
+        memcmp(m_pos, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0)
+      return false;
+    m_pos += sizeof(CACHE_MAGIC);
+    return true;
+  }
+
+private:
+  const uint8_t* m_pos;
+  const uint8_t* m_end;
+};
+
+std::unique_ptr<TiXmlElement> ReadElement(CReader& reader)
+{
+  std::string value;
+  if (!reader.ReadString(value))
+    return nullptr;
+
+  std::unique_ptr<TiXmlElement> element(new TiXmlElement(value));
+  uint32_t count;
+  if (!reader.ReadUInt(count))
+    return nullptr;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    std::string name;
+    if (!reader.ReadString(name) || !reader.ReadString(value))
+      return nullptr;
+    element->SetAttribute(name, value);
+  }
+
+  if (!reader.ReadUInt(count))
+    return nullptr;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    uint8_t type;
+    if (!reader.ReadByte(type))
+      return nullptr;
+    if (type == NODE_ELEMENT)
+    {
+      std::unique_ptr<TiXmlElement> child = ReadElement(reader);
+      if (!child)
+        return nullptr;
+      element->LinkEndChild(child.release());
+    }
+    else if (type == NODE_TEXT || type == NODE_CDATA)
+    {
+      if (!reader.ReadString(value))
+        return nullptr;
+      TiXmlText* text = new TiXmlText(value);
+      text->SetCDATA(type == NODE_CDATA);
+      element->LinkEndChild(text);
+    }
+    else
+      return nullptr;
+  }
+  return element;
+}
+} // namespace
+
+std::unique_ptr<TiXmlElement> CGUIWindowXMLCache::Get(const std::string& path, std::map<INFO::InfoPtr, bool>& includeConditions) const
+{
+  if (m_stamp.empty())
+    return nullptr;
+
+  // read it where the platform can't map files
+  const std::string cacheFile = GetCacheFile(path);
+  std::unique_ptr<IFileView> view = CFile().MapFile(cacheFile);
+  auto_buffer buffer;
+  if (!view && CFile().LoadFile(cacheFile, buffer) <= 0)
+    return nullptr;
+
+  CReader reader(view ? view->GetData() : reinterpret_cast<const uint8_t*>(buffer.get()),
+                 view ? view->GetSize() : buffer.size());
+  uint32_t version;
+  std::string stamp;
+  std::string cachedPath;
+  if (!reader.ReadMagic() || !reader.ReadUInt(version) || version != CACHE_VERSION ||
+      !reader.ReadString(stamp) || stamp != m_stamp ||
+      !reader.ReadString(cachedPath) || cachedPath != path)
+    return nullptr;
+
+  // the includes taken depend on these
+  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
+  std::map<INFO::InfoPtr, bool> conditions;
+  uint32_t count;
+  if (!reader.ReadUInt(count))
+    return nullptr;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    std::string expression;
+    uint8_t value;
+    if (!reader.ReadString(expression) || !reader.ReadByte(value))
+      return nullptr;
+    INFO::InfoPtr condition = infoMgr.Register(expression);
+    if (!condition || condition->Get() != (value != 0))
+      return nullptr;
+    conditions.insert(std::make_pair(condition, value != 0));
+  }
+
+  std::unique_ptr<TiXmlElement> root = ReadElement(reader);
+  if (!root)
+  {
+    CLog::Log(LOGWARNING, "CGUIWindowXMLCache: invalid cache of %s", path.c_str());
+    return nullptr;
+  }
+
+  includeConditions.swap(conditions);
+  return root;
+}
+
+void CGUIWindowXMLCache::Set(const std::string& path, const TiXmlElement& root, const std::map<INFO::InfoPtr, bool>& includeConditions) const
+{
+  if (m_stamp.empty())
+    return;
+
+  auto data = std::make_shared<std::string>(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  WriteUInt(*data, CACHE_VERSION);
+  WriteString(*data, m_stamp);
+  WriteString(*data, path);
+  WriteUInt(*data, static_cast<uint32_t>(includeConditions.size()));
+  for (const auto& condition : includeConditions)
+  {
+    WriteString(*data, condition.first->GetExpression());
+    data->push_back(condition.second ? 1 : 0);
+  }
+  Serialize(root, *data);
+
+  const std::string file = GetCacheFile(path);
+  const std::string tempFile = StringUtils::Format("%s.%u.tmp", file.c_str(), tempFileCount++);
+  CJobManager::GetInstance().Submit([data, file, tempFile]() {
+    // written aside and renamed, so a window being loaded never sees half of it
+    CFile cacheFile;
+    if (!CDirectory::Exists(CACHE_PATH) && !CDirectory::Create(CACHE_PATH))
+      return;
+    if (!cacheFile.OpenForWrite(tempFile, true))
+      return;
+    const bool written = cacheFile.Write(data->data(), data->size()) == static_cast<ssize_t>(data->size());
+    cacheFile.Close();
+    if (!written || !CFile::Rename(tempFile, file))
+    {
+      CLog::Log(LOGWARNING, "CGUIWindowXMLCache: failed to write %s", file.c_str());
+      CFile::Delete(tempFile);
+    }
+  });
+}
+
+void CGUIWindowXMLCache::Serialize(const TiXmlElement& element, std::string& data)
+{
+  WriteString(data, element.ValueStr());
+
+  uint32_t count = 0;
+  for (const TiXmlAttribute* attribute = element.FirstAttribute(); attribute; attribute = attribute->Next())
+    count++;
+  WriteUInt(data, count);
+  for (const TiXmlAttribute* attribute = element.FirstAttribute(); attribute; attribute = attribute->Next())
+  {
+    WriteString(data, attribute->NameTStr());
+    WriteString(data, attribute->ValueStr());
+  }
+
+  // comments and the like aren't used by windows
+  count = 0;
+  for (const TiXmlNode* child = element.FirstChild(); child; child = child->NextSibling())
+  {
+    if (child->Type() == TiXmlNode::TINYXML_ELEMENT || child->Type() == TiXmlNode::TINYXML_TEXT)
+      count++;
+  }
+  WriteUInt(data, count);
+  for (const TiXmlNode* child = element.FirstChild(); child; child = child->NextSibling())
+  {
+    if (child->Type() == TiXmlNode::TINYXML_ELEMENT)
+    {
+      data.push_back(NODE_ELEMENT);
+      Serialize(*child->ToElement(), data);
+    }
+    else if (child->Type() == TiXmlNode::TINYXML_TEXT)
+    {
+      data.push_back(child->ToText()->CDATA() ? NODE_CDATA : NODE_TEXT);
+      WriteString(data, child->ValueStr());
+    }
+  }
+}
+
+std::unique_ptr<TiXmlElement> CGUIWindowXMLCache::Deserialize(const uint8_t* data, size_t size)
+{
+  CReader reader(data, size);
+  return ReadElement(reader);
+}
+
+std::string CGUIWindowXMLCache::GetCacheFile(const std::string& path)
+{
+  return StringUtils::Format("%s%08x.bin", CACHE_PATH, Crc32::Compute(path));
+}
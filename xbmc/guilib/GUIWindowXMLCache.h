@@ -0,0 +1,57 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "interfaces/info/InfoBool.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+class TiXmlElement;
+
+/*!
+ \brief Cache of window XML with its includes resolved
+
+ Windows are stored in a binary form in the temp folder, together with the
+ conditions of the includes they were resolved with. A window is only taken
+ from the cache while these conditions have the same values and the skin
+ files are those it was resolved from, which the stamp tells.
+ */
+class CGUIWindowXMLCache
+{
+public:
+  /*!
+   \brief Set the stamp of the skin files and includes loaded, windows cached with another stamp aren't used
+   */
+  void SetStamp(const std::string& stamp) { m_stamp = stamp; }
+
+  /*!
+   \brief Get the resolved XML of a window
+   \param path path of the window XML file
+   \param includeConditions [out] the conditions of the includes it was resolved with
+   \return the root element, nullptr if the window isn't cached or its include conditions changed
+   */
+  std::unique_ptr<TiXmlElement> Get(const std::string& path, std::map<INFO::InfoPtr, bool>& includeConditions) const;
+
+  /*!
+   \brief Store the resolved XML of a window, written in the background
+   */
+  void Set(const std::string& path, const TiXmlElement& root, const std::map<INFO::InfoPtr, bool>& includeConditions) const;
+
+  static void Serialize(const TiXmlElement& element, std::string& data);
+  static std::unique_ptr<TiXmlElement> Deserialize(const uint8_t* data, size_t size);
+
+private:
+  static std::string GetCacheFile(const std::string& path);
+
+  std::string m_stamp;
+};
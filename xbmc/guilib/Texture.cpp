@@ -11,7 +11,9 @@
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "DDSImage.h"
+#include "FFmpegImage.h"
 #include "filesystem/File.h"
+#include "filesystem/IFile.h"
 #include "filesystem/ResourceFile.h"
 #include "filesystem/XbtFile.h"
 #if defined(TARGET_DARWIN_EMBEDDED)
@@ -233,13 +235,6 @@ bool CBaseTexture::LoadFromFileInternal(const std::string& texturePath, unsigned
   unsigned int height = maxHeight ? std::min(maxHeight, CServiceBroker::GetRenderSystem()->GetMaxTextureSize()) :
                                     CServiceBroker::GetRenderSystem()->GetMaxTextureSize();
 
-  // Read image into memory to use our vfs
-  XFILE::CFile file;
-  XFILE::auto_buffer buf;
-
-  if (file.LoadFile(texturePath, buf) <= 0)
-    return false;
-
   CURL url(texturePath);
   // make sure resource:// paths are properly resolved
   if (url.IsProtocol("resource"))
@@ -249,9 +244,16 @@ bool CBaseTexture::LoadFromFileInternal(const std::string& texturePath, unsigned
       url.Parse(translatedPath);
   }
 
+  // Read image into memory to use our vfs
+  XFILE::CFile file;
+  XFILE::auto_buffer buf;
+
   // handle xbt:// paths differently because it allows loading the texture directly from memory
   if (url.IsProtocol("xbt"))
   {
+    if (file.LoadFile(texturePath, buf) <= 0)
+      return false;
+
     XFILE::CXbtFile xbtFile;
     if (!xbtFile.Open(url))
       return false;
@@ -267,7 +269,31 @@ bool CBaseTexture::LoadFromFileInternal(const std::string& texturePath, unsigned
   else
     pImage = ImageFactory::CreateLoaderFromMimeType(strMimeType);
 
-  if (!LoadIImage(pImage, (unsigned char *)buf.get(), buf.size(), width, height))
+  // images of the skin and add-ons are mapped instead, unless an image decoder
+  // add-on loads them which may write to the buffer. Ours only reads it.
+  std::unique_ptr<XFILE::IFileView> view;
+  if (dynamic_cast<CFFmpegImage*>(pImage))
+    view = file.MapFile(url.Get());
+
+  unsigned char* data;
+  size_t size;
+  if (view)
+  {
+    data = const_cast<unsigned char*>(view->GetData());
+    size = view->GetSize();
+  }
+  else
+  {
+    if (file.LoadFile(texturePath, buf) <= 0)
+    {
+      delete pImage;
+      return false;
+    }
+    data = reinterpret_cast<unsigned char*>(buf.get());
+    size = buf.size();
+  }
+
+  if (!LoadIImage(pImage, data, size, width, height))
   {
     CLog::Log(LOGDEBUG, "%s - Load of %s failed.", __FUNCTION__, CURL::GetRedacted(texturePath).c_str());
     delete pImage;
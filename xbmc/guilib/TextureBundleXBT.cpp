@@ -59,19 +59,11 @@ void CTextureBundleXBT::CloseBundle()
   }
 }
 
-bool CTextureBundleXBT::OpenBundle()
+std::string CTextureBundleXBT::GetBundlePath(bool themeBundle)
 {
   // Find the correct texture file (skin or theme)
-
-  auto mediaDir = CServiceBroker::GetWinSystem()->GetGfxContext().GetMediaDir();
-  if (mediaDir.empty())
-  {
-    mediaDir = CSpecialProtocol::TranslatePath(
-      URIUtils::AddFileToFolder("special://home/addons",
-        CServiceBroker::GetSettingsComponent()->GetSettings()->GetString(CSettings::SETTING_LOOKANDFEEL_SKIN)));
-  }
-
-  if (m_themeBundle)
+  std::string path;
+  if (themeBundle)
   {
     // if we are the theme bundle, we only load if the user has chosen
     // a valid theme (or the skin has a default one)
@@ -79,19 +71,26 @@ bool CTextureBundleXBT::OpenBundle()
     if (!theme.empty() && !StringUtils::EqualsNoCase(theme, "SKINDEFAULT"))
     {
       std::string themeXBT(URIUtils::ReplaceExtension(theme, ".xbt"));
-      m_path = URIUtils::AddFileToFolder(CServiceBroker::GetWinSystem()->GetGfxContext().GetMediaDir(), "media", themeXBT);
+      path = URIUtils::AddFileToFolder(CServiceBroker::GetWinSystem()->GetGfxContext().GetMediaDir(), "media", themeXBT);
     }
     else
     {
-      return false;
+      return "";
     }
   }
   else
   {
-    m_path = URIUtils::AddFileToFolder(CServiceBroker::GetWinSystem()->GetGfxContext().GetMediaDir(), "media", "Textures.xbt");
+    path = URIUtils::AddFileToFolder(CServiceBroker::GetWinSystem()->GetGfxContext().GetMediaDir(), "media", "Textures.xbt");
   }
 
-  m_path = CSpecialProtocol::TranslatePathConvertCase(m_path);
+  return CSpecialProtocol::TranslatePathConvertCase(path);
+}
+
+bool CTextureBundleXBT::OpenBundle()
+{
+  m_path = GetBundlePath(m_themeBundle);
+  if (m_path.empty())
+    return false;
 
   // Load the texture file
   if (!XFILE::CXbtManager::GetInstance().GetReader(CURL(m_path), m_XBTFReader))
@@ -152,14 +151,14 @@ bool CTextureBundleXBT::LoadTexture(const std::string& Filename, CBaseTexture**
 {
   std::string name = Normalize(Filename);
 
-  CXBTFFile file;
-  if (!m_XBTFReader->Get(name, file))
+  const CXBTFFile* file = m_XBTFReader->Find(name);
+  if (file == nullptr)
     return false;
 
-  if (file.GetFrames().empty())
+  if (file->GetFrames().empty())
     return false;
 
-  CXBTFFrame& frame = file.GetFrames().at(0);
+  const CXBTFFrame& frame = file->GetFrames().at(0);
   if (!ConvertFrameToTexture(Filename, frame, ppTexture))
   {
     return false;
@@ -176,20 +175,20 @@ int CTextureBundleXBT::LoadAnim(const std::string& Filename, CBaseTexture*** ppT
 {
   std::string name = Normalize(Filename);
 
-  CXBTFFile file;
-  if (!m_XBTFReader->Get(name, file))
+  const CXBTFFile* file = m_XBTFReader->Find(name);
+  if (file == nullptr)
     return false;
 
-  if (file.GetFrames().empty())
+  if (file->GetFrames().empty())
     return false;
 
-  size_t nTextures = file.GetFrames().size();
+  size_t nTextures = file->GetFrames().size();
   *ppTextures = new CBaseTexture*[nTextures];
   *ppDelays = new int[nTextures];
 
   for (size_t i = 0; i < nTextures; i++)
   {
-    CXBTFFrame& frame = file.GetFrames().at(i);
+    const CXBTFFrame& frame = file->GetFrames().at(i);
 
     if (!ConvertFrameToTexture(Filename, frame, &((*ppTextures)[i])))
     {
@@ -199,59 +198,47 @@ int CTextureBundleXBT::LoadAnim(const std::string& Filename, CBaseTexture*** ppT
     (*ppDelays)[i] = frame.GetDuration();
   }
 
-  width = file.GetFrames().at(0).GetWidth();
-  height = file.GetFrames().at(0).GetHeight();
-  nLoops = file.GetLoop();
+  width = file->GetFrames().at(0).GetWidth();
+  height = file->GetFrames().at(0).GetHeight();
+  nLoops = file->GetLoop();
 
   return nTextures;
 }
 
-bool CTextureBundleXBT::ConvertFrameToTexture(const std::string& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
+bool CTextureBundleXBT::ConvertFrameToTexture(const std::string& name, const CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
-  // found texture - allocate the necessary buffers
-  unsigned char *buffer = new unsigned char [(size_t)frame.GetPackedSize()];
-  if (buffer == NULL)
+  // the compressed texture, straight from the mapped bundle if possible
+  std::unique_ptr<unsigned char[]> buffer;
+  const unsigned char* data = m_XBTFReader->GetData(frame);
+  if (data == nullptr)
   {
-    CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
-    return false;
-  }
-
-  // load the compressed texture
-  if (!m_XBTFReader->Load(frame, buffer))
-  {
-    CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
-    delete[] buffer;
-    return false;
+    buffer.reset(new unsigned char[static_cast<size_t>(frame.GetPackedSize())]);
+    if (!m_XBTFReader->Load(frame, buffer.get()))
+    {
+      CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
+      return false;
+    }
+    data = buffer.get();
   }
 
   // check if it's packed with lzo
+  std::unique_ptr<unsigned char[]> unpacked;
   if (frame.IsPacked())
   { // unpack
-    unsigned char *unpacked = new unsigned char[(size_t)frame.GetUnpackedSize()];
-    if (unpacked == NULL)
-    {
-      CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %" PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
-      delete[] buffer;
-      return false;
-    }
+    unpacked.reset(new unsigned char[static_cast<size_t>(frame.GetUnpackedSize())]);
     lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
-    if (lzo1x_decompress_safe(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
+    if (lzo1x_decompress_safe(data, (lzo_uint)frame.GetPackedSize(), unpacked.get(), &s, NULL) != LZO_E_OK ||
         s != frame.GetUnpackedSize())
     {
       CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
-      delete[] buffer;
-      delete[] unpacked;
       return false;
     }
-    delete[] buffer;
-    buffer = unpacked;
+    data = unpacked.get();
   }
 
   // create an xbmc texture
   *ppTexture = new CTexture();
-  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), buffer);
-
-  delete[] buffer;
+  (*ppTexture)->LoadFromMemory(frame.GetWidth(), frame.GetHeight(), 0, frame.GetFormat(), frame.HasAlpha(), data);
 
   return true;
 }
@@ -276,6 +263,23 @@ std::string CTextureBundleXBT::Normalize(const std::string &name)
 
 uint8_t* CTextureBundleXBT::UnpackFrame(const CXBTFReader& reader, const CXBTFFrame& frame)
 {
+  // a packed frame of a mapped bundle is unpacked straight from memory
+  const uint8_t* data = reader.GetData(frame);
+  if (data != nullptr && frame.IsPacked())
+  {
+    uint8_t* unpackedBuffer = new uint8_t[static_cast<size_t>(frame.GetUnpackedSize())];
+    lzo_uint size = static_cast<lzo_uint>(frame.GetUnpackedSize());
+    if (lzo_init() != LZO_E_OK ||
+        lzo1x_decompress_safe(data, static_cast<lzo_uint>(frame.GetPackedSize()), unpackedBuffer, &size, nullptr) != LZO_E_OK ||
+        size != frame.GetUnpackedSize())
+    {
+      CLog::Log(LOGERROR, "CTextureBundleXBT: failed to decompress frame with %" PRIu64" unpacked bytes to %" PRIu64" bytes", frame.GetPackedSize(), frame.GetUnpackedSize());
+      delete[] unpackedBuffer;
+      return nullptr;
+    }
+    return unpackedBuffer;
+  }
+
   uint8_t* packedBuffer = new uint8_t[static_cast<size_t>(frame.GetPackedSize())];
   if (packedBuffer == nullptr)
   {
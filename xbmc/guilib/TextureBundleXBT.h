@@ -37,12 +37,18 @@ public:
                 int &width, int &height, int& nLoops, int** ppDelays);
 
   static uint8_t* UnpackFrame(const CXBTFReader& reader, const CXBTFFrame& frame);
+
+  /*!
+   \brief Path of the skin's texture bundle, or of its theme's one
+   \return empty if the theme bundle isn't used
+   */
+  static std::string GetBundlePath(bool themeBundle);
   
   void CloseBundle();
 
 private:
   bool OpenBundle();
-  bool ConvertFrameToTexture(const std::string& name, CXBTFFrame& frame, CBaseTexture** ppTexture);
+  bool ConvertFrameToTexture(const std::string& name, const CXBTFFrame& frame, CBaseTexture** ppTexture);
 
   time_t m_TimeStamp;
 
@@ -13,11 +13,13 @@
 #include "addons/Skin.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "filesystem/XbtManager.h"
 #include "windowing/GraphicContext.h"
 #include "Texture.h"
 #include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "URL.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
@@ -520,6 +522,22 @@ void CGUITextureManager::ReleaseHwTexture(unsigned int texture)
   m_unusedHwTextures.push_back(texture);
 }
 
+void CGUITextureManager::PreloadBundles()
+{
+  for (bool themeBundle : { true, false })
+  {
+    const std::string path = CTextureBundleXBT::GetBundlePath(themeBundle);
+    if (path.empty())
+      continue;
+
+    // the manager keeps the reader, the bundles get it from there when opened
+    CJobManager::GetInstance().Submit([path]() {
+      CXBTFReaderPtr reader;
+      XFILE::CXbtManager::GetInstance().GetReader(CURL(path), reader);
+    }, CJob::PRIORITY_HIGH);
+  }
+}
+
 void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
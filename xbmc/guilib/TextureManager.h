@@ -97,6 +97,7 @@ public:
   const CTextureArray& Load(const std::string& strTextureName, bool checkBundleOnly = false);
   void ReleaseTexture(const std::string& strTextureName, bool immediately = false);
   void Cleanup();
+  void PreloadBundles(); ///< Open the skin's texture bundles on jobs, so their index is read by the time textures are loaded
   void Dump() const;
   uint32_t GetMemoryUsage() const;
   void Flush();
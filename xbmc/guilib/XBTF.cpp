@@ -8,6 +8,7 @@
 
 #include "XBTF.h"
 
+#include <algorithm>
 #include <cstring>
 #include <utility>
 
@@ -195,20 +196,28 @@ uint64_t CXBTFBase::GetHeaderSize() const
 
 bool CXBTFBase::Exists(const std::string& name) const
 {
-  CXBTFFile dummy;
-  return Get(name, dummy);
+  return Find(name) != nullptr;
 }
 
 bool CXBTFBase::Get(const std::string& name, CXBTFFile& file) const
 {
-  const auto& iter = m_files.find(name);
-  if (iter == m_files.end())
+  const CXBTFFile* found = Find(name);
+  if (found == nullptr)
     return false;
 
-  file = iter->second;
+  file = *found;
   return true;
 }
 
+const CXBTFFile* CXBTFBase::Find(const std::string& name) const
+{
+  const auto& iter = m_files.find(name);
+  if (iter == m_files.end())
+    return nullptr;
+
+  return &iter->second;
+}
+
 std::vector<CXBTFFile> CXBTFBase::GetFiles() const
 {
   std::vector<CXBTFFile> files;
@@ -217,6 +226,11 @@ std::vector<CXBTFFile> CXBTFBase::GetFiles() const
   for (const auto& file : m_files)
     files.push_back(file.second);
 
+  // keep the order of the header written by TexturePacker stable
+  std::sort(files.begin(), files.end(), [](const CXBTFFile& a, const CXBTFFile& b) {
+    return a.GetPath() < b.GetPath();
+  });
+
   return files;
 }
 
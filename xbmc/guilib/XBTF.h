@@ -11,6 +11,7 @@
 #include <ctime>
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <stdint.h>
@@ -97,6 +98,9 @@ public:
 
   bool Exists(const std::string& name) const;
   bool Get(const std::string& name, CXBTFFile& file) const;
+  //! the file without copying it, valid until the files change
+  const CXBTFFile* Find(const std::string& name) const;
+  //! all files, ordered by path
   std::vector<CXBTFFile> GetFiles() const;
   void AddFile(const CXBTFFile& file);
   void UpdateFile(const CXBTFFile& file);
@@ -104,5 +108,5 @@ public:
 protected:
   CXBTFBase() = default;
 
-  std::map<std::string, CXBTFFile> m_files;
+  std::unordered_map<std::string, CXBTFFile> m_files;
 };
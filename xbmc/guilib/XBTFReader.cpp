@@ -12,6 +12,8 @@
 #include <sys/stat.h>
 
 #include "XBTFReader.h"
+#include "filesystem/File.h"
+#include "filesystem/IFile.h"
 #include "guilib/XBTF.h"
 #include "utils/EndianSwap.h"
 
@@ -164,6 +166,10 @@ bool CXBTFReader::Open(const std::string& path)
   if (pos != GetHeaderSize())
     return false;
 
+  // textures are then a pointer into the mapped bundle instead of a seek and read each
+  XFILE::CFile file;
+  m_view = file.MapFile(m_path);
+
   return true;
 }
 
@@ -180,6 +186,7 @@ void CXBTFReader::Close()
     m_file = nullptr;
   }
 
+  m_view.reset();
   m_path.clear();
   m_files.clear();
 }
@@ -196,11 +203,28 @@ time_t CXBTFReader::GetLastModificationTimestamp() const
   return fileStat.st_mtime;
 }
 
+const unsigned char* CXBTFReader::GetData(const CXBTFFrame& frame) const
+{
+  if (!m_view || frame.GetOffset() > m_view->GetSize() ||
+      frame.GetPackedSize() > m_view->GetSize() - frame.GetOffset())
+    return nullptr;
+
+  return m_view->GetData() + frame.GetOffset();
+}
+
 bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer) const
 {
+  const unsigned char* data = GetData(frame);
+  if (data != nullptr)
+  {
+    memcpy(buffer, data, static_cast<size_t>(frame.GetPackedSize()));
+    return true;
+  }
+
   if (m_file == nullptr)
     return false;
 
+  std::unique_lock<std::mutex> lock(m_fileLock);
 #if defined(TARGET_DARWIN) || defined(TARGET_FREEBSD)
   if (fseeko(m_file, static_cast<off_t>(frame.GetOffset()), SEEK_SET) == -1)
 #elif defined(TARGET_ANDROID)
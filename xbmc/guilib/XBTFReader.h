@@ -11,10 +11,16 @@
 #include "XBTF.h"
 
 #include <memory>
+#include <mutex>
 #include <stdint.h>
 #include <string>
 #include <vector>
 
+namespace XFILE
+{
+class IFileView;
+}
+
 class CXBTFReader : public CXBTFBase
 {
 public:
@@ -29,9 +35,17 @@ public:
 
   bool Load(const CXBTFFrame& frame, unsigned char* buffer) const;
 
+  /*!
+   \brief Packed data of a frame without copying it
+   \return nullptr if the bundle couldn't be mapped into memory, use Load() then
+   */
+  const unsigned char* GetData(const CXBTFFrame& frame) const;
+
 private:
   std::string m_path;
   FILE* m_file = nullptr;
+  mutable std::mutex m_fileLock; //!< seek and read of Load() from several threads
+  std::unique_ptr<XFILE::IFileView> m_view; //!< the whole bundle, if it's a local file
 };
 
 typedef std::shared_ptr<CXBTFReader> CXBTFReaderPtr;
@@ -671,6 +671,14 @@
 #define PLAYER_PROCESS_AUDIOCHANNELS (PLAYER_PROCESS + 9)
 #define PLAYER_PROCESS_AUDIOSAMPLERATE (PLAYER_PROCESS + 10)
 #define PLAYER_PROCESS_AUDIOBITSPERSAMPLE (PLAYER_PROCESS + 11)
+#define PLAYER_PROCESS_AUDIORESAMPLETIME (PLAYER_PROCESS + 12)
+#define PLAYER_PROCESS_AUDIOMIXTIME (PLAYER_PROCESS + 13)
+#define PLAYER_PROCESS_AUDIOENCODETIME (PLAYER_PROCESS + 14)
+#define PLAYER_PROCESS_AUDIOSINKTIME (PLAYER_PROCESS + 15)
+#define PLAYER_PROCESS_AUDIOSINKDRIFT (PLAYER_PROCESS + 16)
+#define PLAYER_PROCESS_DEMUXPACKETS (PLAYER_PROCESS + 17)
+#define PLAYER_PROCESS_DEMUXCOPYRATE (PLAYER_PROCESS + 18)
+#define PLAYER_PROCESS_VIDEOBUFFERS (PLAYER_PROCESS + 19)
 
 #define WINDOW_PROPERTY             9993
 #define WINDOW_IS_VISIBLE           9995
@@ -332,6 +332,36 @@ bool CPlayerGUIInfo::GetLabel(std::string& value, const CFileItem *item, int con
     case PLAYER_PROCESS_AUDIOBITSPERSAMPLE:
       value = StringUtils::FormatNumber(CServiceBroker::GetDataCacheCore().GetAudioBitsPerSample());
       return true;
+    case PLAYER_PROCESS_AUDIORESAMPLETIME:
+      value = GetAudioEngineTiming(CDataCacheCore::AE_STAGE_RESAMPLE);
+      return true;
+    case PLAYER_PROCESS_AUDIOMIXTIME:
+      value = GetAudioEngineTiming(CDataCacheCore::AE_STAGE_MIX);
+      return true;
+    case PLAYER_PROCESS_AUDIOENCODETIME:
+      value = GetAudioEngineTiming(CDataCacheCore::AE_STAGE_ENCODE);
+      return true;
+    case PLAYER_PROCESS_AUDIOSINKTIME:
+      value = GetAudioEngineTiming(CDataCacheCore::AE_STAGE_SINKWRITE);
+      return true;
+    case PLAYER_PROCESS_AUDIOSINKDRIFT:
+      value = GetAudioEngineTiming(CDataCacheCore::AE_STAGE_SINKDRIFT);
+      return true;
+    case PLAYER_PROCESS_DEMUXPACKETS:
+    {
+      const CDataCacheCore::SDemuxPacketStats stats = CServiceBroker::GetDataCacheCore().GetDemuxPacketStats();
+      value = StringUtils::Format("%u / %u / %u /s", stats.allocations, stats.reused, stats.wrapped);
+      return true;
+    }
+    case PLAYER_PROCESS_DEMUXCOPYRATE:
+      value = StringUtils::Format("%.1f MB/s", CServiceBroker::GetDataCacheCore().GetDemuxPacketStats().copyBytes / (1024.0 * 1024.0));
+      return true;
+    case PLAYER_PROCESS_VIDEOBUFFERS:
+    {
+      const CDataCacheCore::SVideoBufferStats stats = CServiceBroker::GetDataCacheCore().GetVideoBufferStats();
+      value = StringUtils::Format("%u / %u (%.1f MB)", stats.used, stats.buffers, stats.bytes / (1024.0 * 1024.0));
+      return true;
+    }
 
     ///////////////////////////////////////////////////////////////////////////////////////////////
     // PLAYLIST_*
@@ -629,6 +659,19 @@ std::string CPlayerGUIInfo::GetContentRanges(int iInfo) const
   return values;
 }
 
+std::string CPlayerGUIInfo::GetAudioEngineTiming(int stage) const
+{
+  const CDataCacheCore::SAudioEngineTiming timing = CServiceBroker::GetDataCacheCore().GetAudioEngineTiming(
+      static_cast<CDataCacheCore::AudioEngineStage>(stage));
+
+  if (timing.count == 0)
+    return std::string();
+
+  // median / 99th percentile / max in ms
+  return StringUtils::Format("%.2f / %.2f / %.2f ms", timing.median / 1000.0, timing.p99 / 1000.0,
+                             timing.max / 1000.0);
+}
+
 std::vector<std::pair<float, float>> CPlayerGUIInfo::GetCutList(CDataCacheCore& data, time_t duration) const
 {
   std::vector<std::pair<float, float>> ranges;
@@ -66,6 +66,7 @@ private:
   std::string GetSeekTime(TIME_FORMAT format) const;
 
   std::string GetContentRanges(int iInfo) const;
+  std::string GetAudioEngineTiming(int stage) const;
   std::vector<std::pair<float, float>> GetCutList(CDataCacheCore& data, time_t duration) const;
   std::vector<std::pair<float, float>> GetChapters(CDataCacheCore& data, time_t duration) const;
 };
@@ -0,0 +1,79 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/DirtyRegionSolvers.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const CRect VIEWPORT(0.0f, 0.0f, 1920.0f, 1080.0f);
+}
+
+TEST(TestDirtyRegionSolvers, TilesEmpty)
+{
+  CTileDirtyRegionSolver solver(VIEWPORT);
+  CDirtyRegionList input;
+  input.emplace_back(10.0f, 10.0f, 10.0f, 20.0f);
+  CDirtyRegionList output;
+  solver.Solve(input, output);
+  EXPECT_TRUE(output.empty());
+}
+
+TEST(TestDirtyRegionSolvers, TilesAdjacent)
+{
+  // regions across neighbouring tiles are rendered in one pass of their bounds
+  CTileDirtyRegionSolver solver(VIEWPORT);
+  CDirtyRegionList input;
+  input.emplace_back(10.0f, 10.0f, 100.0f, 30.0f);
+  input.emplace_back(100.0f, 10.0f, 150.0f, 30.0f);
+  CDirtyRegionList output;
+  solver.Solve(input, output);
+  ASSERT_EQ(1u, output.size());
+  EXPECT_EQ(CRect(10.0f, 10.0f, 150.0f, 30.0f), output[0]);
+}
+
+TEST(TestDirtyRegionSolvers, TilesDistant)
+{
+  // merging would render the whole screen between two small corner regions
+  CTileDirtyRegionSolver solver(VIEWPORT);
+  CDirtyRegionList input;
+  input.emplace_back(0.0f, 0.0f, 20.0f, 20.0f);
+  input.emplace_back(1900.0f, 1060.0f, 1920.0f, 1080.0f);
+  CDirtyRegionList output;
+  solver.Solve(input, output);
+  ASSERT_EQ(2u, output.size());
+  EXPECT_EQ(CRect(0.0f, 0.0f, 20.0f, 20.0f), output[0]);
+  EXPECT_EQ(CRect(1900.0f, 1060.0f, 1920.0f, 1080.0f), output[1]);
+}
+
+TEST(TestDirtyRegionSolvers, TilesClose)
+{
+  // small regions a tile apart cost less in one pass than in two
+  CTileDirtyRegionSolver solver(VIEWPORT);
+  CDirtyRegionList input;
+  input.emplace_back(0.0f, 0.0f, 10.0f, 4.0f);
+  input.emplace_back(130.0f, 0.0f, 140.0f, 4.0f);
+  CDirtyRegionList output;
+  solver.Solve(input, output);
+  ASSERT_EQ(1u, output.size());
+  EXPECT_EQ(CRect(0.0f, 0.0f, 140.0f, 4.0f), output[0]);
+}
+
+TEST(TestDirtyRegionSolvers, TilesOffscreen)
+{
+  // only the visible part of a region sliding in from far outside is rendered
+  CTileDirtyRegionSolver solver(VIEWPORT);
+  CDirtyRegionList input;
+  input.emplace_back(-100000.0f, 100.0f, 50.0f, 120.0f);
+  input.emplace_back(0.0f, 5000.0f, 1920.0f, 6000.0f);
+  CDirtyRegionList output;
+  solver.Solve(input, output);
+  ASSERT_EQ(1u, output.size());
+  EXPECT_EQ(CRect(0.0f, 100.0f, 50.0f, 120.0f), output[0]);
+}
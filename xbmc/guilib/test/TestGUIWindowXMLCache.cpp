@@ -0,0 +1,179 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/GUIIncludes.h"
+#include "guilib/GUIWindowXMLCache.h"
+#include "test/TestUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+const std::string WINDOW_XML =
+  "<window id=\"1100\">"
+  "<defaultcontrol always=\"true\">9000</defaultcontrol>"
+  "<controls>"
+  "<control type=\"label\" id=\"2\">"
+  "<!-- a comment -->"
+  "<label>$INFO[System.Time]</label>"
+  "<visible>!Player.HasVideo + Skin.HasSetting(foo)</visible>"
+  "<onclick><![CDATA[SetProperty(a,<b>)]]></onclick>"
+  "</control>"
+  "</controls>"
+  "</window>";
+
+std::string Print(const TiXmlElement& element)
+{
+  std::string printed;
+  printed << element;
+  return printed;
+}
+
+// Include conditions and include files need a running GUI and skin, so they
+// are dropped and every conditional include is taken.
+void StripConditions(TiXmlElement& element)
+{
+  TiXmlElement* child = element.FirstChildElement();
+  while (child)
+  {
+    TiXmlElement* next = child->NextSiblingElement();
+    if (child->ValueStr() == "include" && child->Attribute("file"))
+      element.RemoveChild(child);
+    else
+    {
+      if (child->ValueStr() == "include")
+        child->RemoveAttribute("condition");
+      StripConditions(*child);
+    }
+    child = next;
+  }
+}
+
+bool CopyStripped(const std::string& file, const std::string& copy)
+{
+  CXBMCTinyXML doc;
+  if (!doc.LoadFile(file))
+    return false;
+  StripConditions(*doc.RootElement());
+  return doc.SaveFile(copy);
+}
+} // namespace
+
+TEST(TestGUIWindowXMLCache, RoundTrip)
+{
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.Parse(WINDOW_XML));
+
+  std::string data;
+  CGUIWindowXMLCache::Serialize(*doc.RootElement(), data);
+  std::unique_ptr<TiXmlElement> root = CGUIWindowXMLCache::Deserialize(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+  ASSERT_TRUE(root);
+
+  // all but the comment
+  TiXmlNode* control = doc.RootElement()->FirstChildElement("controls")->FirstChildElement("control");
+  control->RemoveChild(control->FirstChild());
+  EXPECT_EQ(Print(*doc.RootElement()), Print(*root));
+
+  const TiXmlElement* onclick = root->FirstChildElement("controls")->FirstChildElement("control")->FirstChildElement("onclick");
+  ASSERT_TRUE(onclick && onclick->FirstChild());
+  EXPECT_TRUE(onclick->FirstChild()->ToText()->CDATA());
+  EXPECT_STREQ("SetProperty(a,<b>)", onclick->GetText());
+}
+
+TEST(TestGUIWindowXMLCache, Truncated)
+{
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.Parse(WINDOW_XML));
+
+  std::string data;
+  CGUIWindowXMLCache::Serialize(*doc.RootElement(), data);
+  for (size_t size = 0; size < data.size(); size += 7)
+    EXPECT_FALSE(CGUIWindowXMLCache::Deserialize(reinterpret_cast<const uint8_t*>(data.data()), size));
+}
+
+TEST(TestGUIWindowXMLCache, Benchmark)
+{
+  // Estuary's home window loaded the way CGUIWindow::LoadXML() does, parsed
+  // with its includes resolved and taken from the cache. The times are
+  // recorded as test properties, --gtest_output=xml keeps them for comparing
+  // releases.
+  const std::string skinPath = XBMC_REF_FILE_PATH("addons/skin.estuary/xml/");
+  const std::string tempPath = "special://temp/";
+
+  CXBMCTinyXML includesDoc;
+  ASSERT_TRUE(includesDoc.LoadFile(skinPath + "Includes.xml"));
+  std::vector<std::string> files = { "Includes.xml" };
+  for (const TiXmlElement* include = includesDoc.RootElement()->FirstChildElement("include");
+       include; include = include->NextSiblingElement("include"))
+  {
+    if (include->Attribute("file"))
+      files.push_back(include->Attribute("file"));
+  }
+
+  CGUIIncludes includes;
+  for (const auto& file : files)
+  {
+    ASSERT_TRUE(CopyStripped(skinPath + file, tempPath + file));
+    includes.Load(tempPath + file);
+  }
+  const std::string window = tempPath + "Home.xml";
+  ASSERT_TRUE(CopyStripped(skinPath + "Home.xml", window));
+
+  const int loads = 20;
+  std::map<INFO::InfoPtr, bool> conditions;
+  std::unique_ptr<TiXmlElement> resolved;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < loads; i++)
+  {
+    CXBMCTinyXML doc;
+    ASSERT_TRUE(doc.LoadFile(window));
+    resolved.reset(static_cast<TiXmlElement*>(doc.RootElement()->Clone()));
+    includes.Resolve(resolved.get(), &conditions);
+  }
+  const auto uncached = std::chrono::steady_clock::now() - start;
+
+  // written in the background
+  CGUIWindowXMLCache cache;
+  cache.SetStamp("benchmark");
+  cache.Set(window, *resolved, conditions);
+  std::unique_ptr<TiXmlElement> cached;
+  for (int wait = 0; wait < 100 && !cached; wait++)
+  {
+    cached = cache.Get(window, conditions);
+    if (!cached)
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  ASSERT_TRUE(cached);
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < loads; i++)
+  {
+    cached = cache.Get(window, conditions);
+    ASSERT_TRUE(cached);
+  }
+  const auto fromCache = std::chrono::steady_clock::now() - start;
+
+  std::string expected;
+  std::string data;
+  CGUIWindowXMLCache::Serialize(*resolved, expected);
+  CGUIWindowXMLCache::Serialize(*cached, data);
+  EXPECT_EQ(expected, data);
+
+  auto usPerLoad = [loads](std::chrono::steady_clock::duration elapsed) {
+    return static_cast<int>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() / loads);
+  };
+  RecordProperty("uncached_us_per_load", usPerLoad(uncached));
+  RecordProperty("cached_us_per_load", usPerLoad(fromCache));
+}
@@ -12,13 +12,15 @@
 
 namespace INFO
 {
-  InfoBool::InfoBool(const std::string &expression, int context, unsigned int &refreshCounter)
+  InfoBool::InfoBool(const std::string &expression, int context, InfoRefresh &refresh)
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
       m_expression(expression),
-      m_refreshCounter(0),
-      m_parentRefreshCounter(refreshCounter)
+      m_sources(INFO_SOURCE_FRAME),
+      m_updated(false),
+      m_version(0),
+      m_refresh(refresh)
   {
     StringUtils::ToLower(m_expression);
   }
@@ -15,6 +15,55 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief Sources of the info that conditions are evaluated from
+ */
+enum InfoSource
+{
+  INFO_SOURCE_FRAME         = 1 << 0, ///< not reporting its changes, refreshed every frame
+  INFO_SOURCE_SKIN_SETTINGS = 1 << 1, ///< skin settings, refreshed when one is set
+  INFO_SOURCE_ALL           = INFO_SOURCE_FRAME | INFO_SOURCE_SKIN_SETTINGS
+};
+
+/*!
+ \ingroup info
+ \brief Versions of the info sources, shared by all info bools of the info manager
+
+ An info bool is only evaluated again once a source it depends on changed,
+ a condition depending on no source at all is evaluated once.
+ */
+class InfoRefresh
+{
+public:
+  void SetDirty(unsigned int sources)
+  {
+    for (unsigned int i = 0; i < SOURCE_COUNT; i++)
+    {
+      if (sources & (1 << i))
+        ++m_versions[i];
+    }
+  }
+
+  //! changes whenever one of the sources changes, the versions only grow
+  unsigned int GetVersion(unsigned int sources) const
+  {
+    unsigned int version = 0;
+    for (unsigned int i = 0; i < SOURCE_COUNT; i++)
+    {
+      if (sources & (1 << i))
+        version += m_versions[i];
+    }
+    return version;
+  }
+
+  unsigned int m_evaluations = 0; ///< evaluations since the last refresh of the frame source
+
+private:
+  static const unsigned int SOURCE_COUNT = 2;
+  unsigned int m_versions[SOURCE_COUNT] = {};
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -22,7 +71,7 @@ namespace INFO
 class InfoBool
 {
 public:
-  InfoBool(const std::string &expression, int context, unsigned int &refreshCounter);
+  InfoBool(const std::string &expression, int context, InfoRefresh &refresh);
   virtual ~InfoBool() = default;
 
   virtual void Initialize() {};
@@ -34,11 +83,20 @@ public:
   inline bool Get(const CGUIListItem *item = NULL)
   {
     if (item && m_listItemDependent)
+    {
       Update(item);
-    else if (m_refreshCounter != m_parentRefreshCounter || m_refreshCounter == 0)
+      m_refresh.m_evaluations++;
+    }
+    else
     {
-      Update(NULL);
-      m_refreshCounter = m_parentRefreshCounter;
+      const unsigned int version = m_refresh.GetVersion(m_sources);
+      if (!m_updated || version != m_version)
+      {
+        Update(NULL);
+        m_refresh.m_evaluations++;
+        m_version = version;
+        m_updated = true;
+      }
     }
     return m_value;
   }
@@ -66,16 +124,20 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+  //! the InfoSource flags this info bool depends on
+  unsigned int GetSources() const { return m_sources; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
   std::string  m_expression;   ///< original expression
+  unsigned int m_sources;      ///< sources the value is evaluated from, set by Initialize()
 
 private:
-  unsigned int m_refreshCounter;
-  unsigned int &m_parentRefreshCounter;
+  bool m_updated;
+  unsigned int m_version;
+  InfoRefresh &m_refresh;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
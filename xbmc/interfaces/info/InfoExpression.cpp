@@ -13,6 +13,7 @@
 #include "guilib/GUIComponent.h"
 #include "utils/log.h"
 
+#include <algorithm>
 #include <list>
 #include <memory>
 #include <stack>
@@ -21,7 +22,9 @@ using namespace INFO;
 
 void InfoSingle::Initialize()
 {
-  m_condition = CServiceBroker::GetGUI()->GetInfoManager().TranslateSingleString(m_expression, m_listItemDependent);
+  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
+  m_condition = infoMgr.TranslateSingleString(m_expression, m_listItemDependent);
+  m_sources = infoMgr.GetInfoSources(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -31,26 +34,59 @@ void InfoSingle::Update(const CGUIListItem *item)
 
 void InfoExpression::Initialize()
 {
+  // the sources of the leaves are added while parsing
+  m_sources = 0;
   if (!Parse(m_expression))
   {
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", m_expression.c_str());
-    m_expression_tree = std::make_shared<InfoLeaf>(CServiceBroker::GetGUI()->GetInfoManager().Register("false", 0), false);
+    Compile(InfoLeaf(CServiceBroker::GetGUI()->GetInfoManager().Register("false", 0), false));
+    m_sources = 0;
   }
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  m_value = m_expression_tree->Evaluate(item);
+  m_value = Evaluate(0, item);
+}
+
+bool InfoExpression::Evaluate(unsigned int index, const CGUIListItem *item)
+{
+  const Node &node = m_nodes[index];
+  if (node.type == NODE_LEAF)
+    return node.invert ^ node.leaf->Get(item);
+
+  /* Handle either AND or OR by using the relation
+   * A AND B == !(!A OR !B)
+   * to convert ANDs into ORs
+   */
+  const bool use_and = (node.type == NODE_AND);
+  const unsigned int first = index + 1;
+  const unsigned int end = index + node.size;
+  for (unsigned int child = first; child < end; child += m_nodes[child].size)
+  {
+    if (use_and ^ Evaluate(child, item))
+    {
+      /* Move this child to the head of the group so we evaluate faster next time */
+      if (child != first)
+        std::rotate(m_nodes.begin() + first, m_nodes.begin() + child,
+                    m_nodes.begin() + child + m_nodes[child].size);
+      return !use_and;
+    }
+  }
+  return use_and;
 }
 
 /* Expressions are rewritten at parse time into a form which favours the
- * formation of groups of associative nodes. These groups are then reordered at
- * evaluation time such that nodes whose value renders the evaluation of the
- * remainder of the group unnecessary tend to be evaluated first (these are
- * true nodes for OR subexpressions, or false nodes for AND subexpressions).
- * The end effect is to minimise the number of leaf nodes that need to be
- * evaluated in order to determine the value of the expression. The runtime
- * adaptability has the advantage of not being customised for any particular skin.
+ * formation of groups of associative nodes, and the resulting tree is then
+ * compiled into a flat vector of nodes in which the children of a group
+ * follow it. These groups are then reordered at evaluation time such that
+ * nodes whose value renders the evaluation of the remainder of the group
+ * unnecessary tend to be evaluated first (these are true nodes for OR
+ * subexpressions, or false nodes for AND subexpressions). The end effect is
+ * to minimise the number of leaf nodes that need to be evaluated in order to
+ * determine the value of the expression. The runtime adaptability has the
+ * advantage of not being customised for any particular skin, and pays off
+ * most for list item dependent leaves which are evaluated for every item.
  *
  * The modifications to the expression at parse time fall into two groups:
  * 1) Moving logical NOTs so that they are only applied to leaf nodes.
@@ -59,11 +95,16 @@ void InfoExpression::Update(const CGUIListItem *item)
  * 2) Combining adjacent AND or OR operations such that each path from the root
  *    to a leaf encounters a strictly alternating pattern of AND and OR
  *    operations. So [A|B]|[C|D+[[E|F]|G] becomes A|B|C|[D+[E|F|G]].
+ *
+ * Each node records the number of nodes of its subexpression, never the
+ * position of another node. Moving a child to the head of its group is then
+ * a rotation of the group's nodes, leaving all of them valid.
  */
 
-bool InfoExpression::InfoLeaf::Evaluate(const CGUIListItem *item)
+void InfoExpression::InfoLeaf::Compile(std::vector<Node> &nodes, std::vector<InfoPtr> &leaves) const
 {
-  return m_invert ^ m_info->Get(item);
+  nodes.push_back({NODE_LEAF, m_invert, 1, m_info.get()});
+  leaves.push_back(m_info);
 }
 
 InfoExpression::InfoAssociativeGroup::InfoAssociativeGroup(
@@ -86,27 +127,25 @@ void InfoExpression::InfoAssociativeGroup::Merge(std::shared_ptr<InfoAssociative
   m_children.splice(m_children.end(), other->m_children);
 }
 
-bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
+void InfoExpression::InfoAssociativeGroup::Compile(std::vector<Node> &nodes, std::vector<InfoPtr> &leaves) const
 {
-  /* Handle either AND or OR by using the relation
-   * A AND B == !(!A OR !B)
-   * to convert ANDs into ORs
-   */
-  std::list<InfoSubexpressionPtr>::iterator last = m_children.end();
-  std::list<InfoSubexpressionPtr>::iterator it = m_children.begin();
-  bool use_and = (m_type == NODE_AND);
-  bool result = use_and ^ (*it)->Evaluate(item);
-  while (!result && ++it != last)
-  {
-    result = use_and ^ (*it)->Evaluate(item);
-    if (result)
-    {
-      /* Move this child to the head of the list so we evaluate faster next time */
-      m_children.push_front(*it);
-      m_children.erase(it);
-    }
-  }
-  return use_and ^ result;
+  const unsigned int index = nodes.size();
+  nodes.push_back({m_type, false, 0, nullptr});
+  for (const auto &child : m_children)
+    child->Compile(nodes, leaves);
+  nodes[index].size = nodes.size() - index;
+}
+
+void InfoExpression::Compile(const InfoSubexpression &tree)
+{
+  m_nodes.clear();
+  m_leaves.clear();
+  tree.Compile(m_nodes, m_leaves);
+}
+
+InfoPtr InfoExpression::RegisterOperand(const std::string &operand)
+{
+  return CServiceBroker::GetGUI()->GetInfoManager().Register(operand, m_context);
 }
 
 /* Expressions are parsed using the shunting-yard algorithm. Binary operators
@@ -208,8 +247,6 @@ bool InfoExpression::Parse(const std::string &expression)
   bool after_binaryoperator = true;
   int bracket_count = 0;
 
-  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
-
   char c;
   // Skip leading whitespace - don't want it to count as an operand if that's all there is
   while (isspace((unsigned char)(c=*s)))
@@ -236,14 +273,15 @@ bool InfoExpression::Parse(const std::string &expression)
       }
       if (!operand.empty())
       {
-        InfoPtr info = infoMgr.Register(operand, m_context);
+        InfoPtr info = RegisterOperand(operand);
         if (!info)
         {
           CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
           return false;
         }
-        /* Propagate any listItem dependency from the operand to the expression */
+        /* Propagate any listItem dependency and the sources from the operand to the expression */
         m_listItemDependent |= info->ListItemDependent();
+        m_sources |= info->GetSources();
         nodes.push(std::make_shared<InfoLeaf>(info, invert));
         /* Reuse operand string for next operand */
         operand.clear();
@@ -287,19 +325,20 @@ bool InfoExpression::Parse(const std::string &expression)
   }
   if (!operand.empty())
   {
-    InfoPtr info = infoMgr.Register(operand, m_context);
+    InfoPtr info = RegisterOperand(operand);
     if (!info)
     {
       CLog::Log(LOGERROR, "Bad operand '%s'", operand.c_str());
       return false;
     }
-    /* Propagate any listItem dependency from the operand to the expression */
+    /* Propagate any listItem dependency and the sources from the operand to the expression */
     m_listItemDependent |= info->ListItemDependent();
+    m_sources |= info->GetSources();
     nodes.push(std::make_shared<InfoLeaf>(info, invert));
   }
   while (!operator_stack.empty())
     OperatorPop(operator_stack, invert, nodes);
 
-  m_expression_tree = nodes.top();
+  Compile(*nodes.top());
   return true;
 }
@@ -23,8 +23,8 @@ namespace INFO
 class InfoSingle : public InfoBool
 {
 public:
-  InfoSingle(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoSingle(const std::string &expression, int context, InfoRefresh &refresh)
+    : InfoBool(expression, context, refresh) {};
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
@@ -37,13 +37,18 @@ private:
 class InfoExpression : public InfoBool
 {
 public:
-  InfoExpression(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoExpression(const std::string &expression, int context, InfoRefresh &refresh)
+    : InfoBool(expression, context, refresh) {};
   ~InfoExpression() override = default;
 
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
+protected:
+  /*! \brief Look up an operand of the expression, at the info manager by default
+   \return the info bool of the operand, or nullptr if it is not valid
+   */
+  virtual InfoPtr RegisterOperand(const std::string &operand);
 private:
   typedef enum
   {
@@ -62,12 +67,21 @@ private:
     NODE_OR,
   } node_type_t;
 
-  // An abstract base class for nodes in the expression tree
+  // A node of the compiled expression, the nodes of a group's children follow it
+  struct Node
+  {
+    node_type_t type;
+    bool invert;       // of a leaf
+    unsigned int size; // number of nodes of the subexpression, 1 for a leaf
+    InfoBool *leaf;
+  };
+
+  // An abstract base class for nodes in the expression tree, only used while parsing
   class InfoSubexpression
   {
   public:
     virtual ~InfoSubexpression(void) = default; // so we can destruct derived classes using a pointer to their base class
-    virtual bool Evaluate(const CGUIListItem *item) = 0;
+    virtual void Compile(std::vector<Node> &nodes, std::vector<InfoPtr> &leaves) const = 0;
     virtual node_type_t Type() const=0;
   };
 
@@ -78,7 +92,7 @@ private:
   {
   public:
     InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
-    bool Evaluate(const CGUIListItem *item) override;
+    void Compile(std::vector<Node> &nodes, std::vector<InfoPtr> &leaves) const override;
     node_type_t Type() const override { return NODE_LEAF; };
   private:
     InfoPtr m_info;
@@ -92,7 +106,7 @@ private:
     InfoAssociativeGroup(node_type_t type, const InfoSubexpressionPtr &left, const InfoSubexpressionPtr &right);
     void AddChild(const InfoSubexpressionPtr &child);
     void Merge(std::shared_ptr<InfoAssociativeGroup> other);
-    bool Evaluate(const CGUIListItem *item) override;
+    void Compile(std::vector<Node> &nodes, std::vector<InfoPtr> &leaves) const override;
     node_type_t Type() const override { return m_type; };
   private:
     node_type_t m_type;
@@ -102,7 +116,11 @@ private:
   static operator_t GetOperator(char ch);
   static void OperatorPop(std::stack<operator_t> &operator_stack, bool &invert, std::stack<InfoSubexpressionPtr> &nodes);
   bool Parse(const std::string &expression);
-  InfoSubexpressionPtr m_expression_tree;
+  void Compile(const InfoSubexpression &tree);
+  bool Evaluate(unsigned int index, const CGUIListItem *item);
+
+  std::vector<Node> m_nodes;
+  std::vector<InfoPtr> m_leaves; ///< owners of the leaves of the nodes
 };
 
 };
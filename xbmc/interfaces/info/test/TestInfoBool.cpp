@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "interfaces/info/InfoBool.h"
+
+#include <gtest/gtest.h>
+
+using namespace INFO;
+
+namespace
+{
+class CountingInfoBool : public InfoBool
+{
+public:
+  CountingInfoBool(unsigned int sources, InfoRefresh& refresh)
+    : InfoBool("test", 0, refresh)
+  {
+    m_sources = sources;
+  }
+
+  void Update(const CGUIListItem* item) override
+  {
+    m_value = !m_value;
+    m_updates++;
+  }
+
+  unsigned int m_updates = 0;
+};
+} // namespace
+
+TEST(TestInfoBool, FrameSource)
+{
+  InfoRefresh refresh;
+  CountingInfoBool info(INFO_SOURCE_FRAME, refresh);
+
+  EXPECT_TRUE(info.Get());
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ(1u, info.m_updates);
+
+  refresh.SetDirty(INFO_SOURCE_FRAME);
+  EXPECT_FALSE(info.Get());
+  EXPECT_EQ(2u, info.m_updates);
+
+  refresh.SetDirty(INFO_SOURCE_SKIN_SETTINGS);
+  EXPECT_FALSE(info.Get());
+  EXPECT_EQ(2u, info.m_updates);
+  EXPECT_EQ(2u, refresh.m_evaluations);
+}
+
+TEST(TestInfoBool, SkinSettingsSource)
+{
+  InfoRefresh refresh;
+  CountingInfoBool info(INFO_SOURCE_SKIN_SETTINGS, refresh);
+
+  EXPECT_TRUE(info.Get());
+  refresh.SetDirty(INFO_SOURCE_FRAME);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ(1u, info.m_updates);
+
+  refresh.SetDirty(INFO_SOURCE_SKIN_SETTINGS);
+  EXPECT_FALSE(info.Get());
+  EXPECT_EQ(2u, info.m_updates);
+}
+
+TEST(TestInfoBool, NoSource)
+{
+  InfoRefresh refresh;
+  CountingInfoBool info(0, refresh);
+
+  EXPECT_TRUE(info.Get());
+  refresh.SetDirty(INFO_SOURCE_ALL);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ(1u, info.m_updates);
+}
+
+TEST(TestInfoBool, SeveralSources)
+{
+  InfoRefresh refresh;
+  CountingInfoBool info(INFO_SOURCE_ALL, refresh);
+
+  info.Get();
+  refresh.SetDirty(INFO_SOURCE_FRAME);
+  info.Get();
+  refresh.SetDirty(INFO_SOURCE_SKIN_SETTINGS);
+  info.Get();
+  EXPECT_EQ(3u, info.m_updates);
+}
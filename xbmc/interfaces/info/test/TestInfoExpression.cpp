@@ -0,0 +1,503 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/GUIListItem.h"
+#include "interfaces/info/InfoExpression.h"
+#include "utils/StringUtils.h"
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace INFO;
+
+namespace
+{
+class CFixedInfoBool : public InfoBool
+{
+public:
+  CFixedInfoBool(const std::string& name, InfoRefresh& refresh) : InfoBool(name, 0, refresh) {}
+
+  void Update(const CGUIListItem* item) override
+  {
+    m_value = m_next;
+    m_updates++;
+  }
+
+  bool m_next = false;
+  unsigned int m_updates = 0;
+};
+
+typedef std::vector<std::shared_ptr<CFixedInfoBool>> Operands;
+typedef std::function<InfoPtr(const std::string& operand)> Lookup;
+
+class CTestExpression : public InfoExpression
+{
+public:
+  CTestExpression(const std::string& expression, InfoRefresh& refresh, const Lookup& lookup)
+    : InfoExpression(expression, 0, refresh), m_lookup(lookup)
+  {
+  }
+
+protected:
+  InfoPtr RegisterOperand(const std::string& operand) override { return m_lookup(operand); }
+
+private:
+  Lookup m_lookup;
+};
+
+/*!
+ * The tree walk InfoExpression evaluated before it was compiled, kept to
+ * compare the benchmark with. Groups move the child that decided them to
+ * their front, nots are pushed down to the leaves.
+ */
+class CTreeWalkExpression : public InfoBool
+{
+public:
+  CTreeWalkExpression(const std::string& expression, InfoRefresh& refresh, const Lookup& lookup)
+    : InfoBool(expression, 0, refresh), m_lookup(lookup)
+  {
+    const char* s = expression.c_str();
+    m_root = Parse(s, false, true);
+  }
+
+  void Update(const CGUIListItem* item) override { m_value = m_root->Evaluate(item); }
+
+private:
+  class CNode
+  {
+  public:
+    virtual ~CNode() = default;
+    virtual bool Evaluate(const CGUIListItem* item) = 0;
+  };
+  typedef std::shared_ptr<CNode> CNodePtr;
+
+  class CLeaf : public CNode
+  {
+  public:
+    CLeaf(const InfoPtr& info, bool invert) : m_info(info), m_invert(invert) {}
+    bool Evaluate(const CGUIListItem* item) override { return m_invert ^ m_info->Get(item); }
+
+  private:
+    InfoPtr m_info;
+    bool m_invert;
+  };
+
+  class CGroup : public CNode
+  {
+  public:
+    explicit CGroup(bool useAnd) : m_and(useAnd) {}
+
+    void Add(const CNodePtr& child)
+    {
+      std::shared_ptr<CGroup> group = std::dynamic_pointer_cast<CGroup>(child);
+      if (group && group->m_and == m_and)
+        m_children.splice(m_children.end(), group->m_children);
+      else
+        m_children.push_back(child);
+    }
+
+    bool Evaluate(const CGUIListItem* item) override
+    {
+      auto it = m_children.begin();
+      bool result = m_and ^ (*it)->Evaluate(item);
+      while (!result && ++it != m_children.end())
+      {
+        result = m_and ^ (*it)->Evaluate(item);
+        if (result)
+        {
+          m_children.push_front(*it);
+          m_children.erase(it);
+        }
+      }
+      return m_and ^ result;
+    }
+
+  private:
+    bool m_and;
+    std::list<CNodePtr> m_children;
+  };
+
+  static void SkipSpace(const char*& s)
+  {
+    while (*s == ' ')
+      s++;
+  }
+
+  CNodePtr Parse(const char*& s, bool invert, bool orLevel)
+  {
+    // an inverted OR is an AND of the inverted children and the other way around
+    const char separator = orLevel ? '|' : '+';
+    CNodePtr first = orLevel ? Parse(s, invert, false) : ParseOperand(s, invert);
+    if (*s != separator)
+      return first;
+
+    std::shared_ptr<CGroup> group = std::make_shared<CGroup>(orLevel == invert);
+    group->Add(first);
+    while (*s == separator)
+    {
+      s++;
+      group->Add(orLevel ? Parse(s, invert, false) : ParseOperand(s, invert));
+    }
+    return group;
+  }
+
+  CNodePtr ParseOperand(const char*& s, bool invert)
+  {
+    SkipSpace(s);
+    if (*s == '!')
+      return ParseOperand(++s, !invert);
+
+    CNodePtr node;
+    if (*s == '[')
+    {
+      node = Parse(++s, invert, true);
+      s++; // ]
+    }
+    else
+    {
+      std::string operand;
+      while (*s && !strchr("[]!+|", *s))
+        operand += *s++;
+      InfoPtr info = m_lookup(operand);
+      m_listItemDependent |= info->ListItemDependent();
+      node = std::make_shared<CLeaf>(info, invert);
+    }
+    SkipSpace(s);
+    return node;
+  }
+
+  Lookup m_lookup;
+  CNodePtr m_root;
+};
+
+typedef std::function<bool(bool a, bool b, bool c, bool d)> TruthTable;
+} // namespace
+
+class TestInfoExpression : public ::testing::Test
+{
+protected:
+  TestInfoExpression()
+  {
+    for (const char* name : {"a", "b", "c", "d"})
+      m_operands.push_back(std::make_shared<CFixedInfoBool>(name, m_refresh));
+  }
+
+  void Set(unsigned int row)
+  {
+    for (unsigned int i = 0; i < m_operands.size(); i++)
+    {
+      m_operands[i]->m_next = (row & (1 << i)) != 0;
+      m_operands[i]->m_updates = 0;
+    }
+    m_refresh.SetDirty(INFO_SOURCE_FRAME);
+  }
+
+  std::string Updated() const
+  {
+    std::string updated;
+    for (const auto& info : m_operands)
+    {
+      if (info->m_updates)
+        updated += info->GetExpression();
+    }
+    return updated;
+  }
+
+  InfoPtr Find(const std::string& operand) const
+  {
+    for (const auto& info : m_operands)
+    {
+      if (info->GetExpression() == operand)
+        return info;
+    }
+    return nullptr;
+  }
+
+  Lookup GetLookup() const
+  {
+    return [this](const std::string& operand) { return Find(operand); };
+  }
+
+  // evaluates the expression for every combination of the operands
+  void CheckTruthTable(const std::string& expression, const TruthTable& expected)
+  {
+    CTestExpression info(expression, m_refresh, GetLookup());
+    info.Initialize();
+    for (unsigned int row = 0; row < 16; row++)
+    {
+      Set(row);
+      EXPECT_EQ(expected(row & 1, row & 2, row & 4, row & 8), info.Get())
+          << expression << " with a=" << (row & 1) << " b=" << ((row >> 1) & 1)
+          << " c=" << ((row >> 2) & 1) << " d=" << ((row >> 3) & 1);
+    }
+  }
+
+  InfoRefresh m_refresh;
+  Operands m_operands;
+};
+
+TEST_F(TestInfoExpression, Leaf)
+{
+  CheckTruthTable("a", [](bool a, bool b, bool c, bool d) { return a; });
+  CheckTruthTable("!a", [](bool a, bool b, bool c, bool d) { return !a; });
+  CheckTruthTable("!!a", [](bool a, bool b, bool c, bool d) { return a; });
+}
+
+TEST_F(TestInfoExpression, Groups)
+{
+  CheckTruthTable("a+b+c", [](bool a, bool b, bool c, bool d) { return a && b && c; });
+  CheckTruthTable("a|b|c", [](bool a, bool b, bool c, bool d) { return a || b || c; });
+  CheckTruthTable("a+b|c", [](bool a, bool b, bool c, bool d) { return (a && b) || c; });
+  CheckTruthTable("a|b+c", [](bool a, bool b, bool c, bool d) { return a || (b && c); });
+}
+
+TEST_F(TestInfoExpression, Nested)
+{
+  CheckTruthTable("a|[b+c]|d", [](bool a, bool b, bool c, bool d) { return a || (b && c) || d; });
+  CheckTruthTable("[a|b]+[c|d]",
+                  [](bool a, bool b, bool c, bool d) { return (a || b) && (c || d); });
+  CheckTruthTable("a+[b|[c+d]]", [](bool a, bool b, bool c, bool d) { return a && (b || (c && d)); });
+  CheckTruthTable("[a|b]|[c|d+[[a|b]|c]]",
+                  [](bool a, bool b, bool c, bool d) { return a || b || c || (d && (a || b || c)); });
+}
+
+TEST_F(TestInfoExpression, Inverted)
+{
+  CheckTruthTable("![a+b]|c", [](bool a, bool b, bool c, bool d) { return !(a && b) || c; });
+  CheckTruthTable("![a|b]+c", [](bool a, bool b, bool c, bool d) { return !(a || b) && c; });
+  CheckTruthTable("![a|[b+!c]]+d",
+                  [](bool a, bool b, bool c, bool d) { return !(a || (b && !c)) && d; });
+  CheckTruthTable("!a|![!b+[c|!d]]",
+                  [](bool a, bool b, bool c, bool d) { return !a || !(!b && (c || !d)); });
+}
+
+TEST_F(TestInfoExpression, ShortCircuit)
+{
+  // c is only needed when b is true, the child that decided a group moves to its front
+  CTestExpression info("a|[b+c]|d", m_refresh, GetLookup());
+  info.Initialize();
+
+  Set(0x1);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ("a", Updated());
+
+  Set(0x8);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ("abd", Updated());
+
+  // d|a|[b+c]
+  Set(0x8);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ("d", Updated());
+
+  Set(0x2 | 0x4);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ("abcd", Updated());
+
+  // [b+c]|d|a
+  Set(0x2 | 0x4);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ("bc", Updated());
+
+  Set(0x2);
+  EXPECT_FALSE(info.Get());
+  EXPECT_EQ("abcd", Updated());
+}
+
+TEST_F(TestInfoExpression, ShortCircuitInverted)
+{
+  // ![a+b]|c is evaluated as c|!a|!b, the parser moves the last operand first
+  CTestExpression info("![a+b]|c", m_refresh, GetLookup());
+  info.Initialize();
+
+  Set(0x4);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ("c", Updated());
+
+  // !a|c|!b
+  Set(0x0);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ("ac", Updated());
+
+  // !b|!a|c
+  Set(0x1);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ("abc", Updated());
+
+  Set(0x1 | 0x2);
+  EXPECT_FALSE(info.Get());
+  EXPECT_EQ("abc", Updated());
+
+  Set(0x1);
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ("b", Updated());
+}
+
+namespace
+{
+/*!
+ * A condition with a value per list item, read from the row the benchmark is
+ * at. Conditions that don't look at the list item keep one value for the run.
+ */
+class CRowInfoBool : public InfoBool
+{
+public:
+  CRowInfoBool(const std::string& name,
+               InfoRefresh& refresh,
+               const std::vector<bool>& values,
+               const unsigned int& row)
+    : InfoBool(name, 0, refresh), m_values(values), m_row(row)
+  {
+    m_listItemDependent = m_expression.find("listitem") != std::string::npos;
+  }
+
+  void Update(const CGUIListItem* item) override
+  {
+    m_value = m_values[m_row];
+    m_updates++;
+  }
+
+  std::vector<bool> m_values;
+  const unsigned int& m_row;
+  unsigned int m_updates = 0;
+};
+} // namespace
+
+TEST(TestInfoExpressionBenchmark, Estuary)
+{
+  // visibility conditions Estuary evaluates for every item of its lists, run
+  // through the tree walk InfoExpression used before and the compiled one. The
+  // times and the leaves evaluated are recorded as test properties,
+  // --gtest_output=xml keeps them for comparing releases.
+  const std::vector<std::string> expressions = {
+      "String.IsEqual(ListItem.DBType,tvshow) | String.IsEqual(ListItem.DBType,season) | "
+      "String.IsEqual(ListItem.DBType,set)",
+      "String.IsEmpty(Listitem.Plot) + String.IsEmpty(Listitem.Tagline) + "
+      "!ListItem.IsCollection + !ListItem.IsParentFolder",
+      "String.IsEmpty(Listitem.Thumb) + [String.IsEqual(listitem.dbtype,album) | "
+      "String.IsEqual(listitem.dbtype,artist)]",
+      "Listitem.IsCollection | ListItem.IsPlaying | Integer.IsGreater(ListItem.Playcount,0)",
+      "!ListItem.IsCollection + String.IsEmpty(Control.GetLabel(15500)) + "
+      "Control.IsVisible(15500)",
+      "[Window.IsActive(tvtimerrules) | Window.IsActive(radiotimerrules)] + "
+      "!ListItem.HasTimerSchedule",
+      "!String.IsEmpty(ListItem.Thumb) + !String.IsEqual(ListItem.Thumb,ListItem.Art(poster))",
+  };
+  const unsigned int rows = 1000;
+  const unsigned int passes = 200;
+
+  InfoRefresh refresh;
+  unsigned int row = 0;
+  unsigned int seed = 1;
+  auto random = [&seed]() {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7fff;
+  };
+
+  // the items of a list are alike, a condition keeps its value for a few items.
+  // Operands are registered the way CGUIInfoManager::Register does.
+  std::map<std::string, std::shared_ptr<CRowInfoBool>> conditions;
+  Lookup lookup = [&](const std::string& operand) -> InfoPtr {
+    std::string name(operand);
+    StringUtils::TrimRight(name);
+    StringUtils::ToLower(name);
+    std::shared_ptr<CRowInfoBool>& condition = conditions[name];
+    if (!condition)
+    {
+      std::vector<bool> values(rows);
+      const unsigned int probability = random() % 100;
+      bool value = random() % 100 < probability;
+      for (unsigned int i = 0; i < rows; i++)
+      {
+        if (random() % 10 == 0)
+          value = random() % 100 < probability;
+        values[i] = value;
+      }
+      condition = std::make_shared<CRowInfoBool>(name, refresh, values, row);
+    }
+    return condition;
+  };
+
+  std::vector<std::unique_ptr<CTreeWalkExpression>> treeWalks;
+  std::vector<std::unique_ptr<CTestExpression>> compiled;
+  for (const auto& expression : expressions)
+  {
+    treeWalks.emplace_back(new CTreeWalkExpression(expression, refresh, lookup));
+    compiled.emplace_back(new CTestExpression(expression, refresh, lookup));
+    compiled.back()->Initialize();
+  }
+
+  auto countUpdates = [&conditions]() {
+    unsigned int updates = 0;
+    for (auto& condition : conditions)
+    {
+      updates += condition.second->m_updates;
+      condition.second->m_updates = 0;
+    }
+    return updates;
+  };
+
+  // the results of the tree walk, the compiled expressions have to match them
+  CGUIListItem item;
+  std::vector<bool> expected;
+  countUpdates();
+  auto start = std::chrono::steady_clock::now();
+  for (unsigned int pass = 0; pass < passes; pass++)
+  {
+    for (row = 0; row < rows; row++)
+    {
+      for (auto& treeWalk : treeWalks)
+      {
+        const bool result = treeWalk->Get(&item);
+        if (pass == 0)
+          expected.push_back(result);
+      }
+    }
+  }
+  const auto treeWalkTime = std::chrono::steady_clock::now() - start;
+  const unsigned int treeWalkUpdates = countUpdates();
+
+  unsigned int mismatches = 0;
+  start = std::chrono::steady_clock::now();
+  for (unsigned int pass = 0; pass < passes; pass++)
+  {
+    auto result = expected.begin();
+    for (row = 0; row < rows; row++)
+    {
+      for (auto& info : compiled)
+      {
+        if (info->Get(&item) != *result++)
+          mismatches++;
+      }
+    }
+  }
+  const auto compiledTime = std::chrono::steady_clock::now() - start;
+  const unsigned int compiledUpdates = countUpdates();
+
+  EXPECT_EQ(0u, mismatches);
+
+  const long long evaluations = static_cast<long long>(rows) * passes * expressions.size();
+  auto nsPerEvaluation = [evaluations](std::chrono::steady_clock::duration elapsed) {
+    return static_cast<int>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / evaluations);
+  };
+  RecordProperty("tree_walk_ns_per_evaluation", nsPerEvaluation(treeWalkTime));
+  RecordProperty("compiled_ns_per_evaluation", nsPerEvaluation(compiledTime));
+  RecordProperty("tree_walk_leaves_per_1000_evaluations",
+                 static_cast<int>(treeWalkUpdates * 1000LL / evaluations));
+  RecordProperty("compiled_leaves_per_1000_evaluations",
+                 static_cast<int>(compiledUpdates * 1000LL / evaluations));
+}
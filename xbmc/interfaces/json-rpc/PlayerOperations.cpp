@@ -16,8 +16,10 @@
 #include "PartyModeManager.h"
 #include "PlayListPlayer.h"
 #include "SeekHandler.h"
+#include "ServiceBroker.h"
 #include "Util.h"
 #include "VideoLibrary.h"
+#include "cores/DataCacheCore.h"
 #include "cores/IPlayer.h"
 #include "cores/playercorefactory/PlayerCoreFactory.h"
 #include "guilib/GUIWindowManager.h"
@@ -1863,6 +1865,29 @@ JSONRPC_STATUS CPlayerOperations::GetPropertyValue(PlayerType player, const std:
   }
   else if (property == "live")
     result = IsPVRChannel();
+  else if (property == "audioenginetiming")
+  {
+    static const std::pair<const char*, CDataCacheCore::AudioEngineStage> stages[] = {
+        {"resample", CDataCacheCore::AE_STAGE_RESAMPLE},
+        {"mix", CDataCacheCore::AE_STAGE_MIX},
+        {"encode", CDataCacheCore::AE_STAGE_ENCODE},
+        {"sinkwrite", CDataCacheCore::AE_STAGE_SINKWRITE},
+        {"sinkdrift", CDataCacheCore::AE_STAGE_SINKDRIFT}};
+
+    result = CVariant(CVariant::VariantTypeObject);
+    for (const auto& stage : stages)
+    {
+      const CDataCacheCore::SAudioEngineTiming timing =
+          CServiceBroker::GetDataCacheCore().GetAudioEngineTiming(stage.second);
+
+      CVariant value(CVariant::VariantTypeObject);
+      value["count"] = timing.count;
+      value["median"] = timing.median;
+      value["p99"] = timing.p99;
+      value["max"] = timing.max;
+      result[stage.first] = value;
+    }
+  }
   else
     return InvalidParams;
 
@@ -12,6 +12,7 @@
 #include "Application.h"
 #include "Artist.h"
 #include "FileItem.h"
+#include "FingerprintDatabase.h"
 #include "GUIInfoManager.h"
 #include "LangInfo.h"
 #include "ServiceBroker.h"
@@ -3292,13 +3293,17 @@ bool CMusicDatabase::CleanupPaths()
     }
     // and construct a list to delete
     std::vector<std::string> pathIds;
+    std::vector<std::string> paths;
     while (!m_pDS->eof())
     {
       // anything that isn't a parent path of a song path is to be deleted
       std::string path = m_pDS->fv("strPath").get_asString();
       std::string sql = PrepareSQL("select count(idPath) from songpaths where SUBSTR(strPath,1,%i)='%s'", StringUtils::utf8_strlen(path.c_str()), path.c_str());
       if (m_pDS2->query(sql) && m_pDS2->num_rows() == 1 && m_pDS2->fv(0).get_asInt() == 0)
+      {
         pathIds.push_back(m_pDS->fv("idPath").get_asString()); // nothing found, so delete
+        paths.push_back(path);
+      }
       m_pDS2->close();
       m_pDS->next();
     }
@@ -3311,6 +3316,7 @@ bool CMusicDatabase::CleanupPaths()
       m_pDS->exec(deleteSQL);
     }
     m_pDS->exec("drop table songpaths");
+    RemoveFingerprints(paths);
     return true;
   }
   catch (...)
@@ -3320,6 +3326,19 @@ bool CMusicDatabase::CleanupPaths()
   return false;
 }
 
+void CMusicDatabase::RemoveFingerprints(const std::vector<std::string>& paths)
+{
+  if (paths.empty())
+    return;
+
+  CFingerprintDatabase fingerprintDatabase;
+  if (!fingerprintDatabase.Open())
+    return;
+  for (const auto& path : paths)
+    fingerprintDatabase.RemoveFingerprints("music", path);
+  fingerprintDatabase.Close();
+}
+
 bool CMusicDatabase::InsideScannedPath(const std::string& path)
 {
   std::string sql = PrepareSQL("select idPath from path where SUBSTR(strPath,1,%i)='%s' LIMIT 1", path.size(), path.c_str());
@@ -9166,6 +9185,8 @@ bool CMusicDatabase::RemoveSongsFromPath(const std::string &path1, MAPSONGS& son
     // and remove the path as well (it'll be re-added later on with the new hash if it's non-empty)
     sql = "delete from path" + where;
     m_pDS->exec(sql);
+    if (!exact)
+      RemoveFingerprints({path});
     return iRowsFound > 0;
   }
   catch (...)
@@ -9175,6 +9196,57 @@ bool CMusicDatabase::RemoveSongsFromPath(const std::string &path1, MAPSONGS& son
   return false;
 }
 
+bool CMusicDatabase::RemoveSongsFromPath(const std::string &path1, const std::set<std::string>& keepFiles, MAPSONGS& songs)
+{
+  if (keepFiles.empty())
+    return RemoveSongsFromPath(path1, songs, true);
+
+  // As above, but the path stays as the songs kept still refer to it
+  std::string path(path1);
+  SetLibraryLastUpdated();
+  try
+  {
+    if (!URIUtils::HasSlashAtEnd(path))
+      URIUtils::AddSlashAtEnd(path);
+
+    if (nullptr == m_pDB)
+      return false;
+    if (nullptr == m_pDS)
+      return false;
+
+    std::string sql = PrepareSQL("select * from songview where strPath='%s'", path.c_str());
+    if (!m_pDS->query(sql)) return false;
+    std::vector<std::string> songIds;
+    while (!m_pDS->eof())
+    {
+      CSong song = GetSongFromDataset();
+      if (keepFiles.find(song.strFileName) == keepFiles.end())
+      {
+        song.strThumb = GetArtForItem(song.idSong, MediaTypeSong, "thumb");
+        songs.insert(std::make_pair(song.strFileName, song));
+        songIds.push_back(PrepareSQL("%i", song.idSong));
+      }
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    if (songIds.empty())
+      return false;
+
+    for (const auto &song : songs)
+      AnnounceRemove(MediaTypeSong, song.second.idSong);
+
+    sql = "delete from song where idSong in (" + StringUtils::Join(songIds, ",") + ")";
+    m_pDS->exec(sql);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, path.c_str());
+  }
+  return false;
+}
+
 bool CMusicDatabase::GetPaths(std::set<std::string> &paths)
 {
   try
@@ -199,6 +199,13 @@ public:
   bool GetSongsByPath(const std::string& strPath, MAPSONGS& songs, bool bAppendToMap = false);
   bool Search(const std::string& search, CFileItemList &items);
   bool RemoveSongsFromPath(const std::string &path, MAPSONGS& songs, bool exact=true);
+  /*! \brief Remove the songs of a path except those of the given files, the path itself stays
+   \param path the path to remove songs from
+   \param keepFiles files whose songs stay in the library
+   \param songs [out] the songs removed, by file
+   \return true if songs were removed
+   */
+  bool RemoveSongsFromPath(const std::string &path, const std::set<std::string>& keepFiles, MAPSONGS& songs);
   bool SetSongUserrating(const std::string &filePath, int userrating);
   bool SetSongUserrating(int idSong, int userrating);
   bool SetSongVotes(const std::string &filePath, int votes);
@@ -666,6 +673,11 @@ private:
   bool CleanupSongs(CGUIDialogProgress* progressDialog = nullptr);
   bool CleanupSongsByIds(const std::string &strSongIds);
   bool CleanupPaths();
+  /*!
+   \brief Forget the fingerprints the scanner took of paths that left the library
+   \param paths the paths, their subpaths are forgotten as well
+   */
+  void RemoveFingerprints(const std::vector<std::string>& paths);
   bool CleanupAlbums();
   bool CleanupArtists();
   bool CleanupGenres();
@@ -9,6 +9,7 @@
 #include "MusicInfoScanner.h"
 
 #include "FileItem.h"
+#include "FingerprintDatabase.h"
 #include "GUIInfoManager.h"
 #include "GUIUserMessages.h"
 #include "MusicAlbumInfo.h"
@@ -27,6 +28,7 @@
 #include "events/EventLog.h"
 #include "events/MediaLibraryEvent.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryWalker.h"
 #include "filesystem/File.h"
 #include "filesystem/MusicDatabaseDirectory.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
@@ -99,6 +101,7 @@ void CMusicInfoScanner::Process()
 
     unsigned int tick = XbmcThreads::SystemClockMillis();
     m_musicDatabase.Open();
+    m_fingerprintDatabase.Open();
     m_bCanInterrupt = true;
 
     if (m_scanType == 0) // load info from files
@@ -264,6 +267,7 @@ void CMusicInfoScanner::Process()
     CLog::Log(LOGERROR, "MusicInfoScanner: Exception while scanning.");
   }
   m_musicDatabase.Close();
+  m_fingerprintDatabase.Close();
   CLog::Log(LOGDEBUG, "%s - Finished scan", __FUNCTION__);
 
   m_bRunning = false;
@@ -458,35 +462,55 @@ static std::string Prettify(const std::string& strDirectory)
 
 bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
 {
-  if (m_handle)
-  {
-    m_handle->SetTitle(g_localizeStrings.Get(506)); //"Checking media files..."
-    m_handle->SetText(Prettify(strDirectory));
-  }
-
-  std::set<std::string>::const_iterator it = m_seenPaths.find(strDirectory);
-  if (it != m_seenPaths.end())
-    return true;
-
-  m_seenPaths.insert(strDirectory);
-
   // Discard all excluded files defined by m_musicExcludeRegExps
   const std::vector<std::string> &regexps = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioExcludeFromScanRegExps;
 
-  if (CUtil::ExcludeFileOrFolder(strDirectory, regexps))
+  if (m_seenPaths.find(strDirectory) != m_seenPaths.end())
     return true;
 
-  if (HasNoMedia(strDirectory))
+  if (CUtil::ExcludeFileOrFolder(strDirectory, regexps) || HasNoMedia(strDirectory))
+  {
+    m_seenPaths.insert(strDirectory);
     return true;
+  }
+
+  // subfolders are listed ahead while the ones before them are scanned
+  CDirectoryWalker walker(strDirectory, CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg", DIR_FLAG_DEFAULTS);
+  walker.SetPrepare([](CFileItemList& items) {
+    // sort for the path hash and the order of the subfolders
+    items.Sort(SortByLabel, SortOrderAscending);
+  });
+  walker.SetFilter([this, &regexps](const CFileItem& item) {
+    // if we have a directory item (non-playlist) we then recurse into that folder
+    return item.m_bIsFolder && !item.IsParentFolder() && !item.IsPlayList() &&
+           !CUtil::ExcludeFileOrFolder(item.GetPath(), regexps) && !HasNoMedia(item.GetPath());
+  });
 
-  // load subfolder
   CFileItemList items;
-  CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetMusicExtensions() + "|.jpg|.tbn|.lrc|.cdg", DIR_FLAG_DEFAULTS);
+  while (!m_bStop && walker.Next(items))
+  {
+    if (m_handle)
+    {
+      m_handle->SetTitle(g_localizeStrings.Get(506)); //"Checking media files..."
+      m_handle->SetText(Prettify(items.GetPath()));
+    }
 
-  // sort and get the path hash.  Note that we don't filter .cue sheet items here as we want
+    if (!m_seenPaths.insert(items.GetPath()).second)
+    {
+      walker.SkipChildren();
+      continue;
+    }
+
+    ScanDirectory(items.GetPath(), items);
+  }
+  return !m_bStop;
+}
+
+void CMusicInfoScanner::ScanDirectory(const std::string& strDirectory, CFileItemList& items)
+{
+  // get the path hash.  Note that we don't filter .cue sheet items here as we want
   // to detect changes in the .cue sheet as well.  The .cue sheet items only need filtering
   // if we have a changed hash.
-  items.Sort(SortByLabel, SortOrderAscending);
   std::string hash;
   GetPathHash(items, hash);
 
@@ -502,17 +526,35 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     if (m_handle)
       m_handle->SetTitle(g_localizeStrings.Get(505)); //"Loading media information from files..."
 
+    // only files that changed since the last scan need their tags read, unless
+    // all are to be rescanned or .cue sheets tie songs to other files
+    bool incremental = !(m_flags & SCAN_RESCAN) && !dbHash.empty();
+    for (int i = 0; i < items.Size() && incremental; ++i)
+      incremental = !items[i]->IsCUESheet();
+
     // filter items in the sub dir (for .cue sheet support)
     items.FilterCueItems();
     items.Sort(SortByLabel, SortOrderAscending);
 
     // and then scan in the new information from tags
-    if (RetrieveMusicInfo(strDirectory, items) > 0)
+    if (RetrieveMusicInfo(strDirectory, items, incremental) > 0)
     {
       if (m_handle)
         OnDirectoryScanned(strDirectory);
     }
 
+    // remember the files that made it into the library
+    MAPSONGS songs;
+    m_musicDatabase.GetSongsByPath(strDirectory, songs);
+    CFingerprintDatabase::Fingerprints fingerprints;
+    for (const auto& item : items)
+    {
+      const std::string fingerprint = CFingerprintDatabase::GetFingerprint(*item);
+      if (!fingerprint.empty() && songs.find(item->GetPath()) != songs.end())
+        fingerprints.insert(std::make_pair(item->GetPath(), fingerprint));
+    }
+    m_fingerprintDatabase.SetFingerprints("music", strDirectory, fingerprints);
+
     // save information about this folder
     m_musicDatabase.SetPathHash(strDirectory, hash);
   }
@@ -529,25 +571,6 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
       OnDirectoryScanned(strDirectory);
     }
   }
-
-  // now scan the subfolders
-  for (int i = 0; i < items.Size(); ++i)
-  {
-    CFileItemPtr pItem = items[i];
-
-    if (m_bStop)
-      break;
-    // if we have a directory item (non-playlist) we then recurse into that folder
-    if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList())
-    {
-      std::string strPath=pItem->GetPath();
-      if (!DoScan(strPath))
-      {
-        m_bStop = true;
-      }
-    }
-  }
-  return !m_bStop;
 }
 
 CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
@@ -852,16 +875,88 @@ CMusicInfoScanner::UpdateArtistInfo(CArtist& artist,
   return result;
 }
 
-int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileItemList& items)
+bool CMusicInfoScanner::GroupsLikeFolder(const MAPSONGS& songs, const std::set<std::string>& keepFiles,
+                                         const CFileItemList& scannedItems)
+{
+  // a compilation, or an album of several artists, needs all of its songs to be grouped
+  std::map<std::string, std::string> albumArtists;
+  for (const auto& song : songs)
+  {
+    if (keepFiles.find(song.first) == keepFiles.end())
+      continue;
+    if (song.second.bCompilation)
+      return false;
+
+    const auto it = albumArtists.insert(std::make_pair(song.second.strAlbum, song.second.GetArtistString())).first;
+    if (it->second != song.second.GetArtistString())
+      return false;
+  }
+
+  for (const auto& item : scannedItems)
+  {
+    const CMusicInfoTag& tag = *item->GetMusicInfoTag();
+    const auto it = albumArtists.find(tag.GetAlbum());
+    if (it != albumArtists.end() && it->second != tag.GetArtistString())
+      return false;
+  }
+
+  return true;
+}
+
+int CMusicInfoScanner::RetrieveMusicInfo(const std::string& strDirectory, CFileItemList& items, bool incremental /* = false */)
 {
   MAPSONGS songsMap;
+  CFileItemList changed;
+  std::set<std::string> keepFiles;
+  MAPSONGS songs;
 
-  // get all information for all files in current directory from database, and remove them
-  if (m_musicDatabase.RemoveSongsFromPath(strDirectory, songsMap))
-    m_needsCleanup = true;
+  if (incremental)
+  {
+    // files with the fingerprint they had when their songs were added keep them
+    CFingerprintDatabase::Fingerprints fingerprints;
+    m_fingerprintDatabase.GetFingerprints("music", strDirectory, fingerprints);
+    m_musicDatabase.GetSongsByPath(strDirectory, songs);
+
+    CFileItemList unchanged;
+    CFingerprintDatabase::GetChangedFiles(items, fingerprints, changed, unchanged);
+    for (const auto& item : unchanged)
+    {
+      if (songs.find(item->GetPath()) != songs.end())
+        keepFiles.insert(item->GetPath());
+      else
+        changed.Add(item);
+    }
+    m_currentItem += keepFiles.size();
+    CLog::Log(LOGDEBUG, "%s %u of %u files in '%s' are unchanged", __FUNCTION__,
+              static_cast<unsigned int>(keepFiles.size()), static_cast<unsigned int>(items.Size()),
+              CURL::GetRedacted(strDirectory).c_str());
+  }
 
   CFileItemList scannedItems;
-  if (ScanTags(items, scannedItems) == INFO_CANCELLED || scannedItems.Size() == 0)
+  INFO_RET ret = ScanTags(incremental ? changed : items, scannedItems);
+
+  // albums are grouped from the songs of the whole folder, where the changed songs alone would
+  // group differently their tags are needed too
+  if (ret != INFO_CANCELLED && !keepFiles.empty() && !GroupsLikeFolder(songs, keepFiles, scannedItems))
+  {
+    CLog::Log(LOGDEBUG, "%s albums in '%s' span several artists, scanning all files", __FUNCTION__,
+              CURL::GetRedacted(strDirectory).c_str());
+    CFileItemList unchanged;
+    for (const auto& item : items)
+    {
+      if (keepFiles.find(item->GetPath()) != keepFiles.end())
+        unchanged.Add(item);
+    }
+    m_currentItem -= keepFiles.size();
+    keepFiles.clear();
+    ret = ScanTags(unchanged, scannedItems);
+  }
+
+  // get all information for the files to scan from database, and remove them
+  if (m_musicDatabase.RemoveSongsFromPath(strDirectory, keepFiles, songsMap))
+    m_needsCleanup = true;
+
+  if (ret == INFO_CANCELLED || scannedItems.Size() == 0)
     return 0;
 
   VECALBUMS albums;
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include "FingerprintDatabase.h"
 #include "InfoScanner.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
@@ -77,6 +78,8 @@ public:
 protected:
   virtual void Process();
   bool DoScan(const std::string& strDirectory) override;
+  //! updates the library from a listing of strDirectory if it changed
+  void ScanDirectory(const std::string& strDirectory, CFileItemList& items);
 
   /*! \brief Find art for albums
    Based on the albums in the folder, finds whether we have unique album art
@@ -192,9 +195,17 @@ protected:
    Add album to library, populate a list of album ids added for possible scraping later.
    Any files which couldn't be scanned (no/bad tags) are discarded in the process.
    \param items [in] list of FileItems to scan
-   \param scannedItems [in] list to populate with the scannedItems
+   \param incremental [in] only scan files whose fingerprint changed, the songs of the others stay
+   */
+  int RetrieveMusicInfo(const std::string& strDirectory, CFileItemList& items, bool incremental = false);
+
+  /*! \brief Whether the changed songs of a folder are grouped into the same albums as with all its songs
+   \param songs [in] songs of the folder in the library
+   \param keepFiles [in] files whose songs are kept
+   \param scannedItems [in] songs of the changed files
    */
-  int RetrieveMusicInfo(const std::string& strDirectory, CFileItemList& items);
+  static bool GroupsLikeFolder(const MAPSONGS& songs, const std::set<std::string>& keepFiles,
+                               const CFileItemList& scannedItems);
 
   void RetrieveLocalArt();
   void ScrapeInfoAddedAlbums();
@@ -232,6 +243,7 @@ protected:
   int m_scanType = 0; // 0 - load from files, 1 - albums, 2 - artists
   int m_idSourcePath;
   CMusicDatabase m_musicDatabase;
+  CFingerprintDatabase m_fingerprintDatabase;
 
   std::set<int> m_albumsAdded;
 
@@ -21,11 +21,35 @@
 
 #include <fcntl.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 using namespace XFILE;
 
+namespace
+{
+class CPosixFileView : public IFileView
+{
+public:
+  CPosixFileView(void* mapping, size_t mappingSize, size_t offset, size_t size)
+    : m_mapping(mapping), m_mappingSize(mappingSize), m_offset(offset), m_size(size)
+  {
+  }
+  ~CPosixFileView() override { munmap(m_mapping, m_mappingSize); }
+
+  const uint8_t* GetData() const override { return static_cast<const uint8_t*>(m_mapping) + m_offset; }
+  size_t GetSize() const override { return m_size; }
+
+private:
+  void* m_mapping;
+  size_t m_mappingSize;
+  size_t m_offset; // of the requested position from the page aligned mapping
+  size_t m_size;
+};
+} // namespace
+
 CPosixFile::~CPosixFile()
 {
   if (m_fd >= 0)
@@ -132,6 +156,95 @@ ssize_t CPosixFile::Read(void* lpBuf, size_t uiBufSize)
   return res;
 }
 
+ssize_t CPosixFile::ReadAt(int64_t position, const SReadBuffer* buffers, size_t count)
+{
+  if (m_fd < 0 || position < 0)
+    return -1;
+
+  // buffer and offset in it where the next read continues
+  size_t index = 0;
+  size_t offset = 0;
+  ssize_t total = 0;
+
+  while (true)
+  {
+    while (index < count && offset == buffers[index].size)
+    {
+      index++;
+      offset = 0;
+    }
+    if (index == count)
+      break;
+
+    struct iovec vec[16];
+    int vecCount = 0;
+    for (size_t i = index; i < count && vecCount < 16; i++)
+    {
+      const size_t skip = i == index ? offset : 0;
+      vec[vecCount].iov_base = static_cast<char*>(buffers[i].data) + skip;
+      vec[vecCount].iov_len = std::min<size_t>(buffers[i].size - skip, SSIZE_MAX - total);
+      vecCount++;
+    }
+
+#if (defined(TARGET_LINUX) && !defined(TARGET_ANDROID)) || defined(TARGET_FREEBSD)
+    const ssize_t res = preadv(m_fd, vec, vecCount, position + total);
+#else
+    const ssize_t res = pread(m_fd, vec[0].iov_base, vec[0].iov_len, position + total);
+#endif
+    if (res < 0 && errno == EINTR)
+      continue;
+    if (res < 0)
+      return -1;
+    if (res == 0)
+      break;
+
+    total += res;
+    for (size_t left = res; left > 0;)
+    {
+      const size_t used = std::min(left, buffers[index].size - offset);
+      offset += used;
+      left -= used;
+      if (left > 0)
+      {
+        index++;
+        offset = 0;
+      }
+    }
+
+    if (total == SSIZE_MAX)
+      break;
+  }
+
+  return total;
+}
+
+std::unique_ptr<IFileView> CPosixFile::Map(int64_t position, size_t size)
+{
+  if (m_fd < 0 || position < 0 || size == 0 || m_allowWrite)
+    return nullptr;
+
+  // only what is there, a mapping beyond the end of the file faults on access
+  struct stat64 st;
+  if (fstat64(m_fd, &st) != 0 || !S_ISREG(st.st_mode) || position + static_cast<int64_t>(size) > st.st_size)
+    return nullptr;
+
+  static const int64_t pageSize = sysconf(_SC_PAGESIZE);
+  const int64_t start = position - position % pageSize;
+  const size_t offset = static_cast<size_t>(position - start);
+  if (size > SIZE_MAX - offset)
+    return nullptr;
+
+  void* mapping = mmap(nullptr, size + offset, PROT_READ, MAP_SHARED, m_fd, start);
+  if (mapping == MAP_FAILED)
+  {
+    CLog::Log(LOGDEBUG, "CPosixFile::Map - can't map %zu bytes at %" PRId64 ", errno %d", size,
+              position, errno);
+    return nullptr;
+  }
+
+  return std::unique_ptr<IFileView>(new CPosixFileView(mapping, size + offset, offset, size));
+}
+
 ssize_t CPosixFile::Write(const void* lpBuf, size_t uiBufSize)
 {
   if (m_fd < 0)
@@ -23,6 +23,9 @@ namespace XFILE
     void Close() override;
 
     ssize_t Read(void* lpBuf, size_t uiBufSize) override;
+    ssize_t ReadAt(int64_t position, const SReadBuffer* buffers, size_t count) override;
+    bool CanReadAt() override { return m_fd >= 0; }
+    std::unique_ptr<IFileView> Map(int64_t position, size_t size) override;
     ssize_t Write(const void* lpBuf, size_t uiBufSize) override;
     int64_t Seek(int64_t iFilePosition, int iWhence = SEEK_SET) override;
     int Truncate(int64_t size) override;
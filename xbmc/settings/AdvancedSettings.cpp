@@ -165,6 +165,8 @@ void CAdvancedSettings::Initialize()
   m_videoFpsDetect = 1;
   m_maxTempo = 1.55f;
   m_videoPreferStereoStream = false;
+  m_videoDemuxZeroCopy = false;
+  m_videoFilterThread = true;
 
   m_videoDefaultLatency = 0.0;
 
@@ -347,6 +349,7 @@ void CAdvancedSettings::Initialize()
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
   m_curlDisableHTTP2 = false;
+  m_curlKeepAlivePerHost = 4;
 
 #if defined(TARGET_DARWIN_EMBEDDED)
   m_startFullScreen = true;
@@ -386,6 +389,8 @@ void CAdvancedSettings::Initialize()
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  m_cachePersistentSize = 0;
+  m_cacheParallelReads = 1;
 
   m_addonPackageFolderSize = 200;
 
@@ -699,6 +704,10 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "fpsdetect", m_videoFpsDetect, 0, 2);
     XMLUtils::GetFloat(pElement, "maxtempo", m_maxTempo, 1.5, 2.1);
     XMLUtils::GetBoolean(pElement, "preferstereostream", m_videoPreferStereoStream);
+    // hand the ffmpeg packet buffers to the decoders instead of copying them
+    XMLUtils::GetBoolean(pElement, "demuxzerocopy", m_videoDemuxZeroCopy);
+    // run the filters of software decoded video, e.g. deinterlacing, beside the decoder
+    XMLUtils::GetBoolean(pElement, "filterthread", m_videoFilterThread);
 
     // Store global display latency settings
     TiXmlElement* pVideoLatency = pElement->FirstChildElement("latency");
@@ -815,6 +824,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement, "disableipv6", m_curlDisableIPV6);
     XMLUtils::GetBoolean(pElement, "disablehttp2", m_curlDisableHTTP2);
+    XMLUtils::GetUInt(pElement, "curlkeepaliveperhost", m_curlKeepAlivePerHost, 1, 64);
   }
 
   pElement = pRootElement->FirstChildElement("cache");
@@ -823,6 +833,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "memorysize", m_cacheMemSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetUInt(pElement, "persistentsize", m_cachePersistentSize);
+    XMLUtils::GetUInt(pElement, "parallelreads", m_cacheParallelReads, 1, 16);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -175,6 +175,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int  m_videoFpsDetect;
     float m_maxTempo;
     bool m_videoPreferStereoStream = false;
+    bool m_videoDemuxZeroCopy = false;
+    bool m_videoFilterThread = true;
 
     std::string m_videoDefaultPlayer;
     float m_videoPlayCountMinimumPercent;
@@ -290,6 +292,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_curlretries;
     bool m_curlDisableIPV6;
     bool m_curlDisableHTTP2;
+    unsigned int m_curlKeepAlivePerHost; // idle sessions and so connections kept alive per host
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -329,6 +332,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_cacheMemSize;
     unsigned int m_cacheBufferMode;
     float m_cacheReadFactor;
+    unsigned int m_cachePersistentSize; // MB on disk for network streams kept between sessions, 0 disables
+    unsigned int m_cacheParallelReads; // concurrent range requests filling the cache of internet streams, 1 disables
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
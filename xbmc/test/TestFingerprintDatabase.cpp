@@ -0,0 +1,63 @@
+/*
+ *  Copyright (C) 2020 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "FingerprintDatabase.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+CFileItemPtr MakeFile(const std::string& path, int64_t size, int minute)
+{
+  CFileItemPtr item(new CFileItem(path, false));
+  item->m_dwSize = size;
+  item->m_dateTime.SetDateTime(2020, 1, 1, 12, minute, 0);
+  return item;
+}
+} // namespace
+
+TEST(TestFingerprintDatabase, GetFingerprint)
+{
+  const std::string fingerprint = CFingerprintDatabase::GetFingerprint(*MakeFile("/music/a.flac", 1000, 0));
+  EXPECT_FALSE(fingerprint.empty());
+  EXPECT_NE(fingerprint, CFingerprintDatabase::GetFingerprint(*MakeFile("/music/a.flac", 1001, 0)));
+  EXPECT_NE(fingerprint, CFingerprintDatabase::GetFingerprint(*MakeFile("/music/a.flac", 1000, 1)));
+
+  // listings without size or date can't tell whether a file changed
+  CFileItem noDate("/music/a.flac", false);
+  noDate.m_dwSize = 1000;
+  EXPECT_TRUE(CFingerprintDatabase::GetFingerprint(noDate).empty());
+  EXPECT_TRUE(CFingerprintDatabase::GetFingerprint(*MakeFile("/music/a.flac", 0, 0)).empty());
+}
+
+TEST(TestFingerprintDatabase, GetChangedFiles)
+{
+  CFileItemList items;
+  items.SetPath("/music/");
+  items.Add(MakeFile("/music/same.flac", 1000, 0));
+  items.Add(MakeFile("/music/modified.flac", 1000, 1));
+  items.Add(MakeFile("/music/new.flac", 1000, 0));
+  items.Add(CFileItemPtr(new CFileItem("/music/folder/", true)));
+
+  CFingerprintDatabase::Fingerprints fingerprints;
+  fingerprints["/music/same.flac"] = CFingerprintDatabase::GetFingerprint(*items[0]);
+  fingerprints["/music/modified.flac"] = CFingerprintDatabase::GetFingerprint(*MakeFile("/music/modified.flac", 1000, 0));
+  fingerprints["/music/removed.flac"] = CFingerprintDatabase::GetFingerprint(*items[0]);
+
+  CFileItemList changed, unchanged;
+  CFingerprintDatabase::GetChangedFiles(items, fingerprints, changed, unchanged);
+  ASSERT_EQ(1, unchanged.Size());
+  EXPECT_EQ("/music/same.flac", unchanged[0]->GetPath());
+  ASSERT_EQ(2, changed.Size());
+  EXPECT_EQ("/music/modified.flac", changed[0]->GetPath());
+  EXPECT_EQ("/music/new.flac", changed[1]->GetPath());
+  EXPECT_EQ("/music/", changed.GetPath());
+}